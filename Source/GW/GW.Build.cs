@@ -15,10 +15,13 @@ public class GW : ModuleRules
 			"InputCore",
 			"EnhancedInput",
 			"AIModule",
+			"NavigationSystem",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
+			"AnimationBudgetAllocator",
 			"UMG",
 			"Slate",
+			"SlateCore",
 			"Niagara"
 		});
 
@@ -5,4 +5,6 @@
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GW, "GW" );
 
-DEFINE_LOG_CATEGORY(LogGW)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogGW)
+
+CSV_DEFINE_CATEGORY(GW, true);
\ No newline at end of file
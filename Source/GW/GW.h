@@ -3,6 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogGW, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogGW, Log, All);
+
+/** Stat group for gameplay systems across the project. View with "stat GW" */
+DECLARE_STATS_GROUP(TEXT("GW"), STATGROUP_GW, STATCAT_Advanced);
+
+/** CSV profiler category for per-subsystem times, captured by the soak benchmark */
+CSV_DECLARE_CATEGORY_EXTERN(GW);
\ No newline at end of file
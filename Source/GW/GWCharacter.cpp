@@ -12,14 +12,23 @@
 #include "InputActionValue.h"
 #include "GW.h"
 #include "Gameplay/Components/HealthComponent.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
+#include "Gameplay/Subsystems/HealthUISubsystem.h"
 
-AGWCharacter::AGWCharacter()
+AGWCharacter::AGWCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
+	// No native tick work. Blueprints that implement Event Tick still tick
+	PrimaryActorTick.bCanEverTick = false;
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
 	// Create health component
 	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
+
+	// Create damage modifier component
+	DamageModifierComponent = CreateDefaultSubobject<UDamageModifierComponent>(TEXT("DamageModifierComponent"));
 		
 	// Don't rotate when the controller rotates. Let that just affect the camera.
 	bUseControllerRotationPitch = false;
@@ -76,6 +85,17 @@ void AGWCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompone
 	}
 }
 
+void AGWCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// health changes are coalesced by the component, and then by the health UI
+	if (HealthComponent)
+	{
+		HealthComponent->OnHealthChanged.AddDynamic(this, &AGWCharacter::HandleHealthChanged);
+	}
+}
+
 void AGWCharacter::Move(const FInputActionValue& Value)
 {
 	// input is a Vector2D
@@ -145,6 +165,17 @@ void AGWCharacter::UpdateHealthBar()
 	OnHealthChanged(HealthPercent);
 }
 
+void AGWCharacter::HandleHealthChanged(float CurrentHealth, float MaxHealth)
+{
+	// the bar itself is updated when the health UI flushes
+	UHealthUISubsystem::MarkDirty(this, this);
+}
+
+void AGWCharacter::FlushHealthUI()
+{
+	UpdateHealthBar();
+}
+
 UHealthComponent* AGWCharacter::GetHealthComponent() const
 {
 	return HealthComponent;
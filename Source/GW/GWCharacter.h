@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
+#include "Gameplay/Interfaces/HealthUIOwner.h"
 #include "GWCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
 class UInputAction;
 class UHealthComponent;
+class UDamageModifierComponent;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
@@ -20,7 +22,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
  *  Implements a controllable orbiting camera
  */
 UCLASS(abstract)
-class AGWCharacter : public ACharacter
+class AGWCharacter : public ACharacter, public IHealthUIOwner
 {
 	GENERATED_BODY()
 
@@ -36,6 +38,10 @@ protected:
 	/** Health component */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UHealthComponent* HealthComponent;
+
+	/** Damage modifier component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UDamageModifierComponent* DamageModifierComponent;
 	
 	/** Jump Input Action */
 	UPROPERTY(EditAnywhere, Category="Input")
@@ -56,13 +62,16 @@ protected:
 public:
 
 	/** Constructor */
-	AGWCharacter();	
+	AGWCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
 
 	/** Initialize input action bindings */
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	/** Listens for health changes */
+	virtual void BeginPlay() override;
+
 protected:
 
 	/** Called for movement input */
@@ -92,7 +101,11 @@ public:
 protected:
 
 	/** Updates the health bar - calls BlueprintImplementableEvent */
-	void UpdateHealthBar();
+	virtual void UpdateHealthBar();
+
+	/** Queues a health bar update after the health component reports a change */
+	UFUNCTION()
+	void HandleHealthChanged(float CurrentHealth, float MaxHealth);
 
 	/** Blueprint event to update health bar UI - Implement this in Blueprint */
 	UFUNCTION(BlueprintImplementableEvent, Category = "UI")
@@ -100,6 +113,13 @@ protected:
 
 public:
 
+	// ~begin IHealthUIOwner interface
+
+	/** Updates the health bar */
+	virtual void FlushHealthUI() override;
+
+	// ~end IHealthUIOwner interface
+
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 
@@ -108,5 +128,8 @@ public:
 
 	/** Returns HealthComponent subobject **/
 	class UHealthComponent* GetHealthComponent() const;
+
+	/** Returns DamageModifierComponent subobject **/
+	FORCEINLINE UDamageModifierComponent* GetDamageModifierComponent() const { return DamageModifierComponent; }
 };
 
@@ -8,6 +8,13 @@
 #include "Blueprint/UserWidget.h"
 #include "GW.h"
 #include "Widgets/Input/SVirtualJoystick.h"
+#include "Gameplay/Camera/GWPlayerCameraManager.h"
+
+AGWPlayerController::AGWPlayerController()
+{
+	// use the camera mode stack to place the camera
+	PlayerCameraManagerClass = AGWPlayerCameraManager::StaticClass();
+}
 
 void AGWPlayerController::BeginPlay()
 {
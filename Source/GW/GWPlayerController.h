@@ -35,6 +35,13 @@ protected:
 	/** Pointer to the mobile controls widget */
 	TObjectPtr<UUserWidget> MobileControlsWidget;
 
+public:
+
+	/** Constructor */
+	AGWPlayerController();
+
+protected:
+
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
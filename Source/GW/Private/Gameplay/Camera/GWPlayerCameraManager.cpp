@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Camera/GWPlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Gameplay/Components/HealthComponent.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "GWCharacter.h"
+#include "GW.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Modes"), STAT_GW_CameraModes, STATGROUP_GW);
+
+AGWPlayerCameraManager::AGWPlayerCameraManager()
+{
+	AimMode.ArmLength = 120.0f;
+	AimMode.SocketOffset = FVector(30.0f, 40.0f, 65.0f);
+	AimMode.BlendInTime = 0.12f;
+	AimMode.BlendOutTime = 0.2f;
+
+	CatchKickMode.ArmLength = 0.0f;
+	CatchKickMode.SocketOffset = FVector(-6.0f, -2.0f, -1.5f);
+	CatchKickMode.BlendInTime = 0.05f;
+	CatchKickMode.BlendOutTime = 0.2f;
+	CatchKickMode.Duration = 0.15f;
+	CatchKickMode.bAdditive = true;
+
+	DeathMode.ArmLength = 300.0f;
+	DeathMode.SocketOffset = FVector(0.0f, 0.0f, 100.0f);
+	DeathMode.BlendInTime = 1.0f;
+}
+
+void AGWPlayerCameraManager::UpdateCamera(float DeltaTime)
+{
+	// Place the boom first, so the view is taken from this frame's mode
+	EvaluateCameraModes(DeltaTime);
+
+	Super::UpdateCamera(DeltaTime);
+}
+
+void AGWPlayerCameraManager::SetCameraBoom(USpringArmComponent* InCameraBoom)
+{
+	CameraBoom = InCameraBoom;
+	bSnapToTarget = true;
+}
+
+void AGWPlayerCameraManager::PushCameraMode(EPlayerCameraMode Mode)
+{
+	if (Mode == EPlayerCameraMode::Idle)
+	{
+		return;
+	}
+
+	const FPlayerCameraModeSettings& Settings = GetModeSettings(Mode);
+	const float TimeRemaining = Settings.Duration > 0.0f ? Settings.Duration : -1.0f;
+
+	// Keep the stack sorted by priority
+	int32 InsertIndex = 0;
+
+	for (; InsertIndex < ModeStack.Num(); ++InsertIndex)
+	{
+		if (ModeStack[InsertIndex].Mode == Mode)
+		{
+			ModeStack[InsertIndex].TimeRemaining = TimeRemaining;
+			return;
+		}
+
+		if (ModeStack[InsertIndex].Mode > Mode)
+		{
+			break;
+		}
+	}
+
+	ModeStack.Insert({ Mode, TimeRemaining }, InsertIndex);
+
+	// Blend at the pace of whichever mode ends up on top, even if the new one went in below it
+	SmoothingTime = GetTopModeSettings().BlendInTime;
+}
+
+void AGWPlayerCameraManager::PopCameraMode(EPlayerCameraMode Mode)
+{
+	const int32 Index = ModeStack.IndexOfByPredicate([Mode](const FActiveCameraMode& Entry) { return Entry.Mode == Mode; });
+
+	if (Index != INDEX_NONE)
+	{
+		const bool bWasTop = Index == ModeStack.Num() - 1;
+		ModeStack.RemoveAt(Index, 1, EAllowShrinking::No);
+
+		// Popping the top blends out at its pace, popping under it keeps the top mode's pace
+		SmoothingTime = bWasTop ? GetModeSettings(Mode).BlendOutTime : GetTopModeSettings().BlendInTime;
+	}
+}
+
+void AGWPlayerCameraManager::ResetCameraModes()
+{
+	ModeStack.Reset();
+	bSnapToTarget = true;
+}
+
+bool AGWPlayerCameraManager::HasCameraMode(EPlayerCameraMode Mode) const
+{
+	return Mode == EPlayerCameraMode::Idle || ModeStack.ContainsByPredicate([Mode](const FActiveCameraMode& Entry) { return Entry.Mode == Mode; });
+}
+
+const FPlayerCameraModeSettings& AGWPlayerCameraManager::GetModeSettings(EPlayerCameraMode Mode) const
+{
+	switch (Mode)
+	{
+	case EPlayerCameraMode::Aim:
+		return AimMode;
+
+	case EPlayerCameraMode::CatchKick:
+		return CatchKickMode;
+
+	case EPlayerCameraMode::Death:
+		return DeathMode;
+
+	default:
+		return IdleMode;
+	}
+}
+
+const FPlayerCameraModeSettings& AGWPlayerCameraManager::GetTopModeSettings() const
+{
+	return ModeStack.IsEmpty() ? IdleMode : GetModeSettings(ModeStack.Last().Mode);
+}
+
+bool AGWPlayerCameraManager::IsPawnAlive() const
+{
+	const AGWCharacter* Character = PCOwner ? Cast<AGWCharacter>(PCOwner->GetPawn()) : nullptr;
+	const UHealthComponent* Health = Character ? Character->GetHealthComponent() : nullptr;
+	const UHealthStoreSubsystem* HealthStore = UHealthStoreSubsystem::Get(this);
+
+	return Health && HealthStore && HealthStore->IsAlive(Health->GetHealthHandle());
+}
+
+void AGWPlayerCameraManager::EvaluateCameraModes(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_CameraModes);
+
+	// The pawn can come back to life without being possessed again, which is the only other place the stack is reset
+	if (HasCameraMode(EPlayerCameraMode::Death) && IsPawnAlive())
+	{
+		PopCameraMode(EPlayerCameraMode::Death);
+	}
+
+	// Pop timed modes that ran out
+	for (int32 Index = ModeStack.Num() - 1; Index >= 0; --Index)
+	{
+		FActiveCameraMode& Entry = ModeStack[Index];
+
+		if (Entry.TimeRemaining >= 0.0f)
+		{
+			Entry.TimeRemaining -= DeltaTime;
+
+			if (Entry.TimeRemaining <= 0.0f)
+			{
+				PopCameraMode(Entry.Mode);
+			}
+		}
+	}
+
+	USpringArmComponent* Boom = CameraBoom.Get();
+
+	if (!Boom)
+	{
+		return;
+	}
+
+	// Fold the stack into one target, lowest priority first
+	float TargetArmLength = IdleMode.ArmLength;
+	FVector TargetSocketOffset = IdleMode.SocketOffset;
+
+	for (const FActiveCameraMode& Entry : ModeStack)
+	{
+		const FPlayerCameraModeSettings& Settings = GetModeSettings(Entry.Mode);
+
+		if (Settings.bAdditive)
+		{
+			TargetArmLength += Settings.ArmLength;
+			TargetSocketOffset += Settings.SocketOffset;
+		}
+		else
+		{
+			TargetArmLength = Settings.ArmLength;
+			TargetSocketOffset = Settings.SocketOffset;
+		}
+	}
+
+	if (bSnapToTarget)
+	{
+		bSnapToTarget = false;
+
+		ArmLength = TargetArmLength;
+		ArmLengthRate = 0.0f;
+		SocketOffset = TargetSocketOffset;
+		SocketOffsetRate = FVector::ZeroVector;
+	}
+	else
+	{
+		// The springs keep their velocity, so a mode change mid blend carries on smoothly
+		FMath::CriticallyDampedSmoothing(ArmLength, ArmLengthRate, TargetArmLength, 0.0f, DeltaTime, SmoothingTime);
+		FMath::CriticallyDampedSmoothing(SocketOffset, SocketOffsetRate, TargetSocketOffset, FVector::ZeroVector, DeltaTime, SmoothingTime);
+	}
+
+	// The only place the boom is written
+	Boom->TargetArmLength = ArmLength;
+	Boom->SocketOffset = SocketOffset;
+}
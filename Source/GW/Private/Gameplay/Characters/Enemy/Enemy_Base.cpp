@@ -1,43 +1,53 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Gameplay/Characters/Enemy/Enemy_Base.h"
-#include "Components/WidgetComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Gameplay/Components/HealthComponent.h"
-#include "Blueprint/UserWidget.h"
-#include "Gameplay/Objects/HealOrb.h"
+#include "Gameplay/Subsystems/OrbSimulationSubsystem.h"
+#include "Gameplay/Subsystems/RagdollBudgetSubsystem.h"
+#include "Gameplay/Subsystems/EnemyHealthBarSubsystem.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
 
 AEnemy_Base::AEnemy_Base()
 {
-	// Create the health bar widget component
-	HealthBarComponent = CreateDefaultSubobject<UWidgetComponent>(TEXT("HealthBarComponent"));
-	HealthBarComponent->SetupAttachment(RootComponent);
-	HealthBarComponent->SetWidgetSpace(EWidgetSpace::Screen);
-	HealthBarComponent->SetDrawAtDesiredSize(true); // 고정 크기 유지
-	HealthBarComponent->SetDrawSize(FVector2D(200.0f, 20.0f));
-	HealthBarComponent->SetRelativeLocation(FVector(0.0f, 0.0f, 100.0f)); // Above character
-	HealthBarComponent->SetPivot(FVector2D(0.5f, 0.5f)); // 중앙 기준
 }
 
 void AEnemy_Base::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Set the widget class if specified
-	if (HealthBarComponent && HealthWidgetClass)
+	// Add a health bar to the HUD overlay
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
 	{
-		HealthBarComponent->SetWidgetClass(HealthWidgetClass);
-		HealthBarComponent->InitWidget();
+		HealthBars->RegisterHealthBar(this, HealthBarHeight);
+	}
 
-		HealthWidget = HealthBarComponent->GetUserWidgetObject();
-		if (HealthWidget)
-		{
-			// Initialize health bar to full
-			UpdateHealthBar();
-		}
+	// Initialize health bar
+	UpdateHealthBar();
+}
+
+void AEnemy_Base::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->UnregisterHealthBar(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy_Base::UpdateHealthBar()
+{
+	Super::UpdateHealthBar();
+
+	if (!GetHealthComponent())
+		return;
+
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->SetHealthPercent(this, GetHealthComponent()->GetCurrentHealth() / GetHealthComponent()->GetMaxHealth());
 	}
 }
 
@@ -64,9 +74,6 @@ void AEnemy_Base::ApplyDamage(float Damage, AActor* DamageCauser, const FVector&
 			DamageLocation,
 			DamageImpulse
 		);
-
-		// Update health bar after taking damage (부모 클래스의 함수 호출)
-		UpdateHealthBar();
 	}
 }
 
@@ -74,10 +81,10 @@ void AEnemy_Base::HandleDeath()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Enemy HandleDeath called!"));
 
-	// Hide health bar on death
-	if (HealthBarComponent)
+	// Remove health bar on death
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
 	{
-		HealthBarComponent->SetVisibility(false);
+		HealthBars->UnregisterHealthBar(this);
 	}
 
 	// Disable movement
@@ -92,36 +99,28 @@ void AEnemy_Base::HandleDeath()
 		GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
 
-	// Enable ragdoll physics
+	// Enable ragdoll physics through the ragdoll budget
 	if (GetMesh())
 	{
-		GetMesh()->SetSimulatePhysics(true);
 		GetMesh()->SetCollisionProfileName(TEXT("Ragdoll"));
-	}
 
-	// Spawn heal orbs
-	if (HealOrbClass)
-	{
-		FVector SpawnLocation = GetActorLocation() + FVector(0.0f, 0.0f, 50.0f);
-
-		for (int32 i = 0; i < HealOrbCount; i++)
+		if (URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this))
 		{
-			// Random offset for spreading orbs
-			FVector RandomOffset = FVector(
-				FMath::RandRange(-100.0f, 100.0f),
-				FMath::RandRange(-100.0f, 100.0f),
-				FMath::RandRange(50.0f, 150.0f)
-			);
-
-			FVector FinalLocation = SpawnLocation + RandomOffset;
-
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-			GetWorld()->SpawnActor<AHealOrb>(HealOrbClass, FinalLocation, FRotator::ZeroRotator, SpawnParams);
+			RagdollBudget->RequestRagdoll(GetMesh());
+		}
+		else
+		{
+			GetMesh()->SetSimulatePhysics(true);
 		}
+	}
 
-		UE_LOG(LogTemp, Log, TEXT("Enemy spawned %d heal orbs"), HealOrbCount);
+	// Drop heal and rage orbs
+	if (UOrbSimulationSubsystem* Orbs = UOrbSimulationSubsystem::Get(this))
+	{
+		const FVector OrbOrigin = GetActorLocation() + FVector(0.0f, 0.0f, 50.0f);
+
+		Orbs->SpawnOrbBurst(EOrbKind::Heal, OrbOrigin, HealOrbCount, HealOrbAmount);
+		Orbs->SpawnOrbBurst(EOrbKind::Rage, OrbOrigin, RageOrbCount, RageOrbAmount);
 	}
 
 	// Set timer to destroy actor after delay
@@ -139,8 +138,5 @@ void AEnemy_Base::ApplyHealing(float Healing, AActor* Healer)
 	if (GetHealthComponent())
 	{
 		GetHealthComponent()->ApplyHealing(Healing, Healer);
-
-		// Update health bar after healing (부모 클래스의 함수 호출)
-		UpdateHealthBar();
 	}
 }
@@ -7,20 +7,21 @@
 #include "Blueprint/UserWidget.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/TimelineComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Gameplay/Weapons/Leviathan.h"
+#include "Gameplay/Camera/GWPlayerCameraManager.h"
 #include "Gameplay/Components/PlayerProgressionComponent.h"
 #include "Gameplay/Components/CombatComponent.h"
 #include "Gameplay/Components/HealthComponent.h"
+#include "Gameplay/Components/RageComponent.h"
+#include "Gameplay/Components/AsyncSpringArmComponent.h"
 #include "InputActionValue.h"
 #include "Kismet/GameplayStatics.h"
 
-APlayer_Base::APlayer_Base()
+APlayer_Base::APlayer_Base(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UAsyncSpringArmComponent>(TEXT("CameraBoom")))
 {
-	PrimaryActorTick.bCanEverTick = true;
-
 	// Configure character rotation
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationYaw = false;
@@ -52,12 +53,9 @@ APlayer_Base::APlayer_Base()
 	AxeCollision = CreateDefaultSubobject<UCapsuleComponent>(TEXT("Axe Capsule"));
 	AxeCollision->SetupAttachment(LeviathanAxe);
 
-	AimTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("AimTimeline"));
-	DesiredSocketTimeline = CreateDefaultSubobject<UTimelineComponent>(TEXT("DesiredSocketTimeline"));
-	RangedCameraTl = CreateDefaultSubobject<UTimelineComponent>(TEXT("RangedCameraTl"));
-
 	ProgressionComponent = CreateDefaultSubobject<UPlayerProgressionComponent>(TEXT("ProgressionComponent"));
 	CombatComponent = CreateDefaultSubobject<UCombatComponent>(TEXT("PlayerCombatComp"));
+	RageComponent = CreateDefaultSubobject<URageComponent>(TEXT("RageComponent"));
 }
 
 void APlayer_Base::BeginPlay()
@@ -72,34 +70,21 @@ void APlayer_Base::BeginPlay()
 	GetMesh()->HideBoneByName(FName("hips_cloth_main_l"), EPhysBodyOp::PBO_None);
 	GetMesh()->HideBoneByName(FName("hips_cloth_main_r"), EPhysBodyOp::PBO_None);
 	
-	if (DesiredSocketTimeline && DesireSocketCurve)
-	{
-		FOnTimelineFloat TimelineProgress;
-		TimelineProgress.BindUFunction(this, FName("UpdateDesireSocket"));
-		DesiredSocketTimeline->AddInterpFloat(DesireSocketCurve, TimelineProgress);
-	}
-
 	if (ALeviathan* Axe = Cast<ALeviathan>(LeviathanAxe->GetChildActor()))
 	{
 		LeviathanRef = Axe;
 	}
 
+	// One binding per delegate. Notifies are routed by name from the table
+	RegisterMontageNotify(FName("Throw"), &APlayer_Base::OnThrowNotifyBegin, &APlayer_Base::OnThrowNotifyEnd);
+	RegisterMontageNotify(FName("Catch"), &APlayer_Base::OnCatchNotifyBegin, &APlayer_Base::OnCatchNotifyEnd);
+
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
-		AnimInstance->OnPlayMontageNotifyBegin.AddDynamic(this, &APlayer_Base::OnThrowNotifyBegin);
-		AnimInstance->OnPlayMontageNotifyEnd.AddDynamic(this, &APlayer_Base::OnThrowNotifyEnd);
-		AnimInstance->OnPlayMontageNotifyBegin.AddDynamic(this, &APlayer_Base::OnCatchNotifyBegin);
-		AnimInstance->OnPlayMontageNotifyEnd.AddDynamic(this, &APlayer_Base::OnCatchNotifyEnd);
+		AnimInstance->OnPlayMontageNotifyBegin.AddDynamic(this, &APlayer_Base::DispatchMontageNotifyBegin);
+		AnimInstance->OnPlayMontageNotifyEnd.AddDynamic(this, &APlayer_Base::DispatchMontageNotifyEnd);
 	}
 	
-	// Initialize camera to default idle position
-	if (CameraBoom)
-	{
-		CameraBoom->TargetArmLength = SpringArmLengthIdle;
-		CameraBoom->SocketOffset = CameraVector;
-		DesiredSocketOffset = CameraVector;
-	}
-
 	// Create AimHUD widget instance
 	if (AimHUD_Class)
 	{
@@ -109,49 +94,43 @@ void APlayer_Base::BeginPlay()
 		}
 	}
 
-	// Bind RangedCameraTimeline to LerpCameraPosition
-	if (RangedCameraTl && RangedCameraCurve)
-	{
-		FOnTimelineFloat TimelineProgress;
-		TimelineProgress.BindUFunction(this, FName("LerpCameraPosition"));
-		RangedCameraTl->AddInterpFloat(RangedCameraCurve, TimelineProgress);
-	}
-
 	if (HealthComponent)
 	{
 		UpdateHealthBar();
 	}
 }
 
-void APlayer_Base::Tick(float DeltaTime)
+void APlayer_Base::NotifyControllerChanged()
 {
-	Super::Tick(DeltaTime);
-
-}
+	Super::NotifyControllerChanged();
 
-void APlayer_Base::LerpCameraPosition(float Value)
-{
-	if (!CameraBoom)
-		return;
-	CameraBoom->TargetArmLength = FMath::Lerp(SpringArmLengthIdle, SpringArmLengthAim, Value);
-	CameraBoom->SocketOffset = FMath::Lerp(CameraVector, RangedCameraVector, Value);
-	DesiredSocketOffset = FMath::Lerp(CameraVector, RangedCameraVector, Value);
+	// The camera manager places the boom from here on
+	if (AGWPlayerCameraManager* CameraModeManager = GetCameraModeManager())
+	{
+		CameraModeManager->ResetCameraModes();
+		CameraModeManager->SetCameraBoom(CameraBoom);
+	}
 }
 
-void APlayer_Base::UpdateAim(float Value)
+AGWPlayerCameraManager* APlayer_Base::GetCameraModeManager() const
 {
+	const APlayerController* PC = Cast<APlayerController>(GetController());
+	return PC ? Cast<AGWPlayerCameraManager>(PC->PlayerCameraManager) : nullptr;
 }
 
-void APlayer_Base::UpdateDesireSocket(float Value)
+void APlayer_Base::SetCameraMode(EPlayerCameraMode Mode, bool bActive) const
 {
-	float NewOffsetX = Value * 0.5f * 12.f;
-	float NewOffsetY = Value * 0.5f * 4.f;
-	float NewOffsetZ = Value * 0.5f * 3.f;
-	CameraBoom->SocketOffset = FVector(
-		DesiredSocketOffset.X - NewOffsetX,
-		DesiredSocketOffset.Y - NewOffsetY,
-		DesiredSocketOffset.Z - NewOffsetZ
-	);
+	if (AGWPlayerCameraManager* CameraModeManager = GetCameraModeManager())
+	{
+		if (bActive)
+		{
+			CameraModeManager->PushCameraMode(Mode);
+		}
+		else
+		{
+			CameraModeManager->PopCameraMode(Mode);
+		}
+	}
 }
 
 void APlayer_Base::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
@@ -186,6 +165,41 @@ void APlayer_Base::PerformAttack()
 	}
 }
 
+void APlayer_Base::ScriptedMeleeAttack()
+{
+	if (!bIsAim && CombatComponent)
+	{
+		CombatComponent->PerformAttack();
+	}
+}
+
+void APlayer_Base::ScriptedSetAiming(bool bAiming)
+{
+	if (bAiming == bIsAim)
+	{
+		return;
+	}
+
+	if (bAiming)
+	{
+		AimPressed();
+	}
+	else
+	{
+		AimReleased();
+	}
+}
+
+void APlayer_Base::ScriptedThrowAxe()
+{
+	ThrowAxe();
+}
+
+void APlayer_Base::ScriptedRecallAxe()
+{
+	ReturnAxe();
+}
+
 void APlayer_Base::AimPressed()
 {
 	bIsAim = true;
@@ -199,11 +213,7 @@ void APlayer_Base::AimPressed()
 	CameraTurnRate = 30.f;
 	GetCharacterMovement()->MaxWalkSpeed = 250.f;
 
-	if (RangedCameraTl)
-	{
-		RangedCameraTl->SetPlayRate(1.4f);
-		RangedCameraTl->PlayFromStart();
-	}
+	SetCameraMode(EPlayerCameraMode::Aim, true);
 }
 
 void APlayer_Base::AimReleased()
@@ -219,11 +229,7 @@ void APlayer_Base::AimReleased()
 	CameraTurnRate = 50.f;
 	GetCharacterMovement()->MaxWalkSpeed = 500.f;
 
-	if (RangedCameraTl)
-	{
-		RangedCameraTl->SetPlayRate(0.9f);
-		RangedCameraTl->Reverse();
-	}
+	SetCameraMode(EPlayerCameraMode::Aim, false);
 }
 
 void APlayer_Base::ThrowAxe()
@@ -281,23 +287,46 @@ void APlayer_Base::Catch()
 
 	LeviathanRef->SetAxeState(0);
 
-	if (!AimTimeline->IsPlaying())
+	if (APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0))
 	{
-		if (APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0))
+		if (ShakeClass)
 		{
-			if (CameraManager && ShakeClass)
-			{
-				CameraManager->StartCameraShake(ShakeClass);
-				DesiredSocketTimeline->SetPlayRate(0.7f);
-				DesiredSocketTimeline->PlayFromStart();
-			}
+			CameraManager->StartCameraShake(ShakeClass);
+			SetCameraMode(EPlayerCameraMode::CatchKick, true);
 		}
 	}
 }
 
-void APlayer_Base::OnThrowNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload)
+void APlayer_Base::RegisterMontageNotify(FName NotifyName, FMontageNotifyHandler Begin, FMontageNotifyHandler End)
 {
-	if (NotifyName != FName("Throw") || !ThrowEffortSound)
+	FMontageNotifyHandlers& Handlers = MontageNotifyHandlers.FindOrAdd(NotifyName);
+	Handlers.Begin = Begin;
+	Handlers.End = End;
+}
+
+void APlayer_Base::DispatchMontageNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
+{
+	const FMontageNotifyHandlers* Handlers = MontageNotifyHandlers.Find(NotifyName);
+
+	if (Handlers && Handlers->Begin)
+	{
+		(this->*Handlers->Begin)(BranchingPointPayload);
+	}
+}
+
+void APlayer_Base::DispatchMontageNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
+{
+	const FMontageNotifyHandlers* Handlers = MontageNotifyHandlers.Find(NotifyName);
+
+	if (Handlers && Handlers->End)
+	{
+		(this->*Handlers->End)(BranchingPointPayload);
+	}
+}
+
+void APlayer_Base::OnThrowNotifyBegin(const FBranchingPointNotifyPayload& BranchingPointPayload)
+{
+	if (!ThrowEffortSound)
 		return;
 
 	UGameplayStatics::SpawnSoundAttached(
@@ -306,11 +335,8 @@ void APlayer_Base::OnThrowNotifyBegin(FName NotifyName, const FBranchingPointNot
 	);
 }
 
-void APlayer_Base::OnThrowNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload)
+void APlayer_Base::OnThrowNotifyEnd(const FBranchingPointNotifyPayload& BranchingPointPayload)
 {
-	if (NotifyName != FName("Throw"))
-		return;
-
 	LeviathanRef->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 
 	FRotator CameraRotation = FollowCamera->GetComponentRotation();
@@ -320,20 +346,16 @@ void APlayer_Base::OnThrowNotifyEnd(FName NotifyName, const FBranchingPointNotif
 	LeviathanRef->Throw(CameraRotation, ThrowDirectionVector, CameraLocation);
 }
 
-void APlayer_Base::OnCatchNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
+void APlayer_Base::OnCatchNotifyBegin(const FBranchingPointNotifyPayload& BranchingPointPayload)
 {
-	if (NotifyName != FName("Catch"))
-		return;
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
 		AnimInstance->Montage_SetPlayRate(AnimInstance->GetCurrentActiveMontage(), 0.4f);
 	}
 }
 
-void APlayer_Base::OnCatchNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
+void APlayer_Base::OnCatchNotifyEnd(const FBranchingPointNotifyPayload& BranchingPointPayload)
 {
-	if (NotifyName != FName("Catch"))
-		return;
 	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
 	{
 		AnimInstance->Montage_SetPlayRate(AnimInstance->GetCurrentActiveMontage(), 1.f);
@@ -389,6 +411,7 @@ void APlayer_Base::HandleDeath()
 	{
 		HealthComponent->Death();
 	}
+	SetCameraMode(EPlayerCameraMode::Death, true);
 	UE_LOG(LogTemp, Warning, TEXT("Player died!"));
 }
 
@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Components/AsyncSpringArmComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Probes"), STAT_GW_CameraProbes, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Probe Cache Hits"), STAT_GW_CameraProbeCacheHits, STATGROUP_GW);
+
+void UAsyncSpringArmComponent::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+	if (!bAsyncCollisionProbe || !bDoTrace || TargetArmLength == 0.0f)
+	{
+		// Start from a free arm if the async probe is turned back on
+		ProbeHandle = FTraceHandle();
+		HitDistance = UE_BIG_NUMBER;
+		PreviousHitDistance = UE_BIG_NUMBER;
+		ArmFraction = 1.0f;
+		ArmFractionRate = 0.0f;
+		bStaticHit = false;
+
+		Super::UpdateDesiredArmLocation(bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime);
+		return;
+	}
+
+	// Place the arm without the blocking probe, then pull it in ourselves
+	Super::UpdateDesiredArmLocation(false, bDoLocationLag, bDoRotationLag, DeltaTime);
+
+	const FTransform& ComponentTM = GetComponentTransform();
+	const FVector Origin = PreviousArmOrigin;
+	const FVector DesiredLocation = ComponentTM.TransformPosition(RelativeSocketLocation);
+	const float ArmDistance = FVector::Dist(Origin, DesiredLocation);
+
+	HitAge += DeltaTime;
+
+	if (!ConsumeProbeResult())
+	{
+		// Nothing new came in, so there's nothing to extrapolate from
+		PreviousHitDistance = HitDistance;
+	}
+
+	// The result is a frame old. If the geometry is closing in, assume it keeps doing so
+	float PredictedDistance = HitDistance;
+
+	if (HitDistance < UE_BIG_NUMBER && PreviousHitDistance < UE_BIG_NUMBER)
+	{
+		PredictedDistance = FMath::Min(HitDistance, HitDistance + (HitDistance - PreviousHitDistance) * PredictionFrames);
+	}
+
+	const float TargetFraction = ArmDistance > UE_KINDA_SMALL_NUMBER ? FMath::Clamp(PredictedDistance / ArmDistance, 0.0f, 1.0f) : 1.0f;
+
+	// Pull in fast so we don't clip, ease out slowly so we don't pop
+	const float SmoothingTime = TargetFraction < ArmFraction ? PullInTime : PushOutTime;
+
+	if (SmoothingTime <= 0.0f)
+	{
+		ArmFraction = TargetFraction;
+		ArmFractionRate = 0.0f;
+	}
+	else
+	{
+		FMath::CriticallyDampedSmoothing(ArmFraction, ArmFractionRate, TargetFraction, 0.0f, DeltaTime, SmoothingTime);
+		ArmFraction = FMath::Clamp(ArmFraction, 0.0f, 1.0f);
+	}
+
+	UnfixedCameraPosition = DesiredLocation;
+	bIsCameraFixed = ArmFraction < 1.0f;
+
+	if (bIsCameraFixed)
+	{
+		const FVector ResultLocation = Origin + (DesiredLocation - Origin) * ArmFraction;
+		RelativeSocketLocation = ComponentTM.InverseTransformPosition(ResultLocation);
+		UpdateChildTransforms();
+	}
+
+	IssueProbe(Origin, DesiredLocation);
+}
+
+bool UAsyncSpringArmComponent::ConsumeProbeResult()
+{
+	if (!ProbeHandle.IsValid())
+	{
+		return false;
+	}
+
+	FTraceDatum Datum;
+	const bool bReady = GetWorld()->QueryTraceData(ProbeHandle, Datum);
+
+	// Results only live for a frame, so a probe that isn't ready now never will be
+	ProbeHandle = FTraceHandle();
+
+	if (!bReady)
+	{
+		return false;
+	}
+
+	ProbeOrigin = Datum.Start;
+	ProbeEnd = Datum.End;
+	PreviousHitDistance = HitDistance;
+	HitAge = 0.0f;
+
+	const FHitResult* Hit = Datum.OutHits.FindByPredicate([](const FHitResult& Result) { return Result.bBlockingHit; });
+
+	if (Hit)
+	{
+		const UPrimitiveComponent* HitComponent = Hit->GetComponent();
+
+		HitDistance = Hit->Time * FVector::Dist(Datum.Start, Datum.End);
+		bStaticHit = HitComponent && HitComponent->Mobility == EComponentMobility::Static;
+	}
+	else
+	{
+		HitDistance = UE_BIG_NUMBER;
+		bStaticHit = false;
+	}
+
+	return true;
+}
+
+void UAsyncSpringArmComponent::IssueProbe(const FVector& Origin, const FVector& DesiredLocation)
+{
+	if (CanReuseStaticHit(Origin, DesiredLocation))
+	{
+		INC_DWORD_STAT(STAT_GW_CameraProbeCacheHits);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GW_CameraProbes);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AsyncSpringArm), false, GetOwner());
+
+	ProbeHandle = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Origin, DesiredLocation, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(ProbeSize), QueryParams);
+}
+
+bool UAsyncSpringArmComponent::CanReuseStaticHit(const FVector& Origin, const FVector& DesiredLocation) const
+{
+	if (!bStaticHit || HitAge >= MaxStaticHitAge)
+	{
+		return false;
+	}
+
+	const float StillToleranceSquared = FMath::Square(StillTolerance);
+
+	return FVector::DistSquared(Origin, ProbeOrigin) <= StillToleranceSquared
+		&& FVector::DistSquared(DesiredLocation, ProbeEnd) <= StillToleranceSquared;
+}
@@ -2,6 +2,8 @@
 
 #include "Gameplay/Components/CombatComponent.h"
 #include "Gameplay/Components/PlayerProgressionComponent.h"
+#include "Gameplay/Components/RageComponent.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
 #include "Gameplay/Weapons/Leviathan.h"
 #include "Animation/AnimInstance.h"
 #include "GameFramework/Character.h"
@@ -48,6 +50,9 @@ void UCombatComponent::BeginPlay()
 		return;
 	}
 
+	RageComp = OwnerChar->GetRageComponent();
+	DamageModifierComp = OwnerChar->GetDamageModifierComponent();
+
 	ProgressionComp = OwnerChar->FindComponentByClass<UPlayerProgressionComponent>();
 	if (!ProgressionComp)
 	{
@@ -92,9 +97,12 @@ void UCombatComponent::PerformAttack()
 		return;
 	}
 
+	// Rage mode speeds up the combo
+	const float PlayRate = RageComp ? RageComp->GetComboPlayRate() : 1.f;
+
 	const float MontageLength = AnimInstance->Montage_Play(
 		TargetMontage,
-		1.f,
+		PlayRate,
 		EMontagePlayReturnType::MontageLength,
 		0.f,
 		true
@@ -235,6 +243,7 @@ void UCombatComponent::PerformAttackTrace(FName DamageSourceBone)
 	if (bHit)
 	{
 		TSet<AActor*> HitActors;  // 중복 방지
+		int32 NumDamaged = 0;
 
 		for (const FHitResult& Hit : HitResults)
 		{
@@ -255,6 +264,12 @@ void UCombatComponent::PerformAttackTrace(FName DamageSourceBone)
 					FinalDamage *= (1.f + (ChargeMultiplier - 1.f) * ChargeRatio);
 				}
 
+				// Buffs, rage and passive skills
+				if (DamageModifierComp)
+				{
+					FinalDamage = DamageModifierComp->ModifyOutgoingDamage(FinalDamage);
+				}
+
 				// 넉백 임펄스 계산
 				FVector ImpulseDirection = (Hit.ImpactPoint - Origin).GetSafeNormal();
 				FVector Impulse = (Hit.ImpactNormal * -MeleeKnockbackImpulse) + (FVector::UpVector * MeleeLaunchImpulse);
@@ -264,6 +279,7 @@ void UCombatComponent::PerformAttackTrace(FName DamageSourceBone)
 				if (DamageableActor)
 				{
 					DamageableActor->ApplyDamage(FinalDamage, OwnerChar, Hit.ImpactPoint, Impulse);
+					++NumDamaged;
 				}
 
 				UE_LOG(LogTemp, Log, TEXT("Hit %s for %.1f damage (Charged: %s)"),
@@ -271,6 +287,12 @@ void UCombatComponent::PerformAttackTrace(FName DamageSourceBone)
 			}
 		}
 
+		// Hits build up rage
+		if (RageComp)
+		{
+			RageComp->AddRageForHits(NumDamaged);
+		}
+
 		// 차징 해제
 		bIsCharging = false;
 		ChargeTime = 0.f;
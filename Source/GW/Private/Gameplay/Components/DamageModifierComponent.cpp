@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Components/DamageModifierComponent.h"
+
+UDamageModifierComponent::UDamageModifierComponent()
+{
+	// Modifiers only change on events
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDamageModifierComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CompileModifiers();
+}
+
+void UDamageModifierComponent::AddModifierSource(FName SourceID, const TArray<FDamageModifier>& Modifiers)
+{
+	SourceModifiers.Add(SourceID, Modifiers);
+	CompileModifiers();
+}
+
+void UDamageModifierComponent::RemoveModifierSource(FName SourceID)
+{
+	if (SourceModifiers.Remove(SourceID) > 0)
+	{
+		CompileModifiers();
+	}
+}
+
+void UDamageModifierComponent::CompileModifiers()
+{
+	// Gather every modifier, sorted by stage
+	TArray<FDamageModifier, TInlineAllocator<16>> AllModifiers;
+	AllModifiers.Append(BaseModifiers);
+
+	for (const TPair<FName, TArray<FDamageModifier>>& Source : SourceModifiers)
+	{
+		AllModifiers.Append(Source.Value);
+	}
+
+	AllModifiers.StableSort([](const FDamageModifier& A, const FDamageModifier& B) { return A.Stage < B.Stage; });
+
+	// Fold each stage into a single term per scope
+	OutgoingTerms.Reset();
+	IncomingTerms.Reset();
+
+	int32 OutgoingStage = INDEX_NONE;
+	int32 IncomingStage = INDEX_NONE;
+
+	for (const FDamageModifier& Modifier : AllModifiers)
+	{
+		const bool bOutgoing = Modifier.Scope == EDamageModifierScope::Outgoing;
+		TArray<FDamageTerm>& Terms = bOutgoing ? OutgoingTerms : IncomingTerms;
+		int32& LastStage = bOutgoing ? OutgoingStage : IncomingStage;
+
+		if (Terms.Num() == 0 || LastStage != Modifier.Stage)
+		{
+			Terms.AddDefaulted();
+			LastStage = Modifier.Stage;
+		}
+
+		FDamageTerm& Term = Terms.Last();
+
+		if (Modifier.Op == EDamageModifierOp::Add)
+		{
+			Term.Add += Modifier.Value;
+		}
+		else
+		{
+			Term.Multiply *= Modifier.Value;
+		}
+	}
+}
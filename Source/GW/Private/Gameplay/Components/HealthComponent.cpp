@@ -2,18 +2,21 @@
 
 #include "Gameplay/Components/HealthComponent.h"
 #include "GWCharacter.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
 #include "Engine/DamageEvents.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Variant_Combat/Interfaces/CombatDamageable.h"
+#include "Gameplay/Subsystems/RagdollBudgetSubsystem.h"
+#include "Gameplay/Subsystems/HealthRegenSubsystem.h"
+#include "TimerManager.h"
 
 // Sets default values for this component's properties
 UHealthComponent::UHealthComponent()
 {
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Health is event driven, and regeneration runs on the world's scheduler, so the component never ticks
+	PrimaryComponentTick.bCanEverTick = false;
 
-	// ...
+	CurrentHealth = MaxHealth;
 }
 
 
@@ -26,7 +29,41 @@ void UHealthComponent::BeginPlay()
 	OwnerRef = Cast<AGWCharacter>(GetOwner());
 	if (!OwnerRef)
 		UE_LOG(LogTemp, Warning, TEXT("OwnerRef is Not Founded!"));
+	else
+		DamageModifiers = OwnerRef->GetDamageModifierComponent();
+
+	// Our health lives in the world's health store
 	CurrentHealth = MaxHealth;
+	HealthStore = UHealthStoreSubsystem::Get(this);
+	if (HealthStore)
+		HealthHandle = HealthStore->Register(GetOwner(), MaxHealth);
+
+	if (PassiveRegenRate > 0.f)
+		StartRegeneration(PassiveRegenRate, 0.f);
+}
+
+void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UHealthRegenSubsystem* Regen = UHealthRegenSubsystem::Get(this))
+		Regen->RemoveEffects(HealthHandle);
+
+	if (HealthStore)
+		HealthStore->Unregister(HealthHandle);
+
+	if (UWorld* World = GetWorld())
+		World->GetTimerManager().ClearAllTimersForObject(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float UHealthComponent::GetMaxHealth() const
+{
+	return HealthStore ? HealthStore->GetMaxHealth(HealthHandle) : MaxHealth;
+}
+
+float UHealthComponent::GetCurrentHealth() const
+{
+	return HealthStore ? HealthStore->GetHealth(HealthHandle) : CurrentHealth;
 }
 
 float UHealthComponent::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator,
@@ -38,16 +75,34 @@ float UHealthComponent::TakeDamage(float Damage, struct FDamageEvent const& Dama
 		return Damage;
 	}
 	// only process damage if the character is still alive
-	if (CurrentHealth <= 0.0f)
+	if (HealthStore ? !HealthStore->IsAlive(HealthHandle) : CurrentHealth <= 0.f)
 	{
 		return 0.0f;
 	}
 
+	// apply our resistances
+	if (DamageModifiers)
+	{
+		Damage = DamageModifiers->ModifyIncomingDamage(Damage);
+	}
+
 	// reduce the current HP
-	CurrentHealth -= Damage;
+	bool bKilled = false;
+
+	if (HealthStore)
+	{
+		HealthStore->ApplyDamage(HealthHandle, Damage, bKilled);
+	}
+	else if (Damage > 0.f)
+	{
+		CurrentHealth = FMath::Max(CurrentHealth - Damage, 0.f);
+		bKilled = CurrentHealth <= 0.f;
+	}
+
+	MarkHealthChanged();
 
 	// have we run out of HP?
-	if (CurrentHealth <= 0.0f)
+	if (bKilled)
 	{
 		// die
 		Death();
@@ -56,24 +111,21 @@ float UHealthComponent::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	{
 		// TODO: update the life bar
 
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		OwnerRef->GetMesh()->SetPhysicsBlendWeight(0.5f);
-		OwnerRef->GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		// enable partial ragdoll physics, but keep the pelvis vertical.
+		// Skip it if there are already too many ragdolls simulating
+		const URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this);
+
+		if (!RagdollBudget || RagdollBudget->CanAffordHitReaction())
+		{
+			OwnerRef->GetMesh()->SetPhysicsBlendWeight(0.5f);
+			OwnerRef->GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		}
 	}
 
 	// return the received damage amount
 	return Damage;
 }
 
-
-// Called every frame
-void UHealthComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	// ...
-}
-
 void UHealthComponent::ApplayDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation,
 	const FVector& DamageImpulse)
 {
@@ -123,8 +175,15 @@ void UHealthComponent::Death()
 		// disable movement while we're dead
 		OwnerRef->GetCharacterMovement()->DisableMovement();
 
-		// enable full ragdoll physics
-		OwnerRef->GetMesh()->SetSimulatePhysics(true);
+		// enable full ragdoll physics through the ragdoll budget
+		if (URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this))
+		{
+			RagdollBudget->RequestRagdoll(OwnerRef->GetMesh());
+		}
+		else
+		{
+			OwnerRef->GetMesh()->SetSimulatePhysics(true);
+		}
 	}
 }
 
@@ -135,5 +194,68 @@ void UHealthComponent::ApplyHealing(float HealAmount, AActor* Healer)
 		UE_LOG(LogTemp, Warning, TEXT("OwnerRef is Not Founded!"));
 		return;
 	}
+
+	// Healing doesn't revive, and there's nothing to tell anyone if we were already full
+	float Healed = 0.f;
+
+	if (HealthStore)
+	{
+		Healed = HealthStore->ApplyHealing(HealthHandle, HealAmount);
+	}
+	else if (CurrentHealth > 0.f && HealAmount > 0.f)
+	{
+		Healed = FMath::Min(HealAmount, MaxHealth - CurrentHealth);
+		CurrentHealth += Healed;
+	}
+
+	if (Healed > 0.f)
+	{
+		MarkHealthChanged();
+	}
+}
+
+void UHealthComponent::StartRegeneration(float HealthPerSecond, float Duration)
+{
+	if (UHealthRegenSubsystem* Regen = UHealthRegenSubsystem::Get(this))
+	{
+		Regen->AddRegeneration(HealthHandle, HealthPerSecond, Duration, this);
+	}
+}
+
+void UHealthComponent::ApplyDamageOverTime(float DamagePerSecond, float Duration)
+{
+	if (UHealthRegenSubsystem* Regen = UHealthRegenSubsystem::Get(this))
+	{
+		Regen->AddDamageOverTime(HealthHandle, DamagePerSecond, Duration, this);
+	}
+}
+
+void UHealthComponent::HandleHealthOverTime(bool bKilled)
+{
+	MarkHealthChanged();
+
+	// Damage over time skips the hit reaction, but it can still kill
+	if (bKilled)
+	{
+		Death();
+	}
+}
+
+void UHealthComponent::MarkHealthChanged()
+{
+	if (bNotifyPending)
+	{
+		return;
+	}
+
+	bNotifyPending = true;
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UHealthComponent::BroadcastHealthChanged);
+}
+
+void UHealthComponent::BroadcastHealthChanged()
+{
+	bNotifyPending = false;
+
+	OnHealthChanged.Broadcast(GetCurrentHealth(), GetMaxHealth());
 }
 
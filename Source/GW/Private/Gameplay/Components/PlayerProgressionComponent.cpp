@@ -1,6 +1,31 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Gameplay/Components/PlayerProgressionComponent.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
+#include "Gameplay/Subsystems/ProgressionSaveSubsystem.h"
+#include "Misc/Crc.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	// 필요한 비트가 모두 켜져 있는지 워드 단위로 검사 (두 비트셋의 크기는 같아야 함)
+	bool ContainsAllBits(const TBitArray<>& Mask, const TBitArray<>& Required)
+	{
+		check(Mask.Num() == Required.Num());
+
+		const uint32* MaskWords = Mask.GetData();
+		const uint32* RequiredWords = Required.GetData();
+		const int32 NumWords = FBitSet::CalculateNumWords(Required.Num());
+
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			if (RequiredWords[WordIndex] & ~MaskWords[WordIndex])
+				return false;
+		}
+
+		return true;
+	}
+}
 
 UPlayerProgressionComponent::UPlayerProgressionComponent()
 {
@@ -12,33 +37,124 @@ void UPlayerProgressionComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	CompileSkills();
 	UnlockInitialSkills();
+
+	// 저장 파일은 시작할 때 백그라운드에서 읽힘 - 아직이면 끝날 때 적용
+	if (UProgressionSaveSubsystem* SaveSubsystem = UProgressionSaveSubsystem::Get(this))
+	{
+		if (SaveSubsystem->IsLoadComplete())
+		{
+			ApplySavedProgression();
+		}
+		else
+		{
+			SaveLoadedHandle = SaveSubsystem->OnLoadComplete.AddUObject(this, &UPlayerProgressionComponent::ApplySavedProgression);
+		}
+	}
+}
+
+void UPlayerProgressionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UProgressionSaveSubsystem* SaveSubsystem = UProgressionSaveSubsystem::Get(this))
+	{
+		SaveSubsystem->OnLoadComplete.Remove(SaveLoadedHandle);
+	}
+
+	SaveProgression();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPlayerProgressionComponent::CompileSkills()
+{
+	Skills.Reset();
+	SkillIndices.Reset();
+	PrerequisiteMasks.Reset();
+	SkillTableHash = 0;
+
+	SkillIndicesByType.Reset();
+	SkillIndicesByType.SetNum(StaticEnum<ESkillType>()->GetMaxEnumValue());
+	SkillIndicesByWeaponState.Reset();
+	SkillIndicesByWeaponState.SetNum(StaticEnum<EWeaponState>()->GetMaxEnumValue());
+
+	if (!SkillDataTable)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SkillDataTable is not assigned in PlayerProgressionComponent!"));
+		UnlockedMask.Init(false, 0);
+		return;
+	}
+
+	// 테이블 행을 한 번만 복사해서 연속 배열로
+	SkillDataTable->ForeachRow<FSkillData>(TEXT("CompileSkills"), [this](const FName& RowName, const FSkillData& SkillData)
+	{
+		if (SkillIndices.Contains(SkillData.SkillID))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Duplicate SkillID in DataTable: %s"), *SkillData.SkillID.ToString());
+			return;
+		}
+
+		const int32 SkillIndex = Skills.Add(SkillData);
+		SkillIndices.Add(SkillData.SkillID, SkillIndex);
+		SkillTableHash = FCrc::StrCrc32(*SkillData.SkillID.ToString(), SkillTableHash);
+		SkillIndicesByType[static_cast<int32>(SkillData.SkillType)].Add(SkillIndex);
+		SkillIndicesByWeaponState[static_cast<int32>(SkillData.WeaponState)].Add(SkillIndex);
+	});
+
+	// 선행 스킬을 비트셋으로
+	PrerequisiteMasks.SetNum(Skills.Num());
+
+	for (int32 SkillIndex = 0; SkillIndex < Skills.Num(); ++SkillIndex)
+	{
+		TBitArray<>& Mask = PrerequisiteMasks[SkillIndex];
+		Mask.Init(false, Skills.Num());
+
+		for (const FName& Prereq : Skills[SkillIndex].Prerequisites)
+		{
+			const int32 PrereqIndex = GetSkillIndex(Prereq);
+			if (PrereqIndex == INDEX_NONE)
+			{
+				// 없는 선행 스킬은 절대 해제할 수 없음 - 자기 자신을 선행 스킬로 둬서 막음
+				UE_LOG(LogTemp, Warning, TEXT("Skill %s has unknown prerequisite %s"), *Skills[SkillIndex].SkillID.ToString(), *Prereq.ToString());
+				Mask[SkillIndex] = true;
+				continue;
+			}
+
+			Mask[PrereqIndex] = true;
+		}
+	}
+
+	UnlockedMask.Init(false, Skills.Num());
+}
+
+int32 UPlayerProgressionComponent::GetSkillIndex(FName SkillID) const
+{
+	const int32* SkillIndex = SkillIndices.Find(SkillID);
+	return SkillIndex ? *SkillIndex : INDEX_NONE;
 }
 
 bool UPlayerProgressionComponent::IsSkillUnlocked(FName SkillID) const
 {
-	return UnlockedSkills.Contains(SkillID);
+	const int32 SkillIndex = GetSkillIndex(SkillID);
+	return SkillIndex != INDEX_NONE && UnlockedMask[SkillIndex];
 }
 
 bool UPlayerProgressionComponent::CanUnlockSkill(FName SkillID) const
 {
-	// 이미 해제되어 있으면 false
-	if (IsSkillUnlocked(SkillID))
+	const int32 SkillIndex = GetSkillIndex(SkillID);
+	if (SkillIndex == INDEX_NONE)
 		return false;
 
-	FSkillData SkillData = GetSkillData(SkillID);
-	if (SkillData.SkillID.IsNone())
+	// 이미 해제되어 있으면 false
+	if (UnlockedMask[SkillIndex])
 		return false;
 
-	// 선행 스킬 확인
-	for (const FName& Prereq : SkillData.Prerequisites)
-	{
-		if (!IsSkillUnlocked(Prereq))
-			return false;
-	}
+	// 선행 스킬 확인 - 비트셋 마스크 검사
+	if (!ContainsAllBits(UnlockedMask, PrerequisiteMasks[SkillIndex]))
+		return false;
 
 	// 비용 확인
-	return AvailablePoints >= SkillData.UnlockCost;
+	return AvailablePoints >= Skills[SkillIndex].UnlockCost;
 }
 
 bool UPlayerProgressionComponent::UnlockSkill(FName SkillID)
@@ -46,15 +162,13 @@ bool UPlayerProgressionComponent::UnlockSkill(FName SkillID)
 	if (!CanUnlockSkill(SkillID))
 		return false;
 
-	FSkillData SkillData = GetSkillData(SkillID);
-	if (SkillData.SkillID.IsNone())
-		return false;
+	const int32 SkillIndex = GetSkillIndex(SkillID);
 
 	// 포인트 차감
-	AvailablePoints -= SkillData.UnlockCost;
+	AvailablePoints -= Skills[SkillIndex].UnlockCost;
 
 	// 스킬 해제
-	UnlockedSkills.Add(SkillID);
+	UnlockSkillAt(SkillIndex);
 
 	// 이벤트 브로드캐스트
 	OnSkillUnlocked.Broadcast(SkillID);
@@ -62,76 +176,86 @@ bool UPlayerProgressionComponent::UnlockSkill(FName SkillID)
 
 	UE_LOG(LogTemp, Log, TEXT("Skill Unlocked: %s"), *SkillID.ToString());
 
+	SaveProgression();
+
 	return true;
 }
 
-FSkillData UPlayerProgressionComponent::GetSkillData(FName SkillID) const
+const FSkillData& UPlayerProgressionComponent::GetSkillData(FName SkillID) const
 {
-	if (!SkillDataTable)
+	if (const FSkillData* SkillData = FindSkillData(SkillID))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SkillDataTable is not assigned in PlayerProgressionComponent!"));
-		return FSkillData();
+		return *SkillData;
 	}
 
-	FSkillData* SkillData = SkillDataTable->FindRow<FSkillData>(SkillID, TEXT(""));
-	if (!SkillData)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Skill not found in DataTable: %s"), *SkillID.ToString());
-		return FSkillData();
-	}
+	UE_LOG(LogTemp, Warning, TEXT("Skill not found in DataTable: %s"), *SkillID.ToString());
 
-	return *SkillData;
+	static const FSkillData EmptySkillData;
+	return EmptySkillData;
 }
 
-TArray<FSkillData> UPlayerProgressionComponent::GetAllSkills() const
+const FSkillData* UPlayerProgressionComponent::FindSkillData(FName SkillID) const
 {
-	TArray<FSkillData> AllSkills;
+	const int32 SkillIndex = GetSkillIndex(SkillID);
+	return SkillIndex != INDEX_NONE ? &Skills[SkillIndex] : nullptr;
+}
 
-	if (!SkillDataTable)
-		return AllSkills;
+const TArray<int32>& UPlayerProgressionComponent::GetSkillIndicesByType(ESkillType SkillType) const
+{
+	static const TArray<int32> NoSkills;
 
-	TArray<FName> RowNames = SkillDataTable->GetRowNames();
-	for (const FName& RowName : RowNames)
-	{
-		if (FSkillData* SkillData = SkillDataTable->FindRow<FSkillData>(RowName, TEXT("")))
-		{
-			AllSkills.Add(*SkillData);
-		}
-	}
+	const int32 TypeIndex = static_cast<int32>(SkillType);
+	return SkillIndicesByType.IsValidIndex(TypeIndex) ? SkillIndicesByType[TypeIndex] : NoSkills;
+}
 
-	return AllSkills;
+const TArray<int32>& UPlayerProgressionComponent::GetSkillIndicesByWeaponState(EWeaponState WeaponState) const
+{
+	static const TArray<int32> NoSkills;
+
+	const int32 StateIndex = static_cast<int32>(WeaponState);
+	return SkillIndicesByWeaponState.IsValidIndex(StateIndex) ? SkillIndicesByWeaponState[StateIndex] : NoSkills;
+}
+
+const FSkillData& UPlayerProgressionComponent::GetSkillDataAt(int32 SkillIndex) const
+{
+	static const FSkillData EmptySkillData;
+	return Skills.IsValidIndex(SkillIndex) ? Skills[SkillIndex] : EmptySkillData;
 }
 
 TArray<FSkillData> UPlayerProgressionComponent::GetSkillsByType(ESkillType SkillType) const
 {
-	TArray<FSkillData> FilteredSkills;
+	TArray<FSkillData> Result;
 
-	TArray<FSkillData> AllSkills = GetAllSkills();
-	for (const FSkillData& Skill : AllSkills)
+	for (const int32 SkillIndex : GetSkillIndicesByType(SkillType))
 	{
-		if (Skill.SkillType == SkillType)
-		{
-			FilteredSkills.Add(Skill);
-		}
+		Result.Add(Skills[SkillIndex]);
 	}
 
-	return FilteredSkills;
+	return Result;
 }
 
 TArray<FSkillData> UPlayerProgressionComponent::GetSkillsByWeaponState(EWeaponState WeaponState) const
 {
-	TArray<FSkillData> FilteredSkills;
+	TArray<FSkillData> Result;
 
-	TArray<FSkillData> AllSkills = GetAllSkills();
-	for (const FSkillData& Skill : AllSkills)
+	for (const int32 SkillIndex : GetSkillIndicesByWeaponState(WeaponState))
 	{
-		if (Skill.WeaponState == WeaponState)
-		{
-			FilteredSkills.Add(Skill);
-		}
+		Result.Add(Skills[SkillIndex]);
+	}
+
+	return Result;
+}
+
+TArray<FName> UPlayerProgressionComponent::GetUnlockedSkillIDs() const
+{
+	TArray<FName> SkillIDs;
+
+	for (TConstSetBitIterator<> It(UnlockedMask); It; ++It)
+	{
+		SkillIDs.Add(Skills[It.GetIndex()].SkillID);
 	}
 
-	return FilteredSkills;
+	return SkillIDs;
 }
 
 void UPlayerProgressionComponent::AddPoints(int32 Points)
@@ -140,25 +264,45 @@ void UPlayerProgressionComponent::AddPoints(int32 Points)
 	OnPointsChanged.Broadcast(AvailablePoints);
 
 	UE_LOG(LogTemp, Log, TEXT("Points Added: %d | Total: %d"), Points, AvailablePoints);
+
+	SaveProgression();
 }
 
 void UPlayerProgressionComponent::ForceUnlockSkill(FName SkillID)
 {
-	if (!IsSkillUnlocked(SkillID))
+	const int32 SkillIndex = GetSkillIndex(SkillID);
+	if (SkillIndex == INDEX_NONE)
 	{
-		UnlockedSkills.Add(SkillID);
+		UE_LOG(LogTemp, Warning, TEXT("Skill not found in DataTable: %s"), *SkillID.ToString());
+		return;
+	}
+
+	if (!UnlockedMask[SkillIndex])
+	{
+		UnlockSkillAt(SkillIndex);
 		OnSkillUnlocked.Broadcast(SkillID);
 
 		UE_LOG(LogTemp, Warning, TEXT("Skill Force Unlocked (Debug): %s"), *SkillID.ToString());
+
+		SaveProgression();
 	}
 }
 
 void UPlayerProgressionComponent::ResetAllSkills()
 {
-	UnlockedSkills.Empty();
+	RemovePassiveSkills();
+	UnlockedMask.Init(false, Skills.Num());
 	UnlockInitialSkills();
 
 	UE_LOG(LogTemp, Warning, TEXT("All skills have been reset!"));
+
+	SaveProgression();
+}
+
+void UPlayerProgressionComponent::UnlockSkillAt(int32 SkillIndex)
+{
+	UnlockedMask[SkillIndex] = true;
+	ApplyPassiveSkill(Skills[SkillIndex]);
 }
 
 void UPlayerProgressionComponent::UnlockInitialSkills()
@@ -166,13 +310,109 @@ void UPlayerProgressionComponent::UnlockInitialSkills()
 	// 기본 공격 스킬들을 자동으로 해제
 	// DataTable에서 UnlockCost가 0인 스킬들을 자동 해제할 수도 있음
 
-	TArray<FSkillData> AllSkills = GetAllSkills();
-	for (const FSkillData& Skill : AllSkills)
+	for (int32 SkillIndex = 0; SkillIndex < Skills.Num(); ++SkillIndex)
 	{
-		if (Skill.UnlockCost == 0)
+		if (Skills[SkillIndex].UnlockCost == 0 && !UnlockedMask[SkillIndex])
 		{
-			UnlockedSkills.Add(Skill.SkillID);
-			UE_LOG(LogTemp, Log, TEXT("Initial Skill Unlocked: %s"), *Skill.SkillID.ToString());
+			UnlockSkillAt(SkillIndex);
+			UE_LOG(LogTemp, Log, TEXT("Initial Skill Unlocked: %s"), *Skills[SkillIndex].SkillID.ToString());
 		}
 	}
 }
+
+void UPlayerProgressionComponent::ApplyPassiveSkill(const FSkillData& SkillData) const
+{
+	if (SkillData.SkillType != ESkillType::Passive || SkillData.DamageModifiers.Num() == 0)
+		return;
+
+	// 수정자는 스킬 ID를 소스로 등록되고, 등록될 때 한 번만 컴파일됨
+	if (UDamageModifierComponent* DamageModifiers = GetOwner()->FindComponentByClass<UDamageModifierComponent>())
+	{
+		DamageModifiers->AddModifierSource(SkillData.SkillID, SkillData.DamageModifiers);
+	}
+}
+
+void UPlayerProgressionComponent::RemovePassiveSkills() const
+{
+	UDamageModifierComponent* DamageModifiers = GetOwner()->FindComponentByClass<UDamageModifierComponent>();
+	if (!DamageModifiers)
+		return;
+
+	for (TConstSetBitIterator<> It(UnlockedMask); It; ++It)
+	{
+		DamageModifiers->RemoveModifierSource(Skills[It.GetIndex()].SkillID);
+	}
+}
+
+void UPlayerProgressionComponent::SaveProgression()
+{
+	// 로드 전에 저장하면 기존 저장 파일을 기본값으로 덮어씀
+	if (!bSaveLoaded)
+		return;
+
+	UProgressionSaveSubsystem* SaveSubsystem = UProgressionSaveSubsystem::Get(this);
+	if (!SaveSubsystem)
+		return;
+
+	// 비트셋 워드 복사 정도라 자주 불러도 괜찮음. 바뀐 게 없으면 서브시스템에서 바로 버림
+	FProgressionSaveData Data;
+	Data.AvailablePoints = AvailablePoints;
+	Data.SkillTableHash = SkillTableHash;
+	Data.NumSkills = Skills.Num();
+	Data.UnlockedSkillWords.Append(UnlockedMask.GetData(), FBitSet::CalculateNumWords(UnlockedMask.Num()));
+	Data.UnlockedSkillIDs = GetUnlockedSkillIDs();
+
+	SaveSubsystem->SaveProgression(MoveTemp(Data));
+}
+
+void UPlayerProgressionComponent::ApplySavedProgression()
+{
+	UProgressionSaveSubsystem* SaveSubsystem = UProgressionSaveSubsystem::Get(this);
+	if (!SaveSubsystem)
+		return;
+
+	SaveSubsystem->OnLoadComplete.Remove(SaveLoadedHandle);
+	bSaveLoaded = true;
+
+	const FProgressionSaveData* Data = SaveSubsystem->GetCurrentData();
+	if (!Data)
+		return;
+
+	AvailablePoints = Data->AvailablePoints;
+
+	// 테이블이 같으면 비트셋을 그대로, 바뀌었으면 스킬 ID로 다시 매핑
+	TBitArray<> SavedMask;
+
+	if (Data->SkillTableHash == SkillTableHash && Data->NumSkills == Skills.Num()
+		&& Data->UnlockedSkillWords.Num() == FBitSet::CalculateNumWords(Skills.Num()))
+	{
+		SavedMask.Init(false, Skills.Num());
+		FMemory::Memcpy(SavedMask.GetData(), Data->UnlockedSkillWords.GetData(), Data->UnlockedSkillWords.Num() * sizeof(uint32));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("Skill table changed since the last save, remapping unlocked skills by ID"));
+
+		SavedMask.Init(false, Skills.Num());
+
+		for (const FName& SkillID : Data->UnlockedSkillIDs)
+		{
+			const int32 SkillIndex = GetSkillIndex(SkillID);
+			if (SkillIndex != INDEX_NONE)
+				SavedMask[SkillIndex] = true;
+		}
+	}
+
+	for (TConstSetBitIterator<> It(SavedMask); It; ++It)
+	{
+		if (It.GetIndex() < Skills.Num() && !UnlockedMask[It.GetIndex()])
+		{
+			UnlockSkillAt(It.GetIndex());
+			OnSkillUnlocked.Broadcast(Skills[It.GetIndex()].SkillID);
+		}
+	}
+
+	OnPointsChanged.Broadcast(AvailablePoints);
+
+	UE_LOG(LogTemp, Log, TEXT("Progression loaded: %d points, %d skills unlocked"), AvailablePoints, GetUnlockedSkillIDs().Num());
+}
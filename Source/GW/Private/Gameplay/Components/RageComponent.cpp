@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Components/RageComponent.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+URageComponent::URageComponent()
+{
+	// Rage is event driven, so the component never ticks
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void URageComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void URageComponent::AddRage(float Amount)
+{
+	if (bRageActive || Amount <= 0.0f || CurrentRage >= MaxRage)
+	{
+		return;
+	}
+
+	CurrentRage = FMath::Min(CurrentRage + Amount, MaxRage);
+
+	// Go straight into rage mode when full, if we're set up to
+	if (bActivateWhenFull && TryActivateRage())
+	{
+		return;
+	}
+
+	MarkRageChanged();
+}
+
+bool URageComponent::TryActivateRage()
+{
+	if (bRageActive || CurrentRage < MaxRage)
+	{
+		return false;
+	}
+
+	bRageActive = true;
+	RageEndTime = GetWorld()->GetTimeSeconds() + RageDuration;
+	GetWorld()->GetTimerManager().SetTimer(RageTimer, this, &URageComponent::EndRage, RageDuration, false);
+
+	SetRageDamageBuff(true);
+
+	MarkRageChanged();
+
+	return true;
+}
+
+float URageComponent::GetRagePercent() const
+{
+	if (bRageActive)
+	{
+		return GetRageTimeRemaining() / RageDuration;
+	}
+
+	return CurrentRage / MaxRage;
+}
+
+float URageComponent::GetRageTimeRemaining() const
+{
+	if (!bRageActive)
+	{
+		return 0.0f;
+	}
+
+	return FMath::Max(0.0f, RageEndTime - GetWorld()->GetTimeSeconds());
+}
+
+void URageComponent::EndRage()
+{
+	bRageActive = false;
+	CurrentRage = 0.0f;
+
+	SetRageDamageBuff(false);
+
+	MarkRageChanged();
+}
+
+void URageComponent::SetRageDamageBuff(bool bEnabled)
+{
+	UDamageModifierComponent* DamageModifiers = GetOwner()->FindComponentByClass<UDamageModifierComponent>();
+
+	if (!DamageModifiers)
+	{
+		return;
+	}
+
+	static const FName RageSourceID(TEXT("Rage"));
+
+	if (bEnabled)
+	{
+		FDamageModifier RageModifier;
+		RageModifier.Scope = EDamageModifierScope::Outgoing;
+		RageModifier.Op = EDamageModifierOp::Multiply;
+		RageModifier.Value = RageDamageMultiplier;
+
+		DamageModifiers->AddModifierSource(RageSourceID, { RageModifier });
+	}
+	else
+	{
+		DamageModifiers->RemoveModifierSource(RageSourceID);
+	}
+}
+
+void URageComponent::MarkRageChanged()
+{
+	if (bNotifyPending)
+	{
+		return;
+	}
+
+	bNotifyPending = true;
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &URageComponent::BroadcastRageChanged);
+}
+
+void URageComponent::BroadcastRageChanged()
+{
+	bNotifyPending = false;
+
+	// UI can animate the drain from the remaining time, so it doesn't need to poll
+	OnRageChanged.Broadcast(GetRagePercent(), bRageActive, GetRageTimeRemaining());
+}
@@ -2,26 +2,34 @@
 
 
 #include "Gameplay/Objects/RageOrb.h"
+#include "Gameplay/Subsystems/OrbSimulationSubsystem.h"
 
 // Sets default values
 ARageOrb::ARageOrb()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// The orb simulation does all the work
+	PrimaryActorTick.bCanEverTick = false;
 
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 }
 
 // Called when the game starts or when spawned
 void ARageOrb::BeginPlay()
 {
 	Super::BeginPlay();
-	
-}
-
-// Called every frame
-void ARageOrb::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
 
+	// Hand the orb over to the simulation, and get out of the way
+	if (UOrbSimulationSubsystem* Orbs = UOrbSimulationSubsystem::Get(this))
+	{
+		if (bLaunchOnSpawn)
+		{
+			Orbs->SpawnOrbBurst(EOrbKind::Rage, GetActorLocation(), 1, RageAmount);
+		}
+		else
+		{
+			Orbs->SpawnOrb(EOrbKind::Rage, GetActorLocation(), FVector::ZeroVector, RageAmount);
+		}
+	}
+
+	Destroy();
 }
-
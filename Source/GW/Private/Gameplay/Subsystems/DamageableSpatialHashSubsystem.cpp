@@ -0,0 +1,466 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/DamageableSpatialHashSubsystem.h"
+#include "CombatDamageable.h"
+#include "Components/SceneComponent.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Engine/OverlapResult.h"
+#include "HAL/IConsoleManager.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spatial Hash Actors"), STAT_GW_SpatialHashActors, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spatial Hash Cells"), STAT_GW_SpatialHashCells, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Spatial Hash Query"), STAT_GW_SpatialHashQuery, STATGROUP_GW);
+
+UDamageableSpatialHashSubsystem* UDamageableSpatialHashSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UDamageableSpatialHashSubsystem>() : nullptr;
+}
+
+bool UDamageableSpatialHashSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDamageableSpatialHashSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UDamageableSpatialHashSubsystem::OnActorSpawned));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UDamageableSpatialHashSubsystem::OnActorDestroyed));
+}
+
+void UDamageableSpatialHashSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyedHandler(ActorDestroyedHandle);
+	}
+
+	// Stop listening to anything still hashed
+	for (AActor* Actor : Actors)
+	{
+		if (IsValid(Actor) && Actor->GetRootComponent())
+		{
+			Actor->GetRootComponent()->TransformUpdated.RemoveAll(this);
+		}
+	}
+
+	Actors.Reset();
+	Locations.Reset();
+	Radii.Reset();
+	Cells.Reset();
+	ActorIndices.Reset();
+	Grid.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDamageableSpatialHashSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Pick up the damageables placed in the level
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		if (It->Implements<UCombatDamageable>())
+		{
+			RegisterActor(*It);
+		}
+	}
+}
+
+void UDamageableSpatialHashSubsystem::RegisterActor(AActor* Actor)
+{
+	USceneComponent* Root = IsValid(Actor) ? Actor->GetRootComponent() : nullptr;
+
+	if (!Root || ActorIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	const int32 Index = Actors.Add(Actor);
+	const FVector Location = Actor->GetActorLocation();
+	const FIntVector Cell = GetCell(Location);
+	const float Radius = Actor->GetSimpleCollisionRadius();
+
+	Locations.Add(Location);
+	Radii.Add(Radius);
+	Cells.Add(Cell);
+	ActorIndices.Add(Actor, Index);
+	Grid.FindOrAdd(Cell).Add(Index);
+
+	MaxActorRadius = FMath::Max(MaxActorRadius, Radius);
+
+	// Follow the actor as it moves
+	Root->TransformUpdated.AddUObject(this, &UDamageableSpatialHashSubsystem::OnRootTransformUpdated);
+
+	UpdateStats();
+}
+
+void UDamageableSpatialHashSubsystem::UnregisterActor(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!ActorIndices.RemoveAndCopyValue(Actor, Index))
+	{
+		return;
+	}
+
+	if (IsValid(Actor) && Actor->GetRootComponent())
+	{
+		Actor->GetRootComponent()->TransformUpdated.RemoveAll(this);
+	}
+
+	// Take the actor out of its cell
+	if (TArray<int32>* CellIndices = Grid.Find(Cells[Index]))
+	{
+		CellIndices->RemoveSingleSwap(Index, EAllowShrinking::No);
+
+		if (CellIndices->IsEmpty())
+		{
+			Grid.Remove(Cells[Index]);
+		}
+	}
+
+	// Swap the last actor into the freed slot and fix up its index in the map and its cell
+	const int32 LastIndex = Actors.Num() - 1;
+
+	if (Index != LastIndex)
+	{
+		ActorIndices.Add(Actors[LastIndex], Index);
+
+		if (TArray<int32>* LastCellIndices = Grid.Find(Cells[LastIndex]))
+		{
+			const int32 SlotInCell = LastCellIndices->Find(LastIndex);
+
+			if (SlotInCell != INDEX_NONE)
+			{
+				(*LastCellIndices)[SlotInCell] = Index;
+			}
+		}
+	}
+
+	Actors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Locations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Radii.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Cells.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	UpdateStats();
+}
+
+FIntVector UDamageableSpatialHashSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+template <typename VisitorType>
+void UDamageableSpatialHashSubsystem::ForEachInBox(const FBox& Box, const AActor* IgnoreActor, VisitorType&& Visitor) const
+{
+	// Actors are hashed by their center, so pad the box by the largest radius
+	const FBox PaddedBox = Box.ExpandBy(MaxActorRadius);
+	const FIntVector MinCell = GetCell(PaddedBox.Min);
+	const FIntVector MaxCell = GetCell(PaddedBox.Max);
+
+	auto VisitCell = [&](const TArray<int32>& CellIndices)
+	{
+		for (const int32 Index : CellIndices)
+		{
+			const AActor* Actor = Actors[Index];
+
+			if (Actor != IgnoreActor && IsValid(Actor) && !Actor->IsHidden())
+			{
+				Visitor(Index);
+			}
+		}
+	};
+
+	const int64 NumBoxCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+
+	// Large queries over a sparse grid are cheaper walking the occupied cells
+	if (NumBoxCells > Grid.Num())
+	{
+		for (const TPair<FIntVector, TArray<int32>>& Pair : Grid)
+		{
+			const FIntVector& Cell = Pair.Key;
+
+			if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y && Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z)
+			{
+				VisitCell(Pair.Value);
+			}
+		}
+
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				if (const TArray<int32>* CellIndices = Grid.Find(FIntVector(X, Y, Z)))
+				{
+					VisitCell(*CellIndices);
+				}
+			}
+		}
+	}
+}
+
+void UDamageableSpatialHashSubsystem::QueryRadius(const FVector& Center, float Radius, FDamageableQueryResults& OutResults, const AActor* IgnoreActor) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_SpatialHashQuery);
+
+	OutResults.Reset();
+
+	const FBox Bounds = FBox(Center, Center).ExpandBy(Radius);
+
+	ForEachInBox(Bounds, IgnoreActor, [&](int32 Index)
+	{
+		if (FVector::DistSquared(Locations[Index], Center) <= FMath::Square(Radius + Radii[Index]))
+		{
+			OutResults.Actors.Add(Actors[Index]);
+			OutResults.Locations.Add(Locations[Index]);
+		}
+	});
+}
+
+void UDamageableSpatialHashSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees, FDamageableQueryResults& OutResults, const AActor* IgnoreActor) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_SpatialHashQuery);
+
+	OutResults.Reset();
+
+	const float HalfAngle = FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.0f, 89.0f));
+	const float TanHalfAngle = FMath::Tan(HalfAngle);
+	const float InvCosHalfAngle = 1.0f / FMath::Cos(HalfAngle);
+
+	// Bound the cone by the sphere around its origin
+	const FBox Bounds = FBox(Origin, Origin).ExpandBy(Length);
+
+	ForEachInBox(Bounds, IgnoreActor, [&](int32 Index)
+	{
+		const FVector ToActor = Locations[Index] - Origin;
+		const float ActorRadius = Radii[Index];
+		const float DistanceSquared = ToActor.SizeSquared();
+
+		// Beyond the cone's length
+		if (DistanceSquared > FMath::Square(Length + ActorRadius))
+		{
+			return;
+		}
+
+		// Behind the cone
+		const float AlongAxis = FVector::DotProduct(ToActor, Direction);
+
+		if (AlongAxis < -ActorRadius)
+		{
+			return;
+		}
+
+		// Sphere against cone: distance from the axis must be within the cone's radius at that depth, widened by the sphere
+		const float FromAxis = FMath::Sqrt(FMath::Max(DistanceSquared - FMath::Square(AlongAxis), 0.0f));
+
+		if (FromAxis <= FMath::Max(AlongAxis, 0.0f) * TanHalfAngle + ActorRadius * InvCosHalfAngle)
+		{
+			OutResults.Actors.Add(Actors[Index]);
+			OutResults.Locations.Add(Locations[Index]);
+		}
+	});
+}
+
+void UDamageableSpatialHashSubsystem::QueryCapsule(const FVector& Start, const FVector& End, float Radius, FDamageableQueryResults& OutResults, const AActor* IgnoreActor) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_SpatialHashQuery);
+
+	OutResults.Reset();
+
+	FBox Bounds(Start, Start);
+	Bounds += End;
+	Bounds = Bounds.ExpandBy(Radius);
+
+	ForEachInBox(Bounds, IgnoreActor, [&](int32 Index)
+	{
+		if (FMath::PointDistToSegmentSquared(Locations[Index], Start, End) <= FMath::Square(Radius + Radii[Index]))
+		{
+			OutResults.Actors.Add(Actors[Index]);
+			OutResults.Locations.Add(Locations[Index]);
+		}
+	});
+}
+
+void UDamageableSpatialHashSubsystem::UpdateActorLocation(int32 Index, const FVector& NewLocation)
+{
+	Locations[Index] = NewLocation;
+
+	const FIntVector NewCell = GetCell(NewLocation);
+
+	// Most moves stay within the same cell
+	if (NewCell == Cells[Index])
+	{
+		return;
+	}
+
+	if (TArray<int32>* OldCellIndices = Grid.Find(Cells[Index]))
+	{
+		OldCellIndices->RemoveSingleSwap(Index, EAllowShrinking::No);
+
+		if (OldCellIndices->IsEmpty())
+		{
+			Grid.Remove(Cells[Index]);
+		}
+	}
+
+	Grid.FindOrAdd(NewCell).Add(Index);
+	Cells[Index] = NewCell;
+}
+
+void UDamageableSpatialHashSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->Implements<UCombatDamageable>())
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void UDamageableSpatialHashSubsystem::OnActorDestroyed(AActor* Actor)
+{
+	UnregisterActor(Actor);
+}
+
+void UDamageableSpatialHashSubsystem::OnRootTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (const int32* Index = ActorIndices.Find(Component->GetOwner()))
+	{
+		UpdateActorLocation(*Index, Component->GetComponentLocation());
+	}
+}
+
+void UDamageableSpatialHashSubsystem::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GW_SpatialHashActors, Actors.Num());
+	SET_DWORD_STAT(STAT_GW_SpatialHashCells, Grid.Num());
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ *  Compares spatial hash radius queries against physics sphere overlaps at 10, 100 and 1000 actors.
+ *  Spawns temporary sphere actors far above the level, runs the same random queries through both, and logs the average cost.
+ *  Usage: GW.SpatialHash.Benchmark [NumQueries] [QueryRadius]
+ */
+static void RunDamageableSpatialHashBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	UDamageableSpatialHashSubsystem* SpatialHash = UDamageableSpatialHashSubsystem::Get(World);
+
+	if (!SpatialHash)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Spatial hash benchmark needs a game world"));
+		return;
+	}
+
+	const int32 NumQueries = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+	const float QueryRadius = Args.Num() > 1 ? FMath::Max(1.0f, FCString::Atof(*Args[1])) : 500.0f;
+
+	// Keep the test actors clear of the level so nothing else is counted by the physics query
+	const FVector TestOrigin(0.0f, 0.0f, 100000.0f);
+	const FVector TestExtent(5000.0f, 5000.0f, 200.0f);
+	const int32 ActorCounts[] = { 10, 100, 1000 };
+
+	FRandomStream Random(1234);
+
+	for (const int32 NumActors : ActorCounts)
+	{
+		TArray<AActor*> TestActors;
+		TestActors.Reserve(NumActors);
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		for (int32 Index = 0; Index < NumActors; ++Index)
+		{
+			const FVector Location = TestOrigin + FVector(Random.FRandRange(-TestExtent.X, TestExtent.X), Random.FRandRange(-TestExtent.Y, TestExtent.Y), Random.FRandRange(-TestExtent.Z, TestExtent.Z));
+
+			AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location), SpawnParams);
+
+			USphereComponent* Sphere = NewObject<USphereComponent>(Actor);
+			Sphere->SetSphereRadius(40.0f);
+			Sphere->SetCollisionObjectType(ECC_Pawn);
+			Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			Sphere->SetCollisionResponseToAllChannels(ECR_Overlap);
+			Actor->SetRootComponent(Sphere);
+			Sphere->RegisterComponent();
+			Sphere->SetWorldLocation(Location);
+
+			SpatialHash->RegisterActor(Actor);
+			TestActors.Add(Actor);
+		}
+
+		// Use the same query centers for both
+		TArray<FVector> Centers;
+		Centers.Reserve(NumQueries);
+
+		for (int32 Index = 0; Index < NumQueries; ++Index)
+		{
+			Centers.Add(TestOrigin + FVector(Random.FRandRange(-TestExtent.X, TestExtent.X), Random.FRandRange(-TestExtent.Y, TestExtent.Y), 0.0f));
+		}
+
+		FDamageableQueryResults HashResults;
+		int64 HashHits = 0;
+
+		const double HashStart = FPlatformTime::Seconds();
+
+		for (const FVector& Center : Centers)
+		{
+			SpatialHash->QueryRadius(Center, QueryRadius, HashResults);
+			HashHits += HashResults.Num();
+		}
+
+		const double HashSeconds = FPlatformTime::Seconds() - HashStart;
+
+		TArray<FOverlapResult> Overlaps;
+		const FCollisionObjectQueryParams ObjectParams(ECC_Pawn);
+		const FCollisionShape Shape = FCollisionShape::MakeSphere(QueryRadius);
+		int64 PhysicsHits = 0;
+
+		const double PhysicsStart = FPlatformTime::Seconds();
+
+		for (const FVector& Center : Centers)
+		{
+			Overlaps.Reset();
+			World->OverlapMultiByObjectType(Overlaps, Center, FQuat::Identity, ObjectParams, Shape);
+			PhysicsHits += Overlaps.Num();
+		}
+
+		const double PhysicsSeconds = FPlatformTime::Seconds() - PhysicsStart;
+
+		UE_LOG(LogGW, Log, TEXT("Spatial hash benchmark: %d actors, %d queries, radius %.0f | hash %.2f us/query (%lld hits) | physics %.2f us/query (%lld hits) | %.1fx"),
+			NumActors, NumQueries, QueryRadius,
+			HashSeconds * 1e6 / NumQueries, HashHits,
+			PhysicsSeconds * 1e6 / NumQueries, PhysicsHits,
+			HashSeconds > 0.0 ? PhysicsSeconds / HashSeconds : 0.0);
+
+		// The destroyed handler takes the actors out of the hash
+		for (AActor* Actor : TestActors)
+		{
+			Actor->Destroy();
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GDamageableSpatialHashBenchmarkCommand(
+	TEXT("GW.SpatialHash.Benchmark"),
+	TEXT("Compares damageable spatial hash radius queries against physics overlaps at 10, 100 and 1000 actors. Args: [NumQueries] [QueryRadius]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDamageableSpatialHashBenchmark));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/EnemyHealthBarSubsystem.h"
+#include "Gameplay/UI/EnemyHealthBarOverlay.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+
+UEnemyHealthBarSubsystem* UEnemyHealthBarSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UEnemyHealthBarSubsystem>() : nullptr;
+}
+
+bool UEnemyHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyHealthBarSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Load the overlay class up front, so it's never loaded while enemies spawn
+	LoadedOverlayClass = OverlayClass.LoadSynchronous();
+
+	if (!LoadedOverlayClass)
+	{
+		LoadedOverlayClass = UEnemyHealthBarOverlay::StaticClass();
+	}
+
+	// Local players already exist by now. Any that join later get theirs on login
+	for (FConstPlayerControllerIterator It = InWorld.GetPlayerControllerIterator(); It; ++It)
+	{
+		CreateOverlay(It->Get());
+	}
+
+	PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UEnemyHealthBarSubsystem::OnPlayerPostLogin);
+}
+
+void UEnemyHealthBarSubsystem::Deinitialize()
+{
+	FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+
+	Super::Deinitialize();
+}
+
+void UEnemyHealthBarSubsystem::RegisterHealthBar(AActor* Owner, float HeightOffset, float HealthPercent)
+{
+	if (!IsValid(Owner))
+	{
+		return;
+	}
+
+	// Update the existing bar if there is one
+	if (const int32* ExistingIndex = OwnerIndices.Find(Owner))
+	{
+		HeightOffsets[*ExistingIndex] = HeightOffset;
+		HealthPercents[*ExistingIndex] = FMath::Clamp(HealthPercent, 0.0f, 1.0f);
+		return;
+	}
+
+	OwnerIndices.Add(Owner, Owners.Num());
+	Owners.Add(Owner);
+	HeightOffsets.Add(HeightOffset);
+	HealthPercents.Add(FMath::Clamp(HealthPercent, 0.0f, 1.0f));
+}
+
+void UEnemyHealthBarSubsystem::UnregisterHealthBar(AActor* Owner)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!OwnerIndices.RemoveAndCopyValue(Owner, Index))
+	{
+		return;
+	}
+
+	// Swap the last bar into the freed slot and fix up its index
+	const int32 LastIndex = Owners.Num() - 1;
+
+	if (Index != LastIndex)
+	{
+		OwnerIndices.Add(Owners[LastIndex], Index);
+	}
+
+	Owners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	HeightOffsets.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	HealthPercents.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UEnemyHealthBarSubsystem::SetHealthPercent(AActor* Owner, float HealthPercent)
+{
+	if (const int32* Index = OwnerIndices.Find(Owner))
+	{
+		HealthPercents[*Index] = FMath::Clamp(HealthPercent, 0.0f, 1.0f);
+	}
+}
+
+void UEnemyHealthBarSubsystem::OnPlayerPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	// Logins are reported for every world
+	if (GameMode && GameMode->GetWorld() == GetWorld())
+	{
+		CreateOverlay(NewPlayer);
+	}
+}
+
+void UEnemyHealthBarSubsystem::CreateOverlay(APlayerController* PlayerController)
+{
+	if (!IsValid(PlayerController) || !PlayerController->IsLocalPlayerController() || !LoadedOverlayClass)
+	{
+		return;
+	}
+
+	// Drop overlays whose player went away
+	Overlays.RemoveAll([](const UEnemyHealthBarOverlay* Overlay) { return !IsValid(Overlay) || !IsValid(Overlay->GetOwningPlayer()); });
+
+	const bool bHasOverlay = Overlays.ContainsByPredicate([PlayerController](const UEnemyHealthBarOverlay* Overlay) { return Overlay->GetOwningPlayer() == PlayerController; });
+
+	if (!bHasOverlay)
+	{
+		if (UEnemyHealthBarOverlay* Overlay = CreateWidget<UEnemyHealthBarOverlay>(PlayerController, LoadedOverlayClass))
+		{
+			// Draw under the rest of the HUD
+			Overlay->AddToPlayerScreen(-10);
+			Overlays.Add(Overlay);
+		}
+	}
+}
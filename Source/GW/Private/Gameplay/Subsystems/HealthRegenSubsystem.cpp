@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/HealthRegenSubsystem.h"
+#include "Gameplay/Components/HealthComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Over Time Effects"), STAT_GW_HealthRegenEffects, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Health Regen Step"), STAT_GW_HealthRegenStep, STATGROUP_GW);
+
+UHealthRegenSubsystem* UHealthRegenSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UHealthRegenSubsystem>() : nullptr;
+}
+
+bool UHealthRegenSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHealthRegenSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, HealthRegen);
+
+	Super::Tick(DeltaTime);
+
+	if (Handles.Num() == 0)
+	{
+		TimeSinceStep = 0.0f;
+		return;
+	}
+
+	// Regeneration doesn't need to be smooth, so only step a few times a second
+	const float StepTime = 1.0f / StepRate;
+
+	TimeSinceStep += DeltaTime;
+
+	if (TimeSinceStep < StepTime)
+	{
+		return;
+	}
+
+	TimeSinceStep -= StepTime;
+
+	// Don't try to catch up after a hitch, just drop the missed steps
+	TimeSinceStep = FMath::Min(TimeSinceStep, StepTime);
+
+	UHealthStoreSubsystem* HealthStore = UHealthStoreSubsystem::Get(this);
+
+	if (!HealthStore)
+	{
+		return;
+	}
+
+	StepEffects(HealthStore, StepTime);
+
+	// Tell each touched component once, after the whole batch is done
+	for (const TPair<TWeakObjectPtr<UHealthComponent>, bool>& Touched : TouchedListeners)
+	{
+		if (UHealthComponent* Listener = Touched.Key.Get())
+		{
+			Listener->HandleHealthOverTime(Touched.Value);
+		}
+	}
+
+	TouchedListeners.Reset();
+
+	UpdateStats();
+}
+
+TStatId UHealthRegenSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthRegenSubsystem, STATGROUP_Tickables);
+}
+
+void UHealthRegenSubsystem::AddRegeneration(const FHealthHandle& Handle, float HealthPerSecond, float Duration, UHealthComponent* Listener)
+{
+	if (HealthPerSecond > 0.0f)
+	{
+		AddEffect(Handle, HealthPerSecond, Duration, Listener);
+	}
+}
+
+void UHealthRegenSubsystem::AddDamageOverTime(const FHealthHandle& Handle, float DamagePerSecond, float Duration, UHealthComponent* Listener)
+{
+	if (DamagePerSecond > 0.0f)
+	{
+		AddEffect(Handle, -DamagePerSecond, Duration, Listener);
+	}
+}
+
+void UHealthRegenSubsystem::RemoveEffects(const FHealthHandle& Handle)
+{
+	for (int32 Index = Handles.Num() - 1; Index >= 0; --Index)
+	{
+		if (Handles[Index] == Handle)
+		{
+			RemoveEffect(Index);
+		}
+	}
+
+	UpdateStats();
+}
+
+void UHealthRegenSubsystem::AddEffect(const FHealthHandle& Handle, float Rate, float Duration, UHealthComponent* Listener)
+{
+	if (!Handle.IsSet())
+	{
+		return;
+	}
+
+	Handles.Add(Handle);
+	Rates.Add(Rate);
+	TimesRemaining.Add(Duration > 0.0f ? Duration : -1.0f);
+	Listeners.Add(Listener);
+
+	UpdateStats();
+}
+
+void UHealthRegenSubsystem::StepEffects(UHealthStoreSubsystem* HealthStore, float StepTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_HealthRegenStep);
+
+	// Walk backwards so removals don't skip anything
+	for (int32 Index = Handles.Num() - 1; Index >= 0; --Index)
+	{
+		// Forget effects on entries that were released
+		if (!HealthStore->IsValidHandle(Handles[Index]))
+		{
+			RemoveEffect(Index);
+			continue;
+		}
+
+		// The last step of a timed effect only applies what's left of it
+		float EffectTime = StepTime;
+
+		if (TimesRemaining[Index] >= 0.0f)
+		{
+			EffectTime = FMath::Min(StepTime, TimesRemaining[Index]);
+			TimesRemaining[Index] -= EffectTime;
+		}
+
+		// Dead entries are skipped but keep their effects, so passive regeneration resumes once they're revived.
+		// Timed effects still run out in the meantime
+		if (!HealthStore->IsAlive(Handles[Index]))
+		{
+			if (TimesRemaining[Index] == 0.0f)
+			{
+				RemoveEffect(Index);
+			}
+
+			continue;
+		}
+
+		const float Amount = Rates[Index] * EffectTime;
+
+		bool bKilled = false;
+		const float Applied = Amount >= 0.0f
+			? HealthStore->ApplyHealing(Handles[Index], Amount)
+			: HealthStore->ApplyDamage(Handles[Index], -Amount, bKilled);
+
+		if (Applied > 0.0f && Listeners[Index].IsValid())
+		{
+			TouchedListeners.FindOrAdd(Listeners[Index]) |= bKilled;
+		}
+
+		if (TimesRemaining[Index] == 0.0f)
+		{
+			RemoveEffect(Index);
+		}
+	}
+}
+
+void UHealthRegenSubsystem::RemoveEffect(int32 Index)
+{
+	Handles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Rates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TimesRemaining.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Listeners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UHealthRegenSubsystem::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GW_HealthRegenEffects, Handles.Num());
+}
@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Store Entries"), STAT_GW_HealthStoreEntries, STATGROUP_GW);
+
+UHealthStoreSubsystem* UHealthStoreSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UHealthStoreSubsystem>() : nullptr;
+}
+
+bool UHealthStoreSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FHealthHandle UHealthStoreSubsystem::Register(AActor* Owner, float InMaxHealth, float InShield)
+{
+	int32 Index = INDEX_NONE;
+
+	// Reuse a released slot if there is one
+	if (FreeSlots.Num() > 0)
+	{
+		Index = FreeSlots.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		Index = Generations.Add(0);
+		Health.AddZeroed();
+		MaxHealth.AddZeroed();
+		Shield.AddZeroed();
+		Alive.Add(false);
+		Owners.AddDefaulted();
+	}
+
+	MaxHealth[Index] = FMath::Max(InMaxHealth, 0.0f);
+	Health[Index] = MaxHealth[Index];
+	Shield[Index] = FMath::Max(InShield, 0.0f);
+	Alive[Index] = Health[Index] > 0.0f;
+	Owners[Index] = Owner;
+
+	UpdateStats();
+
+	FHealthHandle Handle;
+	Handle.Index = Index;
+	Handle.Generation = Generations[Index];
+	return Handle;
+}
+
+void UHealthStoreSubsystem::Unregister(FHealthHandle& Handle)
+{
+	if (IsValidHandle(Handle))
+	{
+		// Bump the generation so any copies of the handle go stale
+		++Generations[Handle.Index];
+		Alive[Handle.Index] = false;
+		Owners[Handle.Index].Reset();
+		FreeSlots.Add(Handle.Index);
+
+		UpdateStats();
+	}
+
+	Handle.Reset();
+}
+
+float UHealthStoreSubsystem::GetHealthPercent(const FHealthHandle& Handle) const
+{
+	if (!IsValidHandle(Handle) || MaxHealth[Handle.Index] <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	return Health[Handle.Index] / MaxHealth[Handle.Index];
+}
+
+float UHealthStoreSubsystem::ApplyDamage(const FHealthHandle& Handle, float Damage, bool& bOutKilled)
+{
+	bOutKilled = false;
+
+	if (!IsValidHandle(Handle))
+	{
+		return 0.0f;
+	}
+
+	return DamageSlot(Handle.Index, Damage, bOutKilled);
+}
+
+float UHealthStoreSubsystem::ApplyHealing(const FHealthHandle& Handle, float Amount)
+{
+	return IsValidHandle(Handle) ? HealSlot(Handle.Index, Amount) : 0.0f;
+}
+
+void UHealthStoreSubsystem::SetHealth(const FHealthHandle& Handle, float NewHealth)
+{
+	if (IsValidHandle(Handle))
+	{
+		Health[Handle.Index] = FMath::Clamp(NewHealth, 0.0f, MaxHealth[Handle.Index]);
+		Alive[Handle.Index] = Health[Handle.Index] > 0.0f;
+	}
+}
+
+void UHealthStoreSubsystem::SetMaxHealth(const FHealthHandle& Handle, float NewMaxHealth, bool bRefill)
+{
+	if (IsValidHandle(Handle))
+	{
+		MaxHealth[Handle.Index] = FMath::Max(NewMaxHealth, 0.0f);
+		Health[Handle.Index] = bRefill ? MaxHealth[Handle.Index] : FMath::Min(Health[Handle.Index], MaxHealth[Handle.Index]);
+		Alive[Handle.Index] = Health[Handle.Index] > 0.0f;
+	}
+}
+
+void UHealthStoreSubsystem::SetShield(const FHealthHandle& Handle, float NewShield)
+{
+	if (IsValidHandle(Handle))
+	{
+		Shield[Handle.Index] = FMath::Max(NewShield, 0.0f);
+	}
+}
+
+void UHealthStoreSubsystem::ResetEntry(const FHealthHandle& Handle)
+{
+	if (IsValidHandle(Handle))
+	{
+		Health[Handle.Index] = MaxHealth[Handle.Index];
+		Alive[Handle.Index] = Health[Handle.Index] > 0.0f;
+	}
+}
+
+void UHealthStoreSubsystem::ApplyDamageToMany(TConstArrayView<FHealthHandle> Handles, float Damage, TArray<FHealthHandle>& OutKilled)
+{
+	for (const FHealthHandle& Handle : Handles)
+	{
+		if (!IsValidHandle(Handle))
+		{
+			continue;
+		}
+
+		bool bKilled = false;
+		DamageSlot(Handle.Index, Damage, bKilled);
+
+		if (bKilled)
+		{
+			OutKilled.Add(Handle);
+		}
+	}
+}
+
+void UHealthStoreSubsystem::ApplyHealingToMany(TConstArrayView<FHealthHandle> Handles, float Amount)
+{
+	for (const FHealthHandle& Handle : Handles)
+	{
+		if (IsValidHandle(Handle))
+		{
+			HealSlot(Handle.Index, Amount);
+		}
+	}
+}
+
+void UHealthStoreSubsystem::ResetMany(TConstArrayView<FHealthHandle> Handles)
+{
+	for (const FHealthHandle& Handle : Handles)
+	{
+		if (IsValidHandle(Handle))
+		{
+			Health[Handle.Index] = MaxHealth[Handle.Index];
+			Alive[Handle.Index] = Health[Handle.Index] > 0.0f;
+		}
+	}
+}
+
+float UHealthStoreSubsystem::DamageSlot(int32 Index, float Damage, bool& bOutKilled)
+{
+	bOutKilled = false;
+
+	// Dead entries don't take more damage
+	if (!Alive[Index] || Damage <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// Shields soak damage first
+	const float Absorbed = FMath::Min(Shield[Index], Damage);
+	Shield[Index] -= Absorbed;
+
+	Health[Index] -= Damage - Absorbed;
+
+	if (Health[Index] <= 0.0f)
+	{
+		Health[Index] = 0.0f;
+		Alive[Index] = false;
+		bOutKilled = true;
+	}
+
+	return Damage;
+}
+
+float UHealthStoreSubsystem::HealSlot(int32 Index, float Amount)
+{
+	// Healing doesn't revive
+	if (!Alive[Index] || Amount <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	const float Healed = FMath::Min(Amount, MaxHealth[Index] - Health[Index]);
+	Health[Index] += Healed;
+
+	return Healed;
+}
+
+void UHealthStoreSubsystem::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GW_HealthStoreEntries, GetNumEntries());
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/HealthUISubsystem.h"
+#include "Gameplay/Interfaces/HealthUIOwner.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health UI Updates"), STAT_GW_HealthUIUpdates, STATGROUP_GW);
+
+UHealthUISubsystem* UHealthUISubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UHealthUISubsystem>() : nullptr;
+}
+
+bool UHealthUISubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHealthUISubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, HealthUI);
+
+	Super::Tick(DeltaTime);
+
+	TimeSinceFlush += DeltaTime;
+
+	if (DirtyOwners.Num() == 0)
+	{
+		return;
+	}
+
+	// Optionally hold updates back to a lower UI rate
+	if (UpdateRate > 0.0f && TimeSinceFlush < 1.0f / UpdateRate)
+	{
+		return;
+	}
+
+	TimeSinceFlush = 0.0f;
+
+	FlushDirtyOwners();
+}
+
+TStatId UHealthUISubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthUISubsystem, STATGROUP_Tickables);
+}
+
+void UHealthUISubsystem::MarkDirty(AActor* Owner)
+{
+	if (ensureMsgf(Cast<IHealthUIOwner>(Owner), TEXT("%s doesn't implement IHealthUIOwner"), *GetNameSafe(Owner)))
+	{
+		DirtyOwners.Add(Owner);
+	}
+}
+
+void UHealthUISubsystem::MarkDirty(const UObject* WorldContextObject, AActor* Owner)
+{
+	if (UHealthUISubsystem* HealthUI = Get(WorldContextObject))
+	{
+		HealthUI->MarkDirty(Owner);
+	}
+	else if (IHealthUIOwner* UIOwner = Cast<IHealthUIOwner>(Owner))
+	{
+		UIOwner->FlushHealthUI();
+	}
+}
+
+void UHealthUISubsystem::FlushDirtyOwners()
+{
+	// Owners may mark themselves dirty again while flushing, so work from a copy
+	FlushingOwners.Reset(DirtyOwners.Num());
+
+	for (const TWeakObjectPtr<AActor>& Owner : DirtyOwners)
+	{
+		FlushingOwners.Add(Owner);
+	}
+
+	DirtyOwners.Reset();
+
+	for (const TWeakObjectPtr<AActor>& Owner : FlushingOwners)
+	{
+		if (IHealthUIOwner* UIOwner = Cast<IHealthUIOwner>(Owner.Get()))
+		{
+			UIOwner->FlushHealthUI();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GW_HealthUIUpdates, FlushingOwners.Num());
+}
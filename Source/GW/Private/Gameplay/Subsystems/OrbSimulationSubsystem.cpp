@@ -0,0 +1,365 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/OrbSimulationSubsystem.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Gameplay/Components/HealthComponent.h"
+#include "Gameplay/Components/RageComponent.h"
+#include "GWCharacter.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "NiagaraComponent.h"
+#include "NiagaraSystem.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Orbs Simulated"), STAT_GW_OrbsSimulated, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Orb Simulation"), STAT_GW_OrbSimulation, STATGROUP_GW);
+
+UOrbSimulationSubsystem* UOrbSimulationSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UOrbSimulationSubsystem>() : nullptr;
+}
+
+bool UOrbSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UOrbSimulationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// One transient actor owns the components that draw every orb
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	RenderActor = InWorld.SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+	if (!RenderActor)
+	{
+		return;
+	}
+
+	UStaticMesh* Mesh = OrbMesh.LoadSynchronous();
+
+	// Orbs are still simulated and collected without a mesh, they just can't be seen
+	if (!Mesh)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Orb simulation has no OrbMesh. Set it in the [/Script/GW.OrbSimulationSubsystem] section of DefaultGame.ini"));
+	}
+
+	// One instanced mesh per orb kind, each with its materials tinted in the kind's color, so the kinds can be
+	// told apart with any material that has the color parameter, the engine's basic shape material included
+	for (const EOrbKind Kind : TEnumRange<EOrbKind>())
+	{
+		UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+		Instances->SetStaticMesh(Mesh);
+		Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		Instances->SetCastShadow(false);
+		Instances->SetMobility(EComponentMobility::Movable);
+
+		for (int32 MaterialIndex = 0; Mesh && MaterialIndex < Instances->GetNumMaterials(); ++MaterialIndex)
+		{
+			if (UMaterialInstanceDynamic* Material = Instances->CreateDynamicMaterialInstance(MaterialIndex))
+			{
+				Material->SetVectorParameterValue(ColorParameterName, GetOrbColor(Kind));
+			}
+		}
+
+		if (USceneComponent* Root = RenderActor->GetRootComponent())
+		{
+			Instances->SetupAttachment(Root);
+		}
+		else
+		{
+			RenderActor->SetRootComponent(Instances);
+		}
+
+		Instances->RegisterComponent();
+		OrbInstances.Add(Instances);
+	}
+
+	if (UNiagaraSystem* EffectSystem = OrbEffect.LoadSynchronous())
+	{
+		OrbEffects = NewObject<UNiagaraComponent>(RenderActor, TEXT("OrbEffects"));
+		OrbEffects->SetAsset(EffectSystem);
+		OrbEffects->SetupAttachment(RenderActor->GetRootComponent());
+		OrbEffects->RegisterComponent();
+		OrbEffects->Activate();
+	}
+}
+
+void UOrbSimulationSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	SCOPE_CYCLE_COUNTER(STAT_GW_OrbSimulation);
+	CSV_SCOPED_TIMING_STAT(GW, OrbSimulation);
+
+	Super::Tick(DeltaTime);
+
+	if (Positions.Num() == 0 && NumDrawnOrbs == 0)
+	{
+		return;
+	}
+
+	// Orbs go to the nearest player. With one local player, that's the cached player
+	APawn* Player = nullptr;
+	FVector PlayerLocation = FVector::ZeroVector;
+
+	if (UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this))
+	{
+		if (const FPlayerInfo* Info = PlayerInfo->GetPlayer(0))
+		{
+			Player = Info->Pawn;
+			PlayerLocation = Info->Location;
+		}
+	}
+
+	SimulateOrbs(DeltaTime, Player, PlayerLocation);
+
+	UpdateRendering();
+
+	UpdateStats();
+}
+
+TStatId UOrbSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UOrbSimulationSubsystem, STATGROUP_Tickables);
+}
+
+void UOrbSimulationSubsystem::SpawnOrb(EOrbKind Kind, const FVector& Location, const FVector& Velocity, float Amount)
+{
+	// Find the ground once, so the simulation doesn't need any collision queries
+	float GroundHeight = -UE_BIG_NUMBER;
+
+	FHitResult Hit;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(OrbGround), false);
+
+	if (GetWorld()->LineTraceSingleByChannel(Hit, Location, Location - FVector(0.0f, 0.0f, 5000.0f), ECC_WorldStatic, QueryParams))
+	{
+		GroundHeight = Hit.ImpactPoint.Z + OrbRadius;
+	}
+
+	Positions.Add(Location);
+	Velocities.Add(Velocity);
+	GroundHeights.Add(GroundHeight);
+	Lifetimes.Add(Lifetime);
+	Amounts.Add(Amount);
+	States.Add(EOrbState::Bouncing);
+	Kinds.Add(Kind);
+}
+
+void UOrbSimulationSubsystem::SpawnOrbBurst(EOrbKind Kind, const FVector& Origin, int32 Count, float Amount)
+{
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		// Scatter the orbs and launch them upwards
+		const FVector Offset(FMath::FRandRange(-100.0f, 100.0f), FMath::FRandRange(-100.0f, 100.0f), FMath::FRandRange(50.0f, 150.0f));
+
+		const FVector Direction = FVector(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(0.7f, 1.0f)).GetSafeNormal();
+		const float Speed = FMath::FRandRange(LaunchSpeedRange.X, LaunchSpeedRange.Y);
+
+		SpawnOrb(Kind, Origin + Offset, Direction * Speed, Amount);
+	}
+}
+
+void UOrbSimulationSubsystem::SimulateOrbs(float DeltaTime, APawn* Player, const FVector& PlayerLocation)
+{
+	const int32 NumOrbs = Positions.Num();
+	const float DetectionRadiusSquared = FMath::Square(DetectionRadius);
+	const float CollectRadiusSquared = FMath::Square(CollectRadius);
+	const float MinBounceSpeedSquared = FMath::Square(MinBounceVelocity);
+
+	// Integrate every orb in one pass over the packed arrays
+	for (int32 Index = 0; Index < NumOrbs; ++Index)
+	{
+		FVector& Position = Positions[Index];
+		FVector& Velocity = Velocities[Index];
+
+		switch (States[Index])
+		{
+		case EOrbState::Bouncing:
+		{
+			Velocity.Z -= Gravity * DeltaTime;
+			Position += Velocity * DeltaTime;
+
+			// Bounce off the ground, losing speed each time until we settle
+			if (Position.Z <= GroundHeights[Index])
+			{
+				Position.Z = GroundHeights[Index];
+				Velocity.Z = -Velocity.Z;
+				Velocity *= BounceDamping;
+
+				if (Velocity.SizeSquared() < MinBounceSpeedSquared)
+				{
+					Velocity = FVector::ZeroVector;
+					States[Index] = EOrbState::Settled;
+				}
+			}
+			break;
+		}
+
+		case EOrbState::Settled:
+		{
+			if (Player && FVector::DistSquared(Position, PlayerLocation) <= DetectionRadiusSquared)
+			{
+				States[Index] = EOrbState::Pulled;
+			}
+			break;
+		}
+
+		case EOrbState::Pulled:
+		{
+			Position += (PlayerLocation - Position).GetSafeNormal() * PullSpeed * DeltaTime;
+			break;
+		}
+		}
+
+		// Orbs being pulled don't expire
+		if (States[Index] != EOrbState::Pulled)
+		{
+			Lifetimes[Index] -= DeltaTime;
+		}
+	}
+
+	// Collect and expire orbs. Walk backwards so removals don't skip anything
+	for (int32 Index = NumOrbs - 1; Index >= 0; --Index)
+	{
+		if (States[Index] == EOrbState::Pulled)
+		{
+			// The player went away, so drop back to waiting on the ground
+			if (!Player)
+			{
+				States[Index] = EOrbState::Bouncing;
+			}
+			else if (FVector::DistSquared(Positions[Index], PlayerLocation) <= CollectRadiusSquared)
+			{
+				CollectOrb(Index, Player);
+				RemoveOrb(Index);
+			}
+		}
+		else if (Lifetimes[Index] <= 0.0f)
+		{
+			RemoveOrb(Index);
+		}
+	}
+}
+
+void UOrbSimulationSubsystem::CollectOrb(int32 Index, APawn* Player)
+{
+	switch (Kinds[Index])
+	{
+	case EOrbKind::Heal:
+		if (const AGWCharacter* Character = Cast<AGWCharacter>(Player))
+		{
+			if (UHealthComponent* HealthComp = Character->GetHealthComponent())
+			{
+				HealthComp->ApplyHealing(Amounts[Index], RenderActor);
+			}
+		}
+		break;
+
+	case EOrbKind::Rage:
+		if (URageComponent* RageComp = Player->FindComponentByClass<URageComponent>())
+		{
+			RageComp->AddRage(Amounts[Index]);
+		}
+		break;
+	}
+}
+
+void UOrbSimulationSubsystem::RemoveOrb(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GroundHeights.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Lifetimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Amounts.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	States.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Kinds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+void UOrbSimulationSubsystem::UpdateRendering()
+{
+	const int32 NumOrbs = Positions.Num();
+	NumDrawnOrbs = NumOrbs;
+
+	// Gather each kind's orbs into its own instanced mesh
+	for (int32 KindIndex = 0; KindIndex < OrbInstances.Num(); ++KindIndex)
+	{
+		const EOrbKind Kind = static_cast<EOrbKind>(KindIndex);
+		InstanceTransforms.Reset(NumOrbs);
+
+		for (int32 Index = 0; Index < NumOrbs; ++Index)
+		{
+			if (Kinds[Index] == Kind)
+			{
+				InstanceTransforms.Emplace(FQuat::Identity, Positions[Index], FVector(OrbMeshScale));
+			}
+		}
+
+		UpdateInstances(OrbInstances[KindIndex], InstanceTransforms);
+	}
+
+	// Hand the same positions to the effect
+	if (OrbEffects)
+	{
+		NiagaraKinds.Reset(NumOrbs);
+
+		for (const EOrbKind Kind : Kinds)
+		{
+			NiagaraKinds.Add(static_cast<int32>(Kind));
+		}
+
+		UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(OrbEffects, PositionsParameterName, Positions);
+		UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayInt32(OrbEffects, KindsParameterName, NiagaraKinds);
+	}
+}
+
+void UOrbSimulationSubsystem::UpdateInstances(UInstancedStaticMeshComponent* Instances, const TArray<FTransform>& Transforms)
+{
+	const int32 NumInstances = Instances->GetInstanceCount();
+	const int32 NumTransforms = Transforms.Num();
+
+	// Match the instance count to the orb count
+	if (NumInstances > NumTransforms)
+	{
+		TArray<int32> ExtraInstances;
+		ExtraInstances.Reserve(NumInstances - NumTransforms);
+
+		for (int32 Index = NumTransforms; Index < NumInstances; ++Index)
+		{
+			ExtraInstances.Add(Index);
+		}
+
+		Instances->RemoveInstances(ExtraInstances);
+	}
+	else if (NumInstances < NumTransforms)
+	{
+		TArray<FTransform> NewInstances;
+		NewInstances.Init(FTransform::Identity, NumTransforms - NumInstances);
+		Instances->AddInstances(NewInstances, false, true);
+	}
+
+	// Move every instance in one batch
+	if (NumTransforms > 0)
+	{
+		Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+	}
+}
+
+const FLinearColor& UOrbSimulationSubsystem::GetOrbColor(EOrbKind Kind) const
+{
+	return Kind == EOrbKind::Rage ? RageOrbColor : HealOrbColor;
+}
+
+void UOrbSimulationSubsystem::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GW_OrbsSimulated, Positions.Num());
+}
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+
+UPlayerInfoSubsystem* UPlayerInfoSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UPlayerInfoSubsystem>() : nullptr;
+}
+
+const TArray<FPlayerInfo>& UPlayerInfoSubsystem::GetPlayers()
+{
+	CaptureIfStale();
+	return Players;
+}
+
+const FPlayerInfo* UPlayerInfoSubsystem::GetPlayer(int32 Index)
+{
+	CaptureIfStale();
+	return Players.IsValidIndex(Index) ? &Players[Index] : nullptr;
+}
+
+const FPlayerInfo* UPlayerInfoSubsystem::FindNearestPlayer(const FVector& Location, float& OutDistanceSquared)
+{
+	CaptureIfStale();
+
+	const FPlayerInfo* Nearest = nullptr;
+	OutDistanceSquared = TNumericLimits<float>::Max();
+
+	for (const FPlayerInfo& Player : Players)
+	{
+		const float DistanceSquared = FVector::DistSquared(Location, Player.Location);
+		if (DistanceSquared < OutDistanceSquared)
+		{
+			OutDistanceSquared = DistanceSquared;
+			Nearest = &Player;
+		}
+	}
+
+	return Nearest;
+}
+
+void UPlayerInfoSubsystem::CaptureIfStale()
+{
+	// Only capture once per frame, no matter how many readers there are
+	if (CapturedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CapturedFrame = GFrameCounter;
+	Players.Reset();
+
+	// Player controllers are iterated in the same order GetPlayerPawn indexes them
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		APawn* Pawn = PC ? PC->GetPawn() : nullptr;
+		if (!IsValid(Pawn))
+		{
+			continue;
+		}
+
+		FPlayerInfo& Player = Players.AddDefaulted_GetRef();
+		Player.Pawn = Pawn;
+		Player.Character = Cast<ACharacter>(Pawn);
+		Player.Location = Pawn->GetActorLocation();
+		Player.Velocity = Pawn->GetVelocity();
+	}
+}
@@ -0,0 +1,320 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/ProgressionSaveSubsystem.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "GW.h"
+
+DECLARE_CYCLE_STAT(TEXT("Progression Save Snapshot"), STAT_GW_ProgressionSaveSnapshot, STATGROUP_GW);
+
+namespace ProgressionSave
+{
+	/** "GWPS" */
+	constexpr uint32 Magic = 0x53505747;
+
+	/** Bump when the header or an existing chunk changes layout. New chunks don't need a bump */
+	constexpr uint16 Version = 1;
+
+	/** Chunk tags. Never reuse a tag */
+	enum class EChunk : uint16
+	{
+		Points = 1,
+		Skills = 2
+	};
+
+	/** Header size: magic, version, body CRC */
+	constexpr int32 HeaderSize = sizeof(uint32) + sizeof(uint16) + sizeof(uint32);
+
+	/** Writes a chunk tag and size around whatever the writer function serializes */
+	template <typename WriterFunc>
+	void WriteChunk(FMemoryWriter& Writer, EChunk Tag, WriterFunc&& Write)
+	{
+		uint16 TagValue = static_cast<uint16>(Tag);
+		Writer << TagValue;
+
+		// Leave room for the size and fill it in afterwards
+		const int64 SizeOffset = Writer.Tell();
+		uint32 ChunkSize = 0;
+		Writer << ChunkSize;
+
+		const int64 ChunkStart = Writer.Tell();
+		Write(Writer);
+		const int64 ChunkEnd = Writer.Tell();
+
+		ChunkSize = static_cast<uint32>(ChunkEnd - ChunkStart);
+		Writer.Seek(SizeOffset);
+		Writer << ChunkSize;
+		Writer.Seek(ChunkEnd);
+	}
+}
+
+UProgressionSaveSubsystem* UProgressionSaveSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UProgressionSaveSubsystem>() : nullptr;
+}
+
+void UProgressionSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Read the save in the background, so startup never waits on the disk
+	TWeakObjectPtr<UProgressionSaveSubsystem> WeakThis(this);
+	const FString SavePath = GetSavePath();
+
+	LoadTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, SavePath]()
+	{
+		TOptional<FProgressionSaveData> Data;
+		TArray<uint8> Bytes;
+
+		if (FFileHelper::LoadFileToArray(Bytes, *SavePath, FILEREAD_Silent))
+		{
+			FProgressionSaveData Parsed;
+
+			if (DeserializeSaveData(Bytes, Parsed))
+			{
+				Data = MoveTemp(Parsed);
+			}
+			else
+			{
+				UE_LOG(LogGW, Warning, TEXT("Progression save %s is broken or from an unknown version, ignoring it"), *SavePath);
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Data = MoveTemp(Data)]() mutable
+		{
+			if (UProgressionSaveSubsystem* StrongThis = WeakThis.Get())
+			{
+				StrongThis->FinishLoad(MoveTemp(Data));
+			}
+		});
+	});
+}
+
+void UProgressionSaveSubsystem::Deinitialize()
+{
+	// Don't lose the last save on exit
+	LoadTask.Wait();
+	WriteTask.Wait();
+
+	Super::Deinitialize();
+}
+
+void UProgressionSaveSubsystem::FinishLoad(TOptional<FProgressionSaveData>&& Data)
+{
+	CurrentData = MoveTemp(Data);
+	bLoadComplete = true;
+
+	UE_LOG(LogGW, Log, TEXT("Progression save %s"), CurrentData.IsSet() ? TEXT("loaded") : TEXT("not found, starting fresh"));
+
+	OnLoadComplete.Broadcast();
+}
+
+void UProgressionSaveSubsystem::SaveProgression(FProgressionSaveData&& Data)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_ProgressionSaveSnapshot);
+
+	FScopeLock Lock(&PendingLock);
+
+	// Most autosaves change nothing, so they stop here. After a failed write the same state is written again
+	if (!bLastWriteFailed && CurrentData.IsSet() && CurrentData->HasSameState(Data))
+	{
+		return;
+	}
+
+	bLastWriteFailed = false;
+
+	// Keep the newest snapshot around for components that restore their progression later
+	CurrentData = Data;
+	PendingData = MoveTemp(Data);
+
+	// A running write picks up the new snapshot when it's done
+	if (!bWriteInFlight)
+	{
+		bWriteInFlight = true;
+		WriteTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() { WritePendingData(); });
+	}
+}
+
+FString UProgressionSaveSubsystem::GetSavePath() const
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SaveFileName);
+}
+
+void UProgressionSaveSubsystem::WritePendingData()
+{
+	const FString SavePath = GetSavePath();
+	const FString TempPath = SavePath + TEXT(".tmp");
+
+	TArray<uint8> Bytes;
+
+	while (true)
+	{
+		FProgressionSaveData Data;
+
+		{
+			FScopeLock Lock(&PendingLock);
+
+			if (!PendingData.IsSet())
+			{
+				bWriteInFlight = false;
+				return;
+			}
+
+			Data = MoveTemp(PendingData.GetValue());
+			PendingData.Reset();
+		}
+
+		SerializeSaveData(Data, Bytes);
+
+		// Write next to the old save, then swap it in with a rename
+		bool bWritten = FFileHelper::SaveArrayToFile(Bytes, *TempPath);
+
+		if (!bWritten)
+		{
+			UE_LOG(LogGW, Warning, TEXT("Failed to write progression save %s"), *TempPath);
+		}
+		else if (!IFileManager::Get().Move(*SavePath, *TempPath, true, true))
+		{
+			UE_LOG(LogGW, Warning, TEXT("Failed to replace progression save %s"), *SavePath);
+			bWritten = false;
+		}
+
+		// Only the newest write decides whether the file is up to date, so a later success clears an earlier failure
+		FScopeLock Lock(&PendingLock);
+		bLastWriteFailed = !bWritten;
+	}
+}
+
+void UProgressionSaveSubsystem::SerializeSaveData(const FProgressionSaveData& Data, TArray<uint8>& OutBytes)
+{
+	using namespace ProgressionSave;
+
+	OutBytes.Reset();
+
+	FMemoryWriter Writer(OutBytes);
+
+	// Header, with the CRC filled in once the body is written
+	uint32 MagicValue = Magic;
+	uint16 VersionValue = Version;
+	uint32 BodyCrc = 0;
+	Writer << MagicValue << VersionValue << BodyCrc;
+
+	WriteChunk(Writer, EChunk::Points, [&Data](FMemoryWriter& ChunkWriter)
+	{
+		int32 Points = Data.AvailablePoints;
+		ChunkWriter << Points;
+	});
+
+	WriteChunk(Writer, EChunk::Skills, [&Data](FMemoryWriter& ChunkWriter)
+	{
+		uint32 TableHash = Data.SkillTableHash;
+		int32 NumSkills = Data.NumSkills;
+		ChunkWriter << TableHash << NumSkills;
+
+		TArray<uint32> Words = Data.UnlockedSkillWords;
+		ChunkWriter << Words;
+
+		int32 NumIDs = Data.UnlockedSkillIDs.Num();
+		ChunkWriter << NumIDs;
+
+		for (const FName& SkillID : Data.UnlockedSkillIDs)
+		{
+			FString SkillName = SkillID.ToString();
+			ChunkWriter << SkillName;
+		}
+	});
+
+	BodyCrc = FCrc::MemCrc32(OutBytes.GetData() + HeaderSize, OutBytes.Num() - HeaderSize);
+	Writer.Seek(sizeof(uint32) + sizeof(uint16));
+	Writer << BodyCrc;
+}
+
+bool UProgressionSaveSubsystem::DeserializeSaveData(const TArray<uint8>& Bytes, FProgressionSaveData& OutData)
+{
+	using namespace ProgressionSave;
+
+	if (Bytes.Num() < HeaderSize)
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	uint32 MagicValue = 0;
+	uint16 VersionValue = 0;
+	uint32 BodyCrc = 0;
+	Reader << MagicValue << VersionValue << BodyCrc;
+
+	if (MagicValue != Magic || VersionValue > Version)
+	{
+		return false;
+	}
+
+	if (BodyCrc != FCrc::MemCrc32(Bytes.GetData() + HeaderSize, Bytes.Num() - HeaderSize))
+	{
+		return false;
+	}
+
+	// Read the chunks we know, skip the ones we don't
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint16 TagValue = 0;
+		uint32 ChunkSize = 0;
+		Reader << TagValue << ChunkSize;
+
+		const int64 ChunkEnd = Reader.Tell() + ChunkSize;
+
+		if (ChunkEnd > Reader.TotalSize())
+		{
+			return false;
+		}
+
+		switch (static_cast<EChunk>(TagValue))
+		{
+		case EChunk::Points:
+			Reader << OutData.AvailablePoints;
+			break;
+
+		case EChunk::Skills:
+		{
+			Reader << OutData.SkillTableHash << OutData.NumSkills;
+			Reader << OutData.UnlockedSkillWords;
+
+			int32 NumIDs = 0;
+			Reader << NumIDs;
+
+			if (NumIDs < 0 || NumIDs > static_cast<int32>(ChunkSize))
+			{
+				return false;
+			}
+
+			OutData.UnlockedSkillIDs.Reset(NumIDs);
+
+			for (int32 Index = 0; Index < NumIDs && !Reader.IsError(); ++Index)
+			{
+				FString SkillName;
+				Reader << SkillName;
+				OutData.UnlockedSkillIDs.Add(FName(*SkillName));
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		Reader.Seek(ChunkEnd);
+	}
+
+	return !Reader.IsError();
+}
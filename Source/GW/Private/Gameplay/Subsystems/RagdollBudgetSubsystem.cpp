@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/RagdollBudgetSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ragdolls Active"), STAT_GW_RagdollsActive, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ragdolls Asleep or Frozen"), STAT_GW_RagdollsFrozen, STATGROUP_GW);
+
+URagdollBudgetSubsystem* URagdollBudgetSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<URagdollBudgetSubsystem>() : nullptr;
+}
+
+bool URagdollBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URagdollBudgetSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, RagdollBudget);
+
+	Super::Tick(DeltaTime);
+
+	// Settling is slow, so it doesn't need checking every frame
+	TimeSinceCheck += DeltaTime;
+
+	if (TimeSinceCheck < CheckInterval)
+	{
+		return;
+	}
+
+	TimeSinceCheck = 0.0f;
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (int32 Index = Ragdolls.Num() - 1; Index >= 0; --Index)
+	{
+		FRagdollBudgetEntry& Entry = Ragdolls[Index];
+		USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+
+		// Forget meshes that were destroyed
+		if (!IsValid(Mesh))
+		{
+			if (Entry.State == ERagdollBudgetState::Active)
+			{
+				--NumActive;
+			}
+
+			Ragdolls.RemoveAt(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Entry.State == ERagdollBudgetState::Frozen)
+		{
+			continue;
+		}
+
+		// Sleeping ragdolls have already given up their slot, so freeze them right away
+		if (Entry.State == ERagdollBudgetState::Sleeping)
+		{
+			FreezeRagdoll(Entry);
+			continue;
+		}
+
+		// Freeze active ragdolls once they've come to rest, or if they've simulated for too long
+		const float SimulationTime = CurrentTime - Entry.StartTime;
+
+		if (SimulationTime >= MaxSimulationTime || (SimulationTime >= MinSimulationTime && !Mesh->IsAnyRigidBodyAwake()))
+		{
+			FreezeRagdoll(Entry);
+		}
+	}
+
+	UpdateStats();
+}
+
+TStatId URagdollBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URagdollBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void URagdollBudgetSubsystem::RequestRagdoll(USkeletalMeshComponent* Mesh)
+{
+	if (!IsValid(Mesh))
+	{
+		return;
+	}
+
+	// Drop any previous entry for this mesh
+	ReleaseRagdoll(Mesh);
+
+	// Make room by putting the oldest active ragdoll to sleep
+	if (NumActive >= MaxActiveRagdolls)
+	{
+		for (FRagdollBudgetEntry& Entry : Ragdolls)
+		{
+			if (Entry.State == ERagdollBudgetState::Active)
+			{
+				SleepRagdoll(Entry);
+				break;
+			}
+		}
+	}
+
+	// Start simulating
+	Mesh->SetSimulatePhysics(true);
+
+	FRagdollBudgetEntry& NewEntry = Ragdolls.AddDefaulted_GetRef();
+	NewEntry.Mesh = Mesh;
+	NewEntry.StartTime = GetWorld()->GetTimeSeconds();
+	NewEntry.State = ERagdollBudgetState::Active;
+
+	++NumActive;
+
+	UpdateStats();
+}
+
+void URagdollBudgetSubsystem::ReleaseRagdoll(USkeletalMeshComponent* Mesh)
+{
+	const int32 Index = Ragdolls.IndexOfByPredicate([Mesh](const FRagdollBudgetEntry& Entry) { return Entry.Mesh == Mesh; });
+
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FRagdollBudgetEntry& Entry = Ragdolls[Index];
+
+	if (Entry.State == ERagdollBudgetState::Active)
+	{
+		--NumActive;
+	}
+
+	// Undo the freeze so the mesh animates and collides again
+	if (Entry.State == ERagdollBudgetState::Frozen && IsValid(Mesh))
+	{
+		Mesh->bNoSkeletonUpdate = false;
+		Mesh->SetComponentTickEnabled(true);
+		Mesh->SetCollisionEnabled(Entry.CollisionBeforeFreeze);
+	}
+
+	// Keep the list ordered by age
+	Ragdolls.RemoveAt(Index, 1, EAllowShrinking::No);
+
+	UpdateStats();
+}
+
+void URagdollBudgetSubsystem::SleepRagdoll(FRagdollBudgetEntry& Entry)
+{
+	if (USkeletalMeshComponent* Mesh = Entry.Mesh.Get())
+	{
+		Mesh->PutAllRigidBodiesToSleep();
+	}
+
+	Entry.State = ERagdollBudgetState::Sleeping;
+	--NumActive;
+}
+
+void URagdollBudgetSubsystem::FreezeRagdoll(FRagdollBudgetEntry& Entry)
+{
+	USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+
+	if (Entry.State == ERagdollBudgetState::Active)
+	{
+		--NumActive;
+	}
+
+	Entry.State = ERagdollBudgetState::Frozen;
+
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// Stop refreshing bones first, so turning physics off keeps the last simulated pose instead of snapping back to the animation
+	Mesh->bNoSkeletonUpdate = true;
+	Mesh->SetSimulatePhysics(false);
+
+	// A frozen corpse doesn't need to tick or be in the physics scene
+	Entry.CollisionBeforeFreeze = Mesh->GetCollisionEnabled();
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Mesh->SetComponentTickEnabled(false);
+}
+
+void URagdollBudgetSubsystem::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GW_RagdollsActive, NumActive);
+	SET_DWORD_STAT(STAT_GW_RagdollsFrozen, Ragdolls.Num() - NumActive);
+}
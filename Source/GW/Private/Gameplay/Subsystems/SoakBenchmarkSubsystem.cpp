@@ -0,0 +1,588 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/SoakBenchmarkSubsystem.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "Gameplay/Characters/Player_Base.h"
+#include "Gameplay/Components/HealthComponent.h"
+#include "Variant_Combat/AI/CombatEnemy.h"
+#include "Algo/Accumulate.h"
+#include "GameFramework/Controller.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/UObjectGlobals.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+USoakBenchmarkSubsystem* USoakBenchmarkSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<USoakBenchmarkSubsystem>() : nullptr;
+}
+
+bool USoakBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USoakBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!FParse::Param(FCommandLine::Get(), TEXT("GWSoak")))
+	{
+		return;
+	}
+
+	// Command line overrides for the config defaults
+	int32 NumEnemies = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakEnemies="), NumEnemies);
+
+	float DurationMinutes = 0.0f;
+	FParse::Value(FCommandLine::Get(), TEXT("SoakMinutes="), DurationMinutes);
+
+	FParse::Value(FCommandLine::Get(), TEXT("SoakFPS="), FixedFrameRate);
+
+	TSubclassOf<APawn> EnemyClass;
+	FString EnemyClassPath;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("SoakEnemyClass="), EnemyClassPath))
+	{
+		EnemyClass = TSoftClassPtr<APawn>(FSoftObjectPath(EnemyClassPath)).LoadSynchronous();
+	}
+
+	bExitWhenDone = true;
+
+	if (!StartRun(EnemyClass, NumEnemies, DurationMinutes))
+	{
+		FPlatformMisc::RequestExit(false, TEXT("SoakBenchmark"));
+	}
+}
+
+void USoakBenchmarkSubsystem::Deinitialize()
+{
+	StopRun();
+
+	Super::Deinitialize();
+}
+
+void USoakBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	Super::Tick(DeltaTime);
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	// Measure the real frame time, since the game's delta is fixed for the run
+	const double NowSeconds = FPlatformTime::Seconds();
+
+	if (LastFrameSeconds > 0.0)
+	{
+		const float FrameMs = static_cast<float>((NowSeconds - LastFrameSeconds) * 1000.0);
+		SampleFrameTimes.Add(FrameMs);
+		RunFrameTimes.Add(FrameMs);
+	}
+
+	LastFrameSeconds = NowSeconds;
+
+	RunTime += DeltaTime;
+	TimeSinceSample += DeltaTime;
+
+	// Keep the crowd around the player and keep the player fighting
+	APlayer_Base* Player = GetPlayer();
+
+	TopUpEnemies(Player ? Player->GetActorLocation() : FVector::ZeroVector);
+
+	if (Player)
+	{
+		DrivePlayer(Player, DeltaTime);
+	}
+
+	if (TimeSinceSample >= SampleInterval)
+	{
+		WriteSample();
+	}
+
+	if (RunTime >= RunDuration)
+	{
+		StopRun();
+	}
+}
+
+TStatId USoakBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USoakBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+bool USoakBenchmarkSubsystem::StartRun(TSubclassOf<APawn> EnemyClass, int32 NumEnemies, float DurationMinutes)
+{
+	if (bRunning)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Soak benchmark is already running"));
+		return false;
+	}
+
+	// Fall back on the config defaults for anything not given
+	if (!EnemyClass)
+	{
+		EnemyClass = DefaultEnemyClass.LoadSynchronous();
+	}
+
+	if (!EnemyClass)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Soak benchmark has no enemy class. Set DefaultEnemyClass or pass one in"));
+		return false;
+	}
+
+	ActiveEnemyClass = EnemyClass;
+	TargetEnemies = NumEnemies > 0 ? NumEnemies : DefaultNumEnemies;
+	RunDuration = (DurationMinutes > 0.0f ? DurationMinutes : DefaultDurationMinutes) * 60.0f;
+	RunTime = 0.0f;
+	TimeSinceSample = 0.0f;
+	TimeToAttack = AttackInterval;
+	TimeToThrow = ThrowInterval;
+	AimTime = -1.0f;
+	LastFrameSeconds = 0.0;
+	RunMaxGCPause = 0.0f;
+	RunGCCount = 0;
+	RunRespawns = 0;
+
+	Enemies.Reset(TargetEnemies);
+	SampleFrameTimes.Reset();
+	RunFrameTimes.Reset();
+	SampleGCPauses.Reset();
+
+	// Run at a fixed timestep so results are comparable between machines and runs
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(1.0f, FixedFrameRate));
+
+	PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &USoakBenchmarkSubsystem::OnPreGarbageCollect);
+	PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &USoakBenchmarkSubsystem::OnPostGarbageCollect);
+
+	// Start the CSV with its header
+	const FString RunName = FString::Printf(TEXT("Soak_%s_%d"), *FDateTime::Now().ToString(), TargetEnemies);
+	CsvPath = FPaths::ProfilingDir() / TEXT("Soak") / RunName + TEXT(".csv");
+
+	FFileHelper::SaveStringToFile(
+		TEXT("Time,Frames,AvgMs,P50Ms,P95Ms,P99Ms,MaxMs,Actors,Enemies,EnemiesAlive,Respawns,HealthEntries,GCCount,GCMaxMs,UsedPhysicalMB,PeakPhysicalMB,UsedVirtualMB,PeakVirtualMB\n"),
+		*CsvPath);
+
+#if CSV_PROFILER
+	// Capture per-subsystem times next to our own CSV
+	bStartedCsvCapture = !FCsvProfiler::Get()->IsCapturing();
+
+	if (bStartedCsvCapture)
+	{
+		FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("Soak"), RunName + TEXT("_Profiler.csv"));
+	}
+#endif
+
+	bRunning = true;
+
+	UE_LOG(LogGW, Log, TEXT("Soak benchmark started: %d x %s for %.1f minutes at %.0f fps. Writing to %s"),
+		TargetEnemies, *EnemyClass->GetName(), RunDuration / 60.0f, FixedFrameRate, *CsvPath);
+
+	return true;
+}
+
+void USoakBenchmarkSubsystem::StopRun()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	bRunning = false;
+
+	// Don't leave the player stuck aiming
+	if (AimTime >= 0.0f)
+	{
+		if (APlayer_Base* Player = GetPlayer())
+		{
+			Player->ScriptedSetAiming(false);
+		}
+
+		AimTime = -1.0f;
+	}
+
+	// Flush what's left of the last sample, then the whole run
+	if (SampleFrameTimes.Num() > 0)
+	{
+		WriteSample();
+	}
+
+	const FString Summary = FString::Printf(TEXT("Total,%d,%.3f,%.3f,%.3f,%.3f,%.3f,,,,%d,,%d,%.3f,,,,\n"),
+		RunFrameTimes.Num(),
+		RunFrameTimes.Num() > 0 ? Algo::Accumulate(RunFrameTimes, 0.0f) / RunFrameTimes.Num() : 0.0f,
+		GetPercentile(RunFrameTimes, 0.5f),
+		GetPercentile(RunFrameTimes, 0.95f),
+		GetPercentile(RunFrameTimes, 0.99f),
+		GetPercentile(RunFrameTimes, 1.0f),
+		RunRespawns,
+		RunGCCount,
+		RunMaxGCPause);
+
+	FFileHelper::SaveStringToFile(Summary, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	UE_LOG(LogGW, Log, TEXT("Soak benchmark finished: %d frames, p50 %.2f ms, p99 %.2f ms, %d GCs (max %.2f ms). Results in %s"),
+		RunFrameTimes.Num(), GetPercentile(RunFrameTimes, 0.5f), GetPercentile(RunFrameTimes, 0.99f), RunGCCount, RunMaxGCPause, *CsvPath);
+
+#if CSV_PROFILER
+	if (bStartedCsvCapture)
+	{
+		FCsvProfiler::Get()->EndCapture();
+		bStartedCsvCapture = false;
+	}
+#endif
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	// Clean up the crowd
+	for (const TWeakObjectPtr<APawn>& Enemy : Enemies)
+	{
+		if (APawn* Pawn = Enemy.Get())
+		{
+			if (AController* Controller = Pawn->GetController())
+			{
+				Controller->Destroy();
+			}
+
+			Pawn->Destroy();
+		}
+	}
+
+	Enemies.Reset();
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false, TEXT("SoakBenchmark"));
+	}
+}
+
+void USoakBenchmarkSubsystem::TopUpEnemies(const FVector& Center)
+{
+	// Forget enemies that died, went back to a pool or were removed from the level, so they're replaced
+	const int32 NumRemoved = Enemies.RemoveAll([](const TWeakObjectPtr<APawn>& Enemy) { return !IsEnemyAlive(Enemy.Get()); });
+	RunRespawns += NumRemoved;
+
+	const int32 NumToSpawn = FMath::Min(TargetEnemies - Enemies.Num(), MaxSpawnsPerFrame);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < NumToSpawn; ++Index)
+	{
+		// Pick a spot on a ring around the player
+		const float Angle = FMath::FRandRange(0.0f, UE_TWO_PI);
+		const float Distance = FMath::FRandRange(SpawnRadiusMin, FMath::Max(SpawnRadiusMin, SpawnRadiusMax));
+		const FVector Location = Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.0f);
+		const FRotator Rotation = (Center - Location).Rotation();
+
+		APawn* Enemy = GetWorld()->SpawnActor<APawn>(ActiveEnemyClass, Location, FRotator(0.0f, Rotation.Yaw, 0.0f), SpawnParams);
+
+		if (!Enemy)
+		{
+			continue;
+		}
+
+		// Enemies placed in the level get their AI on their own, spawned ones might not
+		if (!Enemy->GetController())
+		{
+			Enemy->SpawnDefaultController();
+		}
+
+		Enemies.Add(Enemy);
+	}
+}
+
+void USoakBenchmarkSubsystem::DrivePlayer(APlayer_Base* Player, float DeltaTime)
+{
+	// Don't let the run end early because the player died
+	if (bKeepPlayerAlive)
+	{
+		if (UHealthStoreSubsystem* HealthStore = UHealthStoreSubsystem::Get(this))
+		{
+			if (const UHealthComponent* Health = Player->GetHealthComponent())
+			{
+				HealthStore->ResetEntry(Health->GetHealthHandle());
+			}
+		}
+	}
+
+	TimeToAttack -= DeltaTime;
+	TimeToThrow -= DeltaTime;
+
+	// Throw over several frames like a player would: let the aim settle, throw, then hold the aim until the
+	// throw notify has sent the axe along it
+	if (AimTime >= 0.0f)
+	{
+		const float PreviousAimTime = AimTime;
+		AimTime += DeltaTime;
+
+		if (PreviousAimTime < AimHoldTime && AimTime >= AimHoldTime)
+		{
+			Player->ScriptedThrowAxe();
+		}
+		else if (AimTime >= AimHoldTime * 2.0f)
+		{
+			Player->ScriptedSetAiming(false);
+			AimTime = -1.0f;
+		}
+
+		return;
+	}
+
+	if (TimeToAttack > 0.0f && TimeToThrow > 0.0f)
+	{
+		return;
+	}
+
+	// Face the nearest enemy before attacking
+	const FVector PlayerLocation = Player->GetActorLocation();
+	const APawn* Target = nullptr;
+	float TargetDistanceSquared = TNumericLimits<float>::Max();
+
+	for (const TWeakObjectPtr<APawn>& Enemy : Enemies)
+	{
+		if (const APawn* Pawn = Enemy.Get())
+		{
+			const float DistanceSquared = FVector::DistSquared(PlayerLocation, Pawn->GetActorLocation());
+
+			if (DistanceSquared < TargetDistanceSquared)
+			{
+				Target = Pawn;
+				TargetDistanceSquared = DistanceSquared;
+			}
+		}
+	}
+
+	if (Target)
+	{
+		const FRotator Facing(0.0f, (Target->GetActorLocation() - PlayerLocation).Rotation().Yaw, 0.0f);
+		Player->SetActorRotation(Facing);
+
+		if (AController* Controller = Player->GetController())
+		{
+			Controller->SetControlRotation(Facing);
+		}
+	}
+
+	if (TimeToThrow <= 0.0f)
+	{
+		TimeToThrow = ThrowInterval;
+
+		if (Player->IsAxeThrown())
+		{
+			Player->ScriptedRecallAxe();
+		}
+		else
+		{
+			Player->ScriptedSetAiming(true);
+			AimTime = 0.0f;
+		}
+	}
+	else if (TimeToAttack <= 0.0f)
+	{
+		TimeToAttack = AttackInterval;
+		Player->ScriptedMeleeAttack();
+	}
+}
+
+APlayer_Base* USoakBenchmarkSubsystem::GetPlayer() const
+{
+	if (UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this))
+	{
+		if (const FPlayerInfo* Info = PlayerInfo->GetPlayer(0))
+		{
+			return Cast<APlayer_Base>(Info->Pawn);
+		}
+	}
+
+	return nullptr;
+}
+
+void USoakBenchmarkSubsystem::WriteSample()
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	constexpr double BytesToMB = 1.0 / (1024.0 * 1024.0);
+
+	float MaxGCPause = 0.0f;
+
+	for (const float Pause : SampleGCPauses)
+	{
+		MaxGCPause = FMath::Max(MaxGCPause, Pause);
+	}
+
+	const UHealthStoreSubsystem* HealthStore = UHealthStoreSubsystem::Get(this);
+
+	const FString Row = FString::Printf(TEXT("%.2f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%d,%d,%d,%.3f,%.1f,%.1f,%.1f,%.1f\n"),
+		RunTime,
+		SampleFrameTimes.Num(),
+		SampleFrameTimes.Num() > 0 ? Algo::Accumulate(SampleFrameTimes, 0.0f) / SampleFrameTimes.Num() : 0.0f,
+		GetPercentile(SampleFrameTimes, 0.5f),
+		GetPercentile(SampleFrameTimes, 0.95f),
+		GetPercentile(SampleFrameTimes, 0.99f),
+		GetPercentile(SampleFrameTimes, 1.0f),
+		GetWorld()->GetActorCount(),
+		Enemies.Num(),
+		CountLivingEnemies(),
+		RunRespawns,
+		HealthStore ? HealthStore->GetNumEntries() : 0,
+		SampleGCPauses.Num(),
+		MaxGCPause,
+		MemoryStats.UsedPhysical * BytesToMB,
+		MemoryStats.PeakUsedPhysical * BytesToMB,
+		MemoryStats.UsedVirtual * BytesToMB,
+		MemoryStats.PeakUsedVirtual * BytesToMB);
+
+	FFileHelper::SaveStringToFile(Row, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	SampleFrameTimes.Reset();
+	SampleGCPauses.Reset();
+	TimeSinceSample = 0.0f;
+}
+
+int32 USoakBenchmarkSubsystem::CountLivingEnemies() const
+{
+	int32 NumAlive = 0;
+
+	for (const TWeakObjectPtr<APawn>& Enemy : Enemies)
+	{
+		NumAlive += IsEnemyAlive(Enemy.Get()) ? 1 : 0;
+	}
+
+	return NumAlive;
+}
+
+bool USoakBenchmarkSubsystem::IsEnemyAlive(const APawn* Enemy)
+{
+	if (!IsValid(Enemy))
+	{
+		return false;
+	}
+
+	if (const ACombatEnemy* CombatEnemy = Cast<ACombatEnemy>(Enemy))
+	{
+		// Pooled enemies stay in the level, hidden, while they wait to be reused
+		return !CombatEnemy->IsDead() && !(CombatEnemy->IsPooled() && CombatEnemy->IsHidden());
+	}
+
+	if (const AGWCharacter* Character = Cast<AGWCharacter>(Enemy))
+	{
+		const UHealthComponent* Health = Character->GetHealthComponent();
+		return !Health || Health->GetCurrentHealth() > 0.0f;
+	}
+
+	return true;
+}
+
+FString USoakBenchmarkSubsystem::GetAutomationMapName() const
+{
+	if (!AutomationMap.IsNull())
+	{
+		return AutomationMap.GetLongPackageName();
+	}
+
+	FString DefaultMap;
+	GConfig->GetString(TEXT("/Script/EngineSettings.GameMapsSettings"), TEXT("GameDefaultMap"), DefaultMap, GEngineIni);
+
+	// The setting is an object path, but maps are opened by package name
+	return FPackageName::ObjectPathToPackageName(DefaultMap);
+}
+
+float USoakBenchmarkSubsystem::GetPercentile(TArray<float>& Values, float Percentile)
+{
+	if (Values.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	Values.Sort();
+
+	const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+	return Values[Index];
+}
+
+void USoakBenchmarkSubsystem::OnPreGarbageCollect()
+{
+	GCStartSeconds = FPlatformTime::Seconds();
+}
+
+void USoakBenchmarkSubsystem::OnPostGarbageCollect()
+{
+	if (GCStartSeconds <= 0.0)
+	{
+		return;
+	}
+
+	const float PauseMs = static_cast<float>((FPlatformTime::Seconds() - GCStartSeconds) * 1000.0);
+	GCStartSeconds = 0.0;
+
+	SampleGCPauses.Add(PauseMs);
+	RunMaxGCPause = FMath::Max(RunMaxGCPause, PauseMs);
+	++RunGCCount;
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ *  Starts a soak benchmark run in the current world.
+ *  Usage: GW.Soak.Start [NumEnemies] [Minutes] [EnemyClassPath]
+ */
+static void StartSoakBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	USoakBenchmarkSubsystem* Soak = USoakBenchmarkSubsystem::Get(World);
+
+	if (!Soak)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Soak benchmark needs a game world"));
+		return;
+	}
+
+	// Anything not given falls back on the config defaults
+	const int32 NumEnemies = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0;
+	const float Minutes = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 0.0f;
+	const TSubclassOf<APawn> EnemyClass = Args.Num() > 2 ? TSoftClassPtr<APawn>(FSoftObjectPath(Args[2])).LoadSynchronous() : nullptr;
+
+	Soak->StartRun(EnemyClass, NumEnemies, Minutes);
+}
+
+/** Stops the soak benchmark run in the current world */
+static void StopSoakBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (USoakBenchmarkSubsystem* Soak = USoakBenchmarkSubsystem::Get(World))
+	{
+		Soak->StopRun();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GSoakBenchmarkStartCommand(
+	TEXT("GW.Soak.Start"),
+	TEXT("Starts the large battle soak benchmark. Args: [NumEnemies] [Minutes] [EnemyClassPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartSoakBenchmark));
+
+static FAutoConsoleCommandWithWorldAndArgs GSoakBenchmarkStopCommand(
+	TEXT("GW.Soak.Stop"),
+	TEXT("Stops the soak benchmark and writes its summary"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StopSoakBenchmark));
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,473 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "GW.h"
+
+namespace TickAudit
+{
+	/** Native tick time of one class */
+	struct FNativeTiming
+	{
+		uint64 Cycles = 0;
+		int64 Calls = 0;
+	};
+
+	/** Native tick times recorded by GW_TICK_AUDIT_SCOPE, shared by every world. Game thread only */
+	TMap<const UClass*, FNativeTiming> NativeTimings;
+
+	/** Number of worlds running an audit */
+	int32 NumRunningAudits = 0;
+}
+
+FTickAuditScope::FTickAuditScope(const UObject* Object)
+{
+	if (UTickAuditSubsystem::IsAuditRunning() && Object)
+	{
+		Class = Object->GetClass();
+		StartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+FTickAuditScope::~FTickAuditScope()
+{
+	if (Class)
+	{
+		UTickAuditSubsystem::RecordNativeTick(Class, FPlatformTime::Cycles64() - StartCycles);
+	}
+}
+
+UTickAuditSubsystem* UTickAuditSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UTickAuditSubsystem>() : nullptr;
+}
+
+bool UTickAuditSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	return Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+bool UTickAuditSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTickAuditSubsystem::Deinitialize()
+{
+	if (bAuditRunning)
+	{
+		StopAudit();
+	}
+
+	Super::Deinitialize();
+}
+
+void UTickAuditSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bAuditRunning)
+	{
+		return;
+	}
+
+	SampleTicks();
+
+	AuditTime += DeltaTime;
+	++NumFrames;
+
+	if (TimeRemaining >= 0.0f)
+	{
+		TimeRemaining -= DeltaTime;
+
+		if (TimeRemaining <= 0.0f)
+		{
+			StopAudit();
+		}
+	}
+}
+
+TStatId UTickAuditSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTickAuditSubsystem, STATGROUP_Tickables);
+}
+
+void UTickAuditSubsystem::StartAudit(float Duration)
+{
+	if (bAuditRunning)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Tick audit is already running"));
+		return;
+	}
+
+	bAuditRunning = true;
+	TimeRemaining = Duration > 0.0f ? Duration : -1.0f;
+	AuditTime = 0.0f;
+	NumFrames = 0;
+	AuditedTicks.Reset();
+	AuditedOwners.Reset();
+
+	// Native timings are shared, so only the first audit clears them
+	if (TickAudit::NumRunningAudits++ == 0)
+	{
+		TickAudit::NativeTimings.Reset();
+	}
+
+	UWorld* World = GetWorld();
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AddActor(*It);
+	}
+
+	// Pick up actors spawned while the audit runs, e.g. enemy waves
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UTickAuditSubsystem::AddActor));
+
+	UE_LOG(LogGW, Log, TEXT("Tick audit started on %d GW tick functions%s"), AuditedTicks.Num(),
+		Duration > 0.0f ? *FString::Printf(TEXT(" for %.1f s"), Duration) : TEXT(""));
+}
+
+void UTickAuditSubsystem::StopAudit()
+{
+	if (!bAuditRunning)
+	{
+		return;
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	ActorSpawnedHandle.Reset();
+
+	WriteReport();
+
+	bAuditRunning = false;
+	--TickAudit::NumRunningAudits;
+
+	AuditedTicks.Reset();
+	AuditedOwners.Reset();
+}
+
+bool UTickAuditSubsystem::IsAuditRunning()
+{
+	return TickAudit::NumRunningAudits > 0;
+}
+
+void UTickAuditSubsystem::RecordNativeTick(const UClass* Class, uint64 Cycles)
+{
+	TickAudit::FNativeTiming& Timing = TickAudit::NativeTimings.FindOrAdd(Class);
+	Timing.Cycles += Cycles;
+	++Timing.Calls;
+}
+
+void UTickAuditSubsystem::AddActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	if (IsGWClass(Actor->GetClass()) && Actor->PrimaryActorTick.bCanEverTick)
+	{
+		AddTickFunction(Actor, Actor->PrimaryActorTick);
+	}
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component && IsGWClass(Component->GetClass()) && Component->PrimaryComponentTick.bCanEverTick)
+		{
+			AddTickFunction(Component, Component->PrimaryComponentTick);
+		}
+	}
+}
+
+void UTickAuditSubsystem::AddTickFunction(UObject* Owner, FTickFunction& TickFunction)
+{
+	bool bAlreadyAudited = false;
+	AuditedOwners.Add(Owner, &bAlreadyAudited);
+
+	if (bAlreadyAudited)
+	{
+		return;
+	}
+
+	FAuditedTick& Audited = AuditedTicks.AddDefaulted_GetRef();
+	Audited.Owner = Owner;
+	Audited.Class = Owner->GetClass();
+	Audited.TickFunction = &TickFunction;
+	Audited.LastTickTime = TickFunction.GetLastTickGameTimeSeconds();
+	Audited.bHasState = GetOwnerState(Owner, Audited.LastState);
+	Audited.Movement = FindOwnerMovement(Owner);
+	Audited.bWasMoving = Audited.Movement.IsValid() && !Audited.Movement->Velocity.IsNearlyZero();
+}
+
+void UTickAuditSubsystem::SampleTicks()
+{
+	for (FAuditedTick& Audited : AuditedTicks)
+	{
+		const UObject* Owner = Audited.Owner.Get();
+
+		if (!Owner)
+		{
+			continue;
+		}
+
+		const float LastTickTime = Audited.TickFunction->GetLastTickGameTimeSeconds();
+
+		if (LastTickTime != Audited.LastTickTime)
+		{
+			Audited.LastTickTime = LastTickTime;
+			++Audited.Calls;
+		}
+
+		if (!Audited.bEverEnabled)
+		{
+			Audited.bEverEnabled = Audited.TickFunction->IsTickFunctionRegistered() && Audited.TickFunction->IsTickFunctionEnabled();
+		}
+
+		if (Audited.bHasState && !Audited.bStateChanged)
+		{
+			const UMovementComponent* Movement = Audited.Movement.Get();
+			const bool bMoving = Movement && !Movement->Velocity.IsNearlyZero();
+
+			FTransform State;
+			GetOwnerState(Owner, State);
+
+			if (!State.Equals(Audited.LastState, 0.01))
+			{
+				// Movement components move characters whether or not their own tick does anything, so a change
+				// while one was moving only counts for the movement
+				if (bMoving || Audited.bWasMoving)
+				{
+					Audited.bMovedByMovement = true;
+				}
+				else
+				{
+					Audited.bStateChanged = true;
+				}
+
+				Audited.LastState = State;
+			}
+
+			Audited.bWasMoving = bMoving;
+		}
+	}
+}
+
+void UTickAuditSubsystem::WriteReport() const
+{
+	/** Results for one class */
+	struct FClassReport
+	{
+		int32 Instances = 0;
+		int32 Registered = 0;
+		int32 Enabled = 0;
+		int32 EverEnabled = 0;
+		int32 Idle = 0;
+		int32 MovementOnly = 0;
+		int64 Calls = 0;
+		TickAudit::FNativeTiming Native;
+	};
+
+	TMap<const UClass*, FClassReport> Reports;
+	int32 TotalRegistered = 0;
+	int32 TotalEnabled = 0;
+
+	for (const FAuditedTick& Audited : AuditedTicks)
+	{
+		FClassReport& Report = Reports.FindOrAdd(Audited.Class);
+		++Report.Instances;
+		Report.Calls += Audited.Calls;
+		Report.EverEnabled += Audited.bEverEnabled ? 1 : 0;
+
+		// Ticks that ran but never moved their owner themselves are doing nothing we can see
+		if (Audited.Calls > 0 && Audited.bHasState && !Audited.bStateChanged)
+		{
+			++Report.Idle;
+			Report.MovementOnly += Audited.bMovedByMovement ? 1 : 0;
+		}
+
+		if (Audited.Owner.IsValid())
+		{
+			const bool bRegistered = Audited.TickFunction->IsTickFunctionRegistered();
+			const bool bEnabled = bRegistered && Audited.TickFunction->IsTickFunctionEnabled();
+
+			Report.Registered += bRegistered ? 1 : 0;
+			Report.Enabled += bEnabled ? 1 : 0;
+			TotalRegistered += bRegistered ? 1 : 0;
+			TotalEnabled += bEnabled ? 1 : 0;
+		}
+	}
+
+	// Subsystems and other tickables only show up through their native timings
+	for (const TPair<const UClass*, TickAudit::FNativeTiming>& Pair : TickAudit::NativeTimings)
+	{
+		Reports.FindOrAdd(Pair.Key).Native = Pair.Value;
+	}
+
+	Reports.ValueSort([](const FClassReport& A, const FClassReport& B)
+	{
+		return A.Native.Cycles != B.Native.Cycles ? A.Native.Cycles > B.Native.Cycles : A.Calls > B.Calls;
+	});
+
+	const FString ReportName = FString::Printf(TEXT("TickAudit_%s"), *FDateTime::Now().ToString());
+	const FString CsvPath = FPaths::ProfilingDir() / TEXT("TickAudit") / ReportName + TEXT(".csv");
+
+	FString Csv = TEXT("Class,Instances,Registered,Enabled,EverEnabled,Calls,CallsPerFrame,NativeMs,NativeUsPerCall,IdleTicks,MovementOnlyTicks,Flag\n");
+	int32 NumFlagged = 0;
+
+	UE_LOG(LogGW, Log, TEXT("Tick audit: %.1f s, %d frames, %d GW tick functions registered, %d enabled"), AuditTime, NumFrames, TotalRegistered, TotalEnabled);
+
+	for (const TPair<const UClass*, FClassReport>& Pair : Reports)
+	{
+		const FClassReport& Report = Pair.Value;
+		const double NativeMs = FPlatformTime::ToMilliseconds64(Report.Native.Cycles);
+		const double NativeUsPerCall = Report.Native.Calls > 0 ? NativeMs * 1000.0 / Report.Native.Calls : 0.0;
+		const double CallsPerFrame = NumFrames > 0 ? static_cast<double>(Report.Calls) / NumFrames : 0.0;
+
+		// Flag classes that never changed their owners, and ones that were enabled without ticking.
+		// Ticks that were disabled for the whole audit are on demand ticks that had no reason to run
+		const TCHAR* Flag = TEXT("");
+
+		if (Report.Calls > 0 && Report.Idle == Report.Instances)
+		{
+			Flag = TEXT("NoStateChange");
+		}
+		else if (Report.EverEnabled > 0 && Report.Calls == 0 && Report.Native.Calls == 0)
+		{
+			Flag = TEXT("NeverTicked");
+		}
+
+		NumFlagged += *Flag ? 1 : 0;
+
+		Csv += FString::Printf(TEXT("%s,%d,%d,%d,%d,%lld,%.3f,%.3f,%.3f,%d,%d,%s\n"), *GetNameSafe(Pair.Key), Report.Instances, Report.Registered,
+			Report.Enabled, Report.EverEnabled, Report.Calls, CallsPerFrame, NativeMs, NativeUsPerCall, Report.Idle, Report.MovementOnly, Flag);
+
+		UE_LOG(LogGW, Log, TEXT("  %-40s %4d inst %4d reg %4d on %8lld calls %9.3f ms %8.3f us/call %s"), *GetNameSafe(Pair.Key), Report.Instances,
+			Report.Registered, Report.Enabled, Report.Calls, NativeMs, NativeUsPerCall, Flag);
+	}
+
+	FFileHelper::SaveStringToFile(Csv, *CsvPath);
+
+	UE_LOG(LogGW, Log, TEXT("Tick audit finished: %d classes flagged. Results in %s"), NumFlagged, *CsvPath);
+
+	if (NumFlagged > 0)
+	{
+		UE_LOG(LogGW, Log, TEXT("Flags are heuristics. NoStateChange only means the owner's transform never changed other than through its movement component, so check the tick's code before removing it"));
+	}
+}
+
+bool UTickAuditSubsystem::IsGWClass(const UClass* Class)
+{
+	static const FName GWPackageName(TEXT("/Script/GW"));
+
+	// Blueprints count as the native class they're based on
+	while (Class && !Class->HasAnyClassFlags(CLASS_Native))
+	{
+		Class = Class->GetSuperClass();
+	}
+
+	return Class && Class->GetPackage()->GetFName() == GWPackageName;
+}
+
+bool UTickAuditSubsystem::GetOwnerState(const UObject* Owner, FTransform& OutState)
+{
+	if (const AActor* Actor = Cast<AActor>(Owner))
+	{
+		OutState = Actor->GetActorTransform();
+		return true;
+	}
+
+	if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Owner))
+	{
+		OutState = SceneComponent->GetComponentTransform();
+		return true;
+	}
+
+	return false;
+}
+
+const UMovementComponent* UTickAuditSubsystem::FindOwnerMovement(const UObject* Owner)
+{
+	// A movement component's own moves are its tick's work
+	if (Owner->IsA<UMovementComponent>())
+	{
+		return nullptr;
+	}
+
+	const AActor* Actor = Cast<AActor>(Owner);
+
+	if (!Actor)
+	{
+		const UActorComponent* Component = Cast<UActorComponent>(Owner);
+		Actor = Component ? Component->GetOwner() : nullptr;
+	}
+
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	const APawn* Pawn = Cast<APawn>(Actor);
+	const UMovementComponent* Movement = Pawn ? Pawn->GetMovementComponent() : Actor->FindComponentByClass<UMovementComponent>();
+
+	return Movement && Movement->UpdatedComponent ? Movement : nullptr;
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ *  Starts a tick audit in the current world.
+ *  Usage: GW.TickAudit.Start [Seconds]
+ */
+static void StartTickAudit(const TArray<FString>& Args, UWorld* World)
+{
+	UTickAuditSubsystem* TickAuditSubsystem = UTickAuditSubsystem::Get(World);
+
+	if (!TickAuditSubsystem)
+	{
+		UE_LOG(LogGW, Warning, TEXT("Tick audit needs a game world"));
+		return;
+	}
+
+	TickAuditSubsystem->StartAudit(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 10.0f);
+}
+
+/** Stops the tick audit in the current world and writes its report */
+static void StopTickAudit(const TArray<FString>& Args, UWorld* World)
+{
+	if (UTickAuditSubsystem* TickAuditSubsystem = UTickAuditSubsystem::Get(World))
+	{
+		TickAuditSubsystem->StopAudit();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GTickAuditStartCommand(
+	TEXT("GW.TickAudit.Start"),
+	TEXT("Audits every GW tick function and writes a report. Args: [Seconds], 0 runs until GW.TickAudit.Stop"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartTickAudit));
+
+static FAutoConsoleCommandWithWorldAndArgs GTickAuditStopCommand(
+	TEXT("GW.TickAudit.Stop"),
+	TEXT("Stops the tick audit and writes its report"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StopTickAudit));
+
+#endif // !UE_BUILD_SHIPPING
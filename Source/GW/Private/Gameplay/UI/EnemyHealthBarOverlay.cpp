@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/UI/EnemyHealthBarOverlay.h"
+#include "Gameplay/Subsystems/EnemyHealthBarSubsystem.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Rendering/DrawElements.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Health Bars Registered"), STAT_GW_HealthBarsRegistered, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Health Bars Drawn"), STAT_GW_HealthBarsDrawn, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Enemy Health Bars Project"), STAT_GW_HealthBarsProject, STATGROUP_GW);
+
+void UEnemyHealthBarOverlay::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// The overlay covers the whole screen, so it must never eat clicks
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void UEnemyHealthBarOverlay::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_GW_HealthBarsProject);
+
+	VisiblePositions.Reset();
+	VisiblePercents.Reset();
+
+	APlayerController* PC = GetOwningPlayer();
+	UEnemyHealthBarSubsystem* Subsystem = UEnemyHealthBarSubsystem::Get(this);
+
+	if (!PC || !PC->PlayerCameraManager || !Subsystem)
+	{
+		return;
+	}
+
+	const TArray<TObjectPtr<AActor>>& Owners = Subsystem->GetOwners();
+	const TArray<float>& Percents = Subsystem->GetHealthPercents();
+	const TArray<float>& Heights = Subsystem->GetHeightOffsets();
+
+	const FVector CameraLocation = PC->PlayerCameraManager->GetCameraLocation();
+	const float MaxDistanceSquared = FMath::Square(MaxDrawDistance);
+
+	// Projection returns viewport pixels, the paint pass works in DPI scaled slate units
+	const float ViewportScale = UWidgetLayoutLibrary::GetViewportScale(this);
+	const float InvViewportScale = ViewportScale > 0.0f ? 1.0f / ViewportScale : 1.0f;
+
+	for (int32 Index = 0; Index < Owners.Num(); ++Index)
+	{
+		const AActor* Owner = Owners[Index];
+
+		if (!IsValid(Owner))
+		{
+			continue;
+		}
+
+		const FVector BarLocation = Owner->GetActorLocation() + FVector(0.0f, 0.0f, Heights[Index]);
+
+		// Cheapest tests first: distance, then whether the owner was on screen last frame
+		if (FVector::DistSquared(CameraLocation, BarLocation) > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		if (!Owner->WasRecentlyRendered(RecentlyRenderedTolerance))
+		{
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+
+		if (!PC->ProjectWorldLocationToScreen(BarLocation, ScreenPosition, true))
+		{
+			continue;
+		}
+
+		VisiblePositions.Add(FVector2f(ScreenPosition * InvViewportScale));
+		VisiblePercents.Add(Percents[Index]);
+	}
+
+	SET_DWORD_STAT(STAT_GW_HealthBarsRegistered, Owners.Num());
+	SET_DWORD_STAT(STAT_GW_HealthBarsDrawn, VisiblePositions.Num());
+}
+
+int32 UEnemyHealthBarOverlay::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	if (VisiblePositions.IsEmpty())
+	{
+		return LayerId;
+	}
+
+	const FVector2f Size(BarSize);
+	const FVector2f HalfSize = Size * 0.5f;
+
+	// All backgrounds share one layer and all fills the next, so slate can batch each layer into a single draw
+	const int32 BackgroundLayer = LayerId + 1;
+	const int32 FillLayer = LayerId + 2;
+
+	for (int32 Index = 0; Index < VisiblePositions.Num(); ++Index)
+	{
+		const FVector2f TopLeft = VisiblePositions[Index] - HalfSize;
+
+		FSlateDrawElement::MakeBox(OutDrawElements, BackgroundLayer, AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TopLeft)), &BarBrush, ESlateDrawEffect::None, BackgroundColor);
+
+		const float Percent = VisiblePercents[Index];
+
+		if (Percent > 0.0f)
+		{
+			const FVector2f FillSize(Size.X * Percent, Size.Y);
+			FSlateDrawElement::MakeBox(OutDrawElements, FillLayer, AllottedGeometry.ToPaintGeometry(FillSize, FSlateLayoutTransform(TopLeft)), &BarBrush, ESlateDrawEffect::None, FillColor);
+		}
+	}
+
+	return FillLayer;
+}
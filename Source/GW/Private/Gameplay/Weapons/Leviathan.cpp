@@ -8,6 +8,7 @@
 #include "Components/TimelineComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Gameplay/Characters/Player_Base.h"
+#include "Gameplay/Components/DamageModifierComponent.h"
 #include "Gameplay/Characters/Enemy/Enemy_Base.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -248,6 +249,12 @@ void ALeviathan::AdjustAxeReturnLocation()
 	SetActorLocation(NewLocation);
 }
 
+float ALeviathan::GetThrowingDamage() const
+{
+	const UDamageModifierComponent* DamageModifiers = PlayerRef ? PlayerRef->GetDamageModifierComponent() : nullptr;
+	return DamageModifiers ? DamageModifiers->ModifyOutgoingDamage(ThrowingDamage) : ThrowingDamage;
+}
+
 void ALeviathan::ReturnAxe()
 {
 	AxeState = EAxeState::Returning;
@@ -395,7 +402,7 @@ void ALeviathan::UpdateAxeThrowTrace(float Value)
 			FVector NormalizedDirection = DirectionVector.GetSafeNormal(0.0001f);
 			FVector ImpactVector = NormalizedDirection * ImpulseStrength;
 
-			HitEnemyRef->ApplyDamage(ThrowingDamage, this, ImpactLocation, ImpactVector);
+			HitEnemyRef->ApplyDamage(GetThrowingDamage(), this, ImpactLocation, ImpactVector);
 			FAttachmentTransformRules AttachRules(
 				EAttachmentRule::KeepWorld,
 				EAttachmentRule::KeepWorld,
@@ -570,7 +577,7 @@ void ALeviathan::UpdateAxeTraceReturn(float Value)
 			FVector NormalizedDirection = DirectionVector.GetSafeNormal(0.0001f);
 			FVector ImpactVector = NormalizedDirection * ImpulseStrength;
 
-			HitEnemyRef->ApplyDamage(ThrowingDamage, this, ImpactLocation, ImpactVector);
+			HitEnemyRef->ApplyDamage(GetThrowingDamage(), this, ImpactLocation, ImpactVector);
 			FAttachmentTransformRules AttachRules(
 				EAttachmentRule::KeepWorld,
 				EAttachmentRule::KeepWorld,
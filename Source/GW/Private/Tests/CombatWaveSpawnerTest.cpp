@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CombatWaveSpawnerTestActors.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCombatWaveSpawnerFrameBudgetTest, "GW.Combat.WaveSpawner.FrameBudget",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ *  Spawns a 100 enemy wave with the default pooling and checks the frame budget splits it over frames as predicted.
+ *  Each spawn is charged a fixed cost on the spawner's budget clock instead of wall time, so the results don't depend
+ *  on how loaded the machine is. Runs in its own empty game world, so it works headless under -nullrhi
+ */
+bool FCombatWaveSpawnerFrameBudgetTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 EnemyCount = 100;
+	constexpr int32 NumSpawnPoints = 20;
+	constexpr float FrameBudgetMs = 1.0f;
+	constexpr double SpawnCostMs = 0.3;
+	constexpr float DeltaTime = 1.0f / 60.0f;
+	constexpr int32 MaxFrames = 1000;
+
+	// create an empty game world and begin play in it
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CombatWaveSpawnerTest"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->SetGameMode(FURL());
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	// spawn the spawner, setting up its wave before it begins play
+	ACombatWaveSpawnerTestSpawner* Spawner = World->SpawnActorDeferred<ACombatWaveSpawnerTestSpawner>(ACombatWaveSpawnerTestSpawner::StaticClass(), FTransform::Identity);
+
+	if (TestNotNull(TEXT("Spawner"), Spawner))
+	{
+		Spawner->FakeSpawnCostMs = SpawnCostMs;
+		Spawner->SetupWave(ACombatWaveSpawnerTestEnemy::StaticClass(), EnemyCount, NumSpawnPoints, FrameBudgetMs);
+		Spawner->FinishSpawning(FTransform::Identity);
+
+		// the predictor lets spawns through while they fit in the budget
+		const int32 MaxSpawnsPerFrame = FMath::FloorToInt32(FrameBudgetMs / SpawnCostMs);
+
+		// tick until the wave is out, counting the spawns in each frame
+		int32 NumFrames = 0;
+		int32 PeakSpawnsPerFrame = 0;
+
+		while (Spawner->IsSpawning() && NumFrames < MaxFrames)
+		{
+			const int32 LeftBefore = Spawner->GetEnemiesLeftToSpawn();
+
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++NumFrames;
+
+			const int32 SpawnsThisFrame = LeftBefore - Spawner->GetEnemiesLeftToSpawn();
+			PeakSpawnsPerFrame = FMath::Max(PeakSpawnsPerFrame, SpawnsThisFrame);
+
+			if (!TestTrue(FString::Printf(TEXT("Frame %d spawned %d enemies, between 1 and %d"), NumFrames, SpawnsThisFrame, MaxSpawnsPerFrame),
+				SpawnsThisFrame >= 1 && SpawnsThisFrame <= MaxSpawnsPerFrame))
+			{
+				break;
+			}
+		}
+
+		TestFalse(TEXT("Wave finished spawning"), Spawner->IsSpawning());
+		TestEqual(TEXT("Enemies spawned"), Spawner->GetEnemiesAlive(), EnemyCount);
+		TestEqual(TEXT("Frames the wave was spread over"), NumFrames, FMath::DivideAndRoundUp(EnemyCount, MaxSpawnsPerFrame));
+		TestTrue(FString::Printf(TEXT("Peak frame cost %.3f ms is within the %.3f ms budget"), Spawner->GetPeakFrameCostMs(), Spawner->GetFrameBudgetMs()),
+			Spawner->GetPeakFrameCostMs() <= Spawner->GetFrameBudgetMs());
+
+		AddInfo(FString::Printf(TEXT("Spawned %d enemies over %d frames, at most %d per frame"), Spawner->GetEnemiesAlive(), NumFrames, PeakSpawnsPerFrame));
+	}
+
+	// tear the world down
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
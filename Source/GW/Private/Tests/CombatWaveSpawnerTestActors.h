@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CombatEnemy.h"
+#include "CombatWaveSpawner.h"
+#include "CombatWaveSpawnerTestActors.generated.h"
+
+/**
+ *  Combat enemy without an AI Controller, so the wave spawner tests don't need any content
+ */
+UCLASS(NotPlaceable, HideDropdown, Transient)
+class ACombatWaveSpawnerTestEnemy : public ACombatEnemy
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	ACombatWaveSpawnerTestEnemy(const FObjectInitializer& ObjectInitializer)
+		: Super(ObjectInitializer)
+	{
+		// only spawning is being tested, so don't spawn an AI Controller or StateTree, including when reused from the pool
+		AutoPossessAI = EAutoPossessAI::Disabled;
+		AIControllerClass = nullptr;
+	}
+};
+
+/**
+ *  Wave spawner the tests can set up from code.
+ *  Its budget clock only moves by a fixed cost per spawn, so how many enemies fit in a frame doesn't depend on the machine
+ */
+UCLASS(NotPlaceable, HideDropdown, Transient)
+class ACombatWaveSpawnerTestSpawner : public ACombatWaveSpawner
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Budget clock time each spawn or pre-warm takes */
+	double FakeSpawnCostMs = 0.3;
+
+	/** Budget clock, in seconds */
+	double FakeClockSeconds = 0.0;
+
+	/** Sets up a single wave that starts spawning on BeginPlay. Call before the spawner finishes spawning */
+	void SetupWave(TSubclassOf<ACombatEnemy> EnemyClass, int32 EnemyCount, int32 NumSpawnPoints, float InFrameBudgetMs)
+	{
+		FCombatEnemyWave& Wave = Waves.AddDefaulted_GetRef();
+		Wave.EnemyClass = EnemyClass;
+		Wave.EnemyCount = EnemyCount;
+		Wave.StartDelay = 0.0f;
+
+		// lay the spawn points out on a grid so they don't overlap
+		SpawnPoints.Reset(NumSpawnPoints);
+
+		for (int32 Index = 0; Index < NumSpawnPoints; ++Index)
+		{
+			SpawnPoints.Add(FTransform(FVector((Index % 10) * 200.0f, (Index / 10) * 200.0f, 0.0f)));
+		}
+
+		bShouldSpawnEnemiesImmediately = true;
+		FrameBudgetMs = InFrameBudgetMs;
+		SpawnPointCooldown = 0.0f;
+	}
+
+	/** Returns true while the current wave still has enemies to spawn */
+	bool IsSpawning() const { return EnemiesLeftToSpawn > 0; }
+
+	/** Returns the number of enemies from the current wave that are alive */
+	int32 GetEnemiesAlive() const { return EnemiesAlive; }
+
+	/** Returns the number of enemies from the current wave still waiting to be spawned */
+	int32 GetEnemiesLeftToSpawn() const { return EnemiesLeftToSpawn; }
+
+	/** Returns the frame budget */
+	float GetFrameBudgetMs() const { return FrameBudgetMs; }
+
+protected:
+
+	virtual bool SpawnNextEnemy() override
+	{
+		return AdvanceClock(Super::SpawnNextEnemy());
+	}
+
+	virtual bool WarmNextEnemy() override
+	{
+		return AdvanceClock(Super::WarmNextEnemy());
+	}
+
+	virtual double GetBudgetClockSeconds() const override
+	{
+		return FakeClockSeconds;
+	}
+
+	/** Charges the fixed cost to the budget clock if something was spawned */
+	bool AdvanceClock(bool bSpawned)
+	{
+		if (bSpawned)
+		{
+			FakeClockSeconds += FakeSpawnCostMs / 1000.0;
+		}
+
+		return bSpawned;
+	}
+};
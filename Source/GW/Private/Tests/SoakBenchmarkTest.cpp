@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Gameplay/Subsystems/SoakBenchmarkSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Starts a soak run with the config defaults in the game world */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FStartSoakRunCommand, FAutomationTestBase*, Test);
+
+bool FStartSoakRunCommand::Update()
+{
+	USoakBenchmarkSubsystem* Soak = USoakBenchmarkSubsystem::Get(AutomationCommon::GetAnyGameWorld());
+
+	if (Test->TestNotNull(TEXT("Soak benchmark subsystem"), Soak))
+	{
+		Test->TestTrue(TEXT("Soak run started"), Soak->StartRun(nullptr, 0, 0.0f));
+	}
+
+	return true;
+}
+
+/** Waits for the soak run to finish, then checks it wrote its results */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FWaitForSoakRunCommand, FAutomationTestBase*, Test);
+
+bool FWaitForSoakRunCommand::Update()
+{
+	const USoakBenchmarkSubsystem* Soak = USoakBenchmarkSubsystem::Get(AutomationCommon::GetAnyGameWorld());
+
+	if (Soak && Soak->IsRunning())
+	{
+		return false;
+	}
+
+	// Nothing to check if the run never started, which was already reported
+	if (Soak && !Soak->GetCsvPath().IsEmpty())
+	{
+		FString Results;
+		Test->TestTrue(TEXT("Soak results were written"), FFileHelper::LoadFileToString(Results, *Soak->GetCsvPath()));
+		Test->TestTrue(TEXT("Soak results have a summary row"), Results.Contains(TEXT("\nTotal,")));
+
+		Test->AddInfo(FString::Printf(TEXT("Soak results in %s"), *Soak->GetCsvPath()));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoakBenchmarkLargeBattleTest, "GW.Soak.LargeBattle",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::StressFilter)
+
+/**
+ *  Runs the soak benchmark with its config defaults in the automation map, at a fixed timestep.
+ *  Headless: GW.exe -game -nullrhi -unattended -ExecCmds="Automation RunTests GW.Soak.LargeBattle; Quit"
+ */
+bool FSoakBenchmarkLargeBattleTest::RunTest(const FString& Parameters)
+{
+	const FString MapName = GetDefault<USoakBenchmarkSubsystem>()->GetAutomationMapName();
+
+	if (!TestFalse(TEXT("Soak automation map is set"), MapName.IsEmpty()))
+	{
+		return false;
+	}
+
+	AutomationOpenMap(MapName);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FStartSoakRunCommand(this));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitForSoakRunCommand(this));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
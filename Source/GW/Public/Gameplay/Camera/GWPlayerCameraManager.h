@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GWPlayerCameraManager.generated.h"
+
+class USpringArmComponent;
+
+/**
+ *  Camera modes, in priority order. Higher modes override lower ones while they're on the stack
+ */
+UENUM(BlueprintType)
+enum class EPlayerCameraMode : uint8
+{
+	/** Default over-the-shoulder view. Always at the bottom of the stack */
+	Idle,
+
+	/** Closer view while aiming the axe throw */
+	Aim,
+
+	/** Short kick when the axe is caught. Added on top of the mode below it */
+	CatchKick,
+
+	/** View of the dead player */
+	Death
+};
+
+/**
+ *  Camera boom placement for one camera mode
+ */
+USTRUCT(BlueprintType)
+struct FPlayerCameraModeSettings
+{
+	GENERATED_BODY()
+
+	/** Boom length. Added to the mode below for additive modes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode", meta = (Units = "cm"))
+	float ArmLength = 150.0f;
+
+	/** Boom socket offset. Added to the mode below for additive modes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode")
+	FVector SocketOffset = FVector(20.0f, 50.0f, 60.0f);
+
+	/** Spring smoothing time used when the mode becomes the top of the stack, or the stack changes below it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode", meta = (ClampMin = 0.01, ClampMax = 5, Units = "s"))
+	float BlendInTime = 0.2f;
+
+	/** Spring smoothing time used when the mode is popped off the top of the stack */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode", meta = (ClampMin = 0.01, ClampMax = 5, Units = "s"))
+	float BlendOutTime = 0.2f;
+
+	/** The mode pops itself after this long. Zero keeps it until it's popped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float Duration = 0.0f;
+
+	/** If true, the arm length and socket offset are added to the mode below instead of replacing it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Mode")
+	bool bAdditive = false;
+};
+
+/**
+ *  Player camera manager that places the player's camera boom from a stack of camera modes.
+ *  Gameplay code pushes and pops modes (aim, catch kick, death) instead of driving the boom itself.
+ *  Once per frame the stack is folded into one target arm length and socket offset, in priority order,
+ *  and the boom is moved towards it with critically damped springs, so mode changes blend smoothly
+ *  even when they interrupt each other, and the boom is written exactly once per frame.
+ *  Blend times come from the mode at the top of the stack, so modes pushed or popped underneath it
+ *  don't change how fast it blends. Death mode pops itself once the player's pawn is alive again.
+ */
+UCLASS()
+class GW_API AGWPlayerCameraManager : public APlayerCameraManager
+{
+	GENERATED_BODY()
+
+	/** A mode on the stack */
+	struct FActiveCameraMode
+	{
+		EPlayerCameraMode Mode;
+
+		/** Time left before the mode pops itself. Negative for modes without a duration */
+		float TimeRemaining;
+	};
+
+	/** Pushed modes, sorted by priority. Idle is implied below them */
+	TArray<FActiveCameraMode> ModeStack;
+
+	/** Boom being driven */
+	TWeakObjectPtr<USpringArmComponent> CameraBoom;
+
+	/** Spring state for the arm length */
+	float ArmLength = 0.0f;
+	float ArmLengthRate = 0.0f;
+
+	/** Spring state for the socket offset */
+	FVector SocketOffset = FVector::ZeroVector;
+	FVector SocketOffsetRate = FVector::ZeroVector;
+
+	/** Smoothing time of the current blend, from the settings of the mode at the top of the stack */
+	float SmoothingTime = 0.2f;
+
+	/** If true, the springs jump to the target on the next update */
+	bool bSnapToTarget = true;
+
+protected:
+
+	/** Default over-the-shoulder view */
+	UPROPERTY(EditAnywhere, Category = "Camera Modes")
+	FPlayerCameraModeSettings IdleMode;
+
+	/** Axe aiming view */
+	UPROPERTY(EditAnywhere, Category = "Camera Modes")
+	FPlayerCameraModeSettings AimMode;
+
+	/** Kick added when the axe is caught */
+	UPROPERTY(EditAnywhere, Category = "Camera Modes")
+	FPlayerCameraModeSettings CatchKickMode;
+
+	/** Dead player view */
+	UPROPERTY(EditAnywhere, Category = "Camera Modes")
+	FPlayerCameraModeSettings DeathMode;
+
+public:
+
+	/** Sets up the default mode settings */
+	AGWPlayerCameraManager();
+
+	/** Evaluates the mode stack and moves the camera boom, then updates the camera */
+	virtual void UpdateCamera(float DeltaTime) override;
+
+	/** Sets the boom the mode stack drives. The springs start from the current mode */
+	void SetCameraBoom(USpringArmComponent* InCameraBoom);
+
+	/** Pushes a mode. Pushing a mode that's already on the stack restarts its duration */
+	UFUNCTION(BlueprintCallable, Category = "Camera Modes")
+	void PushCameraMode(EPlayerCameraMode Mode);
+
+	/** Pops a mode, wherever it is on the stack */
+	UFUNCTION(BlueprintCallable, Category = "Camera Modes")
+	void PopCameraMode(EPlayerCameraMode Mode);
+
+	/** Pops every mode, back to idle */
+	UFUNCTION(BlueprintCallable, Category = "Camera Modes")
+	void ResetCameraModes();
+
+	/** Returns true if the mode is on the stack */
+	UFUNCTION(BlueprintPure, Category = "Camera Modes")
+	bool HasCameraMode(EPlayerCameraMode Mode) const;
+
+	/** Returns the settings for a mode */
+	const FPlayerCameraModeSettings& GetModeSettings(EPlayerCameraMode Mode) const;
+
+protected:
+
+	/** Returns the settings for the mode at the top of the stack */
+	const FPlayerCameraModeSettings& GetTopModeSettings() const;
+
+	/** Returns true if the player's pawn has health and is alive, e.g. after a respawn in place */
+	bool IsPawnAlive() const;
+
+	/** Ticks mode durations, folds the stack into a target and moves the springs towards it */
+	void EvaluateCameraModes(float DeltaTime);
+};
@@ -8,12 +8,8 @@
 #include "GWCharacter.h"
 #include "Enemy_Base.generated.h"
 
-class UWidgetComponent;
-class UUserWidget;
-class AHealOrb;
-
 /**
- * Enemy base class with 3D widget health bar
+ * Enemy base class. Its health bar is drawn by the HUD's enemy health bar overlay
  */
 UCLASS()
 class GW_API AEnemy_Base : public AGWCharacter, public ICombatDamageable, public ICombatAttacker
@@ -25,25 +21,25 @@ public:
 
 protected:
 
-	/** Health bar widget component displayed above the character */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
-	UWidgetComponent* HealthBarComponent;
+	/** Height above the character to draw the health bar at */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI", meta = (ClampMin = 0, Units = "cm"))
+	float HealthBarHeight = 100.0f;
 
-	/** Widget class to use for the health bar */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "UI")
-	TSubclassOf<UUserWidget> HealthWidgetClass;
+	/** Number of heal orbs to drop on death. Orbs are simulated and drawn by the orb simulation subsystem */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot")
+	int32 HealOrbCount = 3;
 
-	/** Reference to the health bar widget instance */
-	UPROPERTY()
-	UUserWidget* HealthWidget;
+	/** Health each dropped heal orb restores */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot")
+	float HealOrbAmount = 20.0f;
 
-	/** Heal orb class to spawn on death */
+	/** Number of rage orbs to drop on death */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot")
-	TSubclassOf<AHealOrb> HealOrbClass;
+	int32 RageOrbCount = 1;
 
-	/** Number of heal orbs to spawn on death */
+	/** Rage each dropped rage orb gives */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Loot")
-	int32 HealOrbCount = 3;
+	float RageOrbAmount = 10.0f;
 
 	/** Time before destroying actor after death */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Death")
@@ -56,6 +52,11 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Pushes the health percentage to the health bar overlay as well as Blueprint */
+	virtual void UpdateHealthBar() override;
+
 	/** Destroys the actor after death timer */
 	void RemoveFromWorld();
 
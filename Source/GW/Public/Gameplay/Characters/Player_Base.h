@@ -10,10 +10,11 @@
 
 class UHealthComponent;
 class ALeviathan;
-class UTimelineComponent;
-class UCurveFloat;
 class UPlayerProgressionComponent;
 class UCombatComponent;
+class URageComponent;
+class AGWPlayerCameraManager;
+enum class EPlayerCameraMode : uint8;
 /**
  * 
  */
@@ -41,24 +42,6 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera)
 	FVector TargetArmLength;
 
-	UPROPERTY()
-	UTimelineComponent* AimTimeline;
-
-	UPROPERTY()
-	UTimelineComponent* DesiredSocketTimeline;
-
-	UPROPERTY()
-	UTimelineComponent* RangedCameraTl;
-	
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Timeline")
-	UCurveFloat* AimCurve;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Timeline")
-	UCurveFloat* DesireSocketCurve;
-
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Timeline")
-	UCurveFloat* RangedCameraCurve;
-	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapons", meta = (AllowPrivateAccess = "true"))
 	UChildActorComponent* LeviathanAxe;
 
@@ -73,6 +56,10 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
 	UCombatComponent* CombatComponent;
 
+	// Rage meter component
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	URageComponent* RageComponent;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
 	bool bUserControllerRotation;
 
@@ -80,19 +67,31 @@ public:
 	bool bRangedAttackMode = false;
 
 public:
-	APlayer_Base();
-	
-	UFUNCTION()
-	void UpdateAim(float Value);
-
-	UFUNCTION()
-	void UpdateDesireSocket(float Value);
+	APlayer_Base(const FObjectInitializer& ObjectInitializer);
 
 	void Catch();
 	
 	UFUNCTION()
 	ALeviathan* GetLeviathanAxe() const { return LeviathanRef; }
 
+	/** Returns the rage meter */
+	URageComponent* GetRageComponent() const { return RageComponent; }
+
+	/** Starts a melee attack without input, for scripted play such as the soak benchmark */
+	void ScriptedMeleeAttack();
+
+	/** Starts or stops aiming without input. For scripted play such as the soak benchmark */
+	void ScriptedSetAiming(bool bAiming);
+
+	/** Throws the axe without input. Only works while aiming, and the axe leaves on the throw montage notify */
+	void ScriptedThrowAxe();
+
+	/** Recalls a thrown axe without input */
+	void ScriptedRecallAxe();
+
+	/** Returns true while the axe is out of the player's hand */
+	bool IsAxeThrown() const { return bAxeThrown; }
+
 	// ========== ICombatAttacker 인터페이스 구현 ==========
 
 	virtual void DoAttackTrace(FName DamageSourceBone) override;
@@ -121,25 +120,49 @@ protected:
 
 	void ReturnAxe();
 
-	UFUNCTION()
-	void OnThrowNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload);
+	/** Native handler for one end of a montage notify */
+	using FMontageNotifyHandler = void (APlayer_Base::*)(const FBranchingPointNotifyPayload&);
 
-	UFUNCTION()
-	void OnThrowNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointNotifyPayload);
+	/** Handlers for the begin and end of a montage notify. Either may be null */
+	struct FMontageNotifyHandlers
+	{
+		FMontageNotifyHandler Begin = nullptr;
+		FMontageNotifyHandler End = nullptr;
+	};
+
+	/** Montage notify handlers by notify name, built in BeginPlay */
+	TMap<FName, FMontageNotifyHandlers> MontageNotifyHandlers;
+
+	/** Maps a montage notify name to its handlers. Call before or during BeginPlay */
+	void RegisterMontageNotify(FName NotifyName, FMontageNotifyHandler Begin, FMontageNotifyHandler End);
 
+	/** Looks up the notify and calls its begin handler */
 	UFUNCTION()
-	void OnCatchNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
+	void DispatchMontageNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
 
+	/** Looks up the notify and calls its end handler */
 	UFUNCTION()
-	void OnCatchNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
+	void DispatchMontageNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
+
+	void OnThrowNotifyBegin(const FBranchingPointNotifyPayload& BranchingPointPayload);
+
+	void OnThrowNotifyEnd(const FBranchingPointNotifyPayload& BranchingPointPayload);
+
+	void OnCatchNotifyBegin(const FBranchingPointNotifyPayload& BranchingPointPayload);
+
+	void OnCatchNotifyEnd(const FBranchingPointNotifyPayload& BranchingPointPayload);
 
 	virtual void BeginPlay();
 
-	virtual void Tick(float DeltaTime);
+	/** Hands the camera boom to the new controller's camera manager */
+	virtual void NotifyControllerChanged() override;
+
+	/** Returns the camera manager running the camera mode stack, or null if we're not player controlled */
+	AGWPlayerCameraManager* GetCameraModeManager() const;
+
+	/** Pushes or pops a camera mode, if we have a camera mode manager */
+	void SetCameraMode(EPlayerCameraMode Mode, bool bActive) const;
 
-	UFUNCTION()
-	void LerpCameraPosition(float Value);
-	
 protected:
 	ALeviathan* LeviathanRef = nullptr;
 
@@ -165,21 +188,6 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound")
 	USoundBase* ThrowEffortSound;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Axe Throw", meta = (AllowPrivateAccess = "true"))
-	float SpringArmLengthIdle = 150.0f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Axe Throw", meta = (AllowPrivateAccess = "true"))
-	float SpringArmLengthAim = 120.0f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Axe Throw", meta = (AllowPrivateAccess = "true"))
-	FVector CameraVector = FVector(20.0f, 50.0f, 60.0f);
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Axe Throw", meta = (AllowPrivateAccess = "true"))
-	FVector RangedCameraVector = FVector(30.0f, 40.0f, 65.0f);
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
-	FVector DesiredSocketOffset;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera", meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<UCameraShakeBase> ShakeClass;
 	
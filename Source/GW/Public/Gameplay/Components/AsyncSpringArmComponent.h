@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "WorldCollision.h"
+#include "AsyncSpringArmComponent.generated.h"
+
+// Spring arm whose collision probe runs as an async sweep instead of a blocking one.
+// Each frame the arm uses the sweep issued last frame, smoothed towards where the blocking geometry
+// is heading, so it pulls in quickly and eases back out without popping.
+// While the camera is still and the last hit was static geometry, the hit is reused instead of sweeping again.
+// Probe counts can be viewed with "stat GW"
+UCLASS(ClassGroup=(Camera), meta=(BlueprintSpawnableComponent))
+class GW_API UAsyncSpringArmComponent : public USpringArmComponent
+{
+	GENERATED_BODY()
+
+protected:
+	// If false, the arm uses the regular blocking probe
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision")
+	bool bAsyncCollisionProbe = true;
+
+	// Smoothing time when geometry pushes the camera in. Keep it short so the camera doesn't clip
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float PullInTime = 0.03f;
+
+	// Smoothing time when the camera moves back out once the geometry is gone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float PushOutTime = 0.3f;
+
+	// How far ahead the hit distance is extrapolated, in frames, to make up for the result being a frame old
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision", meta = (ClampMin = 0, ClampMax = 4))
+	float PredictionFrames = 1.0f;
+
+	// The camera counts as still while the arm moved less than this since the last probe
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision", meta = (ClampMin = 0, ClampMax = 50, Units = "cm"))
+	float StillTolerance = 1.0f;
+
+	// Longest a static hit is reused before probing again, so moving objects are still picked up
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera Collision", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float MaxStaticHitAge = 0.25f;
+
+	// Moves the arm, probing asynchronously if enabled
+	virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
+
+	// Reads last frame's probe, if it finished. Returns true if there was a new result
+	bool ConsumeProbeResult();
+
+	// Starts the probe for this frame's arm
+	void IssueProbe(const FVector& Origin, const FVector& DesiredLocation);
+
+	// Returns true if the arm barely moved since the last probe and the last probe hit static geometry
+	bool CanReuseStaticHit(const FVector& Origin, const FVector& DesiredLocation) const;
+
+private:
+	// Probe issued last frame
+	FTraceHandle ProbeHandle;
+
+	// Arm the last result was probed along
+	FVector ProbeOrigin = FVector::ZeroVector;
+	FVector ProbeEnd = FVector::ZeroVector;
+
+	// Distance along the arm to the blocking hit in the last two results. UE_BIG_NUMBER if nothing was hit
+	float HitDistance = UE_BIG_NUMBER;
+	float PreviousHitDistance = UE_BIG_NUMBER;
+
+	// Fraction of the arm the camera sits at, and its rate of change
+	float ArmFraction = 1.0f;
+	float ArmFractionRate = 0.0f;
+
+	// True if the last result hit static geometry
+	bool bStaticHit = false;
+
+	// Time since the last result came in
+	float HitAge = 0.0f;
+};
@@ -9,6 +9,8 @@
 
 class APlayer_Base;
 class UPlayerProgressionComponent;
+class URageComponent;
+class UDamageModifierComponent;
 class ALeviathan;
 class UAnimInstance;
 
@@ -33,6 +35,14 @@ protected:
 	UPROPERTY()
 	UPlayerProgressionComponent* ProgressionComp;
 
+	// Rage meter, raises damage and combo tempo in rage mode
+	UPROPERTY()
+	URageComponent* RageComp;
+
+	// Buffs and passives applied to our damage
+	UPROPERTY()
+	UDamageModifierComponent* DamageModifierComp;
+
 	// ========== 기본 콤보 시스템 ==========
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Combo")
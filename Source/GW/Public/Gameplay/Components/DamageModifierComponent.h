@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Gameplay/Data/DamageModifier.h"
+#include "DamageModifierComponent.generated.h"
+
+// Damage modifiers of a character: buffs, resistances and unlocked passive skills.
+// Modifiers are grouped by source, and compiled into flat arrays of add and multiply terms whenever a source
+// is added or removed. Modifying damage is then one short loop over the terms, with no lookups per hit
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class GW_API UDamageModifierComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDamageModifierComponent();
+
+protected:
+	virtual void BeginPlay() override;
+
+	// Modifiers we always have, e.g. an enemy's resistances
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage")
+	TArray<FDamageModifier> BaseModifiers;
+
+	// Modifiers from buffs and passive skills, by source
+	TMap<FName, TArray<FDamageModifier>> SourceModifiers;
+
+	// Compiled terms for the damage we deal, in stage order
+	TArray<FDamageTerm> OutgoingTerms;
+
+	// Compiled terms for the damage we take, in stage order
+	TArray<FDamageTerm> IncomingTerms;
+
+public:
+	// Adds or replaces the modifiers from a source, e.g. a buff or a passive skill
+	UFUNCTION(BlueprintCallable, Category = "Damage")
+	void AddModifierSource(FName SourceID, const TArray<FDamageModifier>& Modifiers);
+
+	// Removes the modifiers from a source
+	UFUNCTION(BlueprintCallable, Category = "Damage")
+	void RemoveModifierSource(FName SourceID);
+
+	// Returns true if a source has modifiers on us
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Damage")
+	bool HasModifierSource(FName SourceID) const { return SourceModifiers.Contains(SourceID); }
+
+	// Returns the damage we deal after buffs and passives
+	float ModifyOutgoingDamage(float Damage) const { return ApplyTerms(OutgoingTerms, Damage); }
+
+	// Returns the damage we take after resistances
+	float ModifyIncomingDamage(float Damage) const { return ApplyTerms(IncomingTerms, Damage); }
+
+protected:
+	// Rebuilds the compiled terms from the base and source modifiers
+	void CompileModifiers();
+
+	// Runs damage through compiled terms. Damage never goes negative
+	static float ApplyTerms(const TArray<FDamageTerm>& Terms, float Damage)
+	{
+		for (const FDamageTerm& Term : Terms)
+		{
+			Damage = (Damage + Term.Add) * Term.Multiply;
+		}
+
+		return FMath::Max(Damage, 0.f);
+	}
+};
@@ -4,11 +4,19 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
 #include "HealthComponent.generated.h"
 
 
 class AGWCharacter;
+class UDamageModifierComponent;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHealthComponentChanged, float, CurrentHealth, float, MaxHealth);
+
+// Health of a character. Health lives in the world's health store, and regeneration and damage over time
+// run on the world's health regen scheduler, so the component never ticks.
+// Listeners get at most one OnHealthChanged per frame, however many changes happened in it.
+// Without a health store, e.g. outside game worlds, the component keeps its health itself
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class GW_API UHealthComponent : public UActorComponent
 {
@@ -18,36 +26,79 @@ public:
 	// Sets default values for this component's properties
 	UHealthComponent();
 
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 	void ApplayDamage(float Damage, AActor* DamageCauser, const FVector& DamageLocation, const FVector& DamageImpulse);
 
 	void Death();
 
 	void ApplyHealing(float HealAmount, AActor* Healer);
 
+	// Regenerates health over time. A zero duration lasts until death
 	UFUNCTION(BlueprintCallable, Category = "Health")
-	float GetMaxHealth() const { return MaxHealth; };
+	void StartRegeneration(float HealthPerSecond, float Duration);
+
+	// Deals damage over time. A zero duration lasts until death
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void ApplyDamageOverTime(float DamagePerSecond, float Duration);
+
+	// Called by the health regen scheduler after a step changed our health
+	void HandleHealthOverTime(bool bKilled);
 
 	UFUNCTION(BlueprintCallable, Category = "Health")
-	float GetCurrentHealth() const { return CurrentHealth; };
+	float GetMaxHealth() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	float GetCurrentHealth() const;
+
+	// Returns our entry in the health store
+	const FHealthHandle& GetHealthHandle() const { return HealthHandle; }
+
+	// Called once per frame at most, after health changed
+	UPROPERTY(BlueprintAssignable, Category = "Health")
+	FOnHealthComponentChanged OnHealthChanged;
 	
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+
+	// Releases the health store entry
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	/** Overrides the default TakeDamage functionality */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser);
 
+	// Schedules a notification for the next tick, unless one is already scheduled
+	void MarkHealthChanged();
+
+	// Sends the coalesced notification
+	void BroadcastHealthChanged();
+
 protected:
 	AGWCharacter* OwnerRef;
 
-	float CurrentHealth;
+	// Owner's resistances
+	UPROPERTY(Transient)
+	TObjectPtr<UDamageModifierComponent> DamageModifiers;
+
+	// Health store holding our current health
+	UPROPERTY(Transient)
+	TObjectPtr<UHealthStoreSubsystem> HealthStore;
+
+	// Our entry in the health store
+	FHealthHandle HealthHandle;
+
+	// Current health when there's no health store. Unused otherwise
+	float CurrentHealth = 0.f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health")
 	float MaxHealth = 300.f;
 
+	// Health regenerated per second for as long as we're alive. Zero turns it off
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health", meta = (ClampMin = 0))
+	float PassiveRegenRate = 0.f;
+
+	// True if a notification is already scheduled for the next tick
+	bool bNotifyPending = false;
+
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 };
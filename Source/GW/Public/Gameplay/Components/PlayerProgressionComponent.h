@@ -20,10 +20,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-
-	// 해제된 스킬 목록
-	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Progression")
-	TSet<FName> UnlockedSkills;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// 스킬 데이터 테이블
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Progression")
@@ -33,6 +30,32 @@ protected:
 	UPROPERTY(SaveGame, EditAnywhere, BlueprintReadWrite, Category = "Progression")
 	int32 AvailablePoints;
 
+	// 컴파일된 스킬 목록 - BeginPlay에서 데이터 테이블로부터 한 번 생성
+	UPROPERTY(Transient)
+	TArray<FSkillData> Skills;
+
+	// 스킬 ID -> Skills 인덱스
+	TMap<FName, int32> SkillIndices;
+
+	// 스킬별 선행 스킬 비트셋
+	TArray<TBitArray<>> PrerequisiteMasks;
+
+	// 해제된 스킬 비트셋
+	TBitArray<> UnlockedMask;
+
+	// 스킬 ID 목록의 해시 - 저장된 비트셋이 현재 테이블과 맞는지 확인용
+	uint32 SkillTableHash = 0;
+
+	// 저장 파일을 적용했는지 여부 - 적용 전에는 저장하지 않음 (기존 저장 파일 덮어쓰기 방지)
+	bool bSaveLoaded = false;
+
+	// 저장 로드 완료 이벤트 핸들
+	FDelegateHandle SaveLoadedHandle;
+
+	// 타입별, 무기 상태별 스킬 인덱스
+	TArray<TArray<int32>> SkillIndicesByType;
+	TArray<TArray<int32>> SkillIndicesByWeaponState;
+
 public:
 	// 스킬 해제 여부 확인
 	UFUNCTION(BlueprintCallable, Category = "Progression")
@@ -46,22 +69,48 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Progression")
 	bool UnlockSkill(FName SkillID);
 
-	// 스킬 데이터 가져오기
+	// 스킬 데이터 가져오기 (없으면 빈 데이터)
 	UFUNCTION(BlueprintCallable, Category = "Progression")
-	FSkillData GetSkillData(FName SkillID) const;
+	const FSkillData& GetSkillData(FName SkillID) const;
+
+	// 스킬 데이터 찾기 (없으면 nullptr)
+	const FSkillData* FindSkillData(FName SkillID) const;
 
-	// 모든 스킬 데이터 가져오기
+	// 스킬 인덱스 가져오기 (없으면 INDEX_NONE)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Progression")
+	int32 GetSkillIndex(FName SkillID) const;
+
+	// 인덱스로 스킬 데이터 가져오기 - GetSkillIndex, GetSkillIndicesBy... 결과와 함께 사용 (범위 밖이면 빈 데이터)
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Progression")
+	const FSkillData& GetSkillDataAt(int32 SkillIndex) const;
+
+	// 모든 스킬 데이터 가져오기 - 인덱스는 GetSkillIndex, GetSkillIndicesBy... 와 같음
+	UFUNCTION(BlueprintCallable, Category = "Progression")
+	const TArray<FSkillData>& GetAllSkills() const { return Skills; }
+
+	// 특정 타입의 스킬 인덱스 가져오기
 	UFUNCTION(BlueprintCallable, Category = "Progression")
-	TArray<FSkillData> GetAllSkills() const;
+	const TArray<int32>& GetSkillIndicesByType(ESkillType SkillType) const;
 
-	// 특정 타입의 스킬 가져오기
+	// 특정 무기 상태의 스킬 인덱스 가져오기
+	UFUNCTION(BlueprintCallable, Category = "Progression")
+	const TArray<int32>& GetSkillIndicesByWeaponState(EWeaponState WeaponState) const;
+
+	// 특정 타입의 스킬 가져오기 (복사본 - 기존 블루프린트 호환용, 그 외에는 GetSkillIndicesByType 사용)
 	UFUNCTION(BlueprintCallable, Category = "Progression")
 	TArray<FSkillData> GetSkillsByType(ESkillType SkillType) const;
 
-	// 특정 무기 상태의 스킬 가져오기
+	// 특정 무기 상태의 스킬 가져오기 (복사본 - 기존 블루프린트 호환용, 그 외에는 GetSkillIndicesByWeaponState 사용)
 	UFUNCTION(BlueprintCallable, Category = "Progression")
 	TArray<FSkillData> GetSkillsByWeaponState(EWeaponState WeaponState) const;
 
+	// 해제된 스킬 ID 목록 (저장용)
+	TArray<FName> GetUnlockedSkillIDs() const;
+
+	// 진행 상황 저장 - 게임 스레드에서는 스냅샷만 만들고, 쓰기는 백그라운드에서
+	UFUNCTION(BlueprintCallable, Category = "Progression|Save")
+	void SaveProgression();
+
 	// 포인트 추가
 	UFUNCTION(BlueprintCallable, Category = "Progression")
 	void AddPoints(int32 Points);
@@ -86,6 +135,21 @@ public:
 	FOnPointsChanged OnPointsChanged;
 
 private:
+	// 데이터 테이블을 스킬 목록, 인덱스, 비트셋으로 컴파일
+	void CompileSkills();
+
+	// 인덱스로 스킬 해제 (검사 없음)
+	void UnlockSkillAt(int32 SkillIndex);
+
 	// 초기 스킬 해제 (게임 시작 시 기본 스킬)
 	void UnlockInitialSkills();
+
+	// 패시브 스킬의 데미지 수정자를 소유자에게 적용
+	void ApplyPassiveSkill(const FSkillData& SkillData) const;
+
+	// 모든 패시브 스킬의 데미지 수정자 제거
+	void RemovePassiveSkills() const;
+
+	// 저장 파일 로드가 끝나면 적용
+	void ApplySavedProgression();
 };
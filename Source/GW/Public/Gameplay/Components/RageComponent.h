@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "RageComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnRageChanged, float, RagePercent, bool, bRageActive, float, RageTimeRemaining);
+
+// Rage meter. Rage builds up from rage orbs and melee hits, and once full it can be spent on rage mode,
+// which raises damage and speeds up the combo for a while.
+// Nothing ticks: rage only changes on events, and rage mode ends on a timer.
+// Listeners get at most one OnRageChanged per frame, however many changes happened in it
+UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class GW_API URageComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	URageComponent();
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Rage needed to enter rage mode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage", meta = (ClampMin = 1))
+	float MaxRage = 100.0f;
+
+	// Rage gained for each enemy hit by a melee attack
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage", meta = (ClampMin = 0))
+	float RagePerHit = 2.0f;
+
+	// If true, rage mode starts as soon as the meter is full
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage")
+	bool bActivateWhenFull = true;
+
+	// How long rage mode lasts. The meter drains over this time
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage Mode", meta = (ClampMin = 0.1, Units = "s"))
+	float RageDuration = 10.0f;
+
+	// Damage multiplier while in rage mode, applied as a damage modifier on the owner
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage Mode", meta = (ClampMin = 1))
+	float RageDamageMultiplier = 1.5f;
+
+	// Combo montage play rate while in rage mode
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage Mode", meta = (ClampMin = 1))
+	float RageComboPlayRate = 1.3f;
+
+	// Current rage. Frozen at full while rage mode runs
+	float CurrentRage = 0.0f;
+
+	// True while rage mode runs
+	bool bRageActive = false;
+
+	// World time rage mode ends at
+	float RageEndTime = 0.0f;
+
+	// Ends rage mode
+	FTimerHandle RageTimer;
+
+	// True if a notification is already scheduled for the next tick
+	bool bNotifyPending = false;
+
+public:
+	// Called once per frame at most, after rage or rage mode changed
+	UPROPERTY(BlueprintAssignable, Category = "Rage")
+	FOnRageChanged OnRageChanged;
+
+	// Adds rage. Ignored while rage mode runs
+	UFUNCTION(BlueprintCallable, Category = "Rage")
+	void AddRage(float Amount);
+
+	// Adds the rage for hitting some enemies
+	void AddRageForHits(int32 NumHits) { AddRage(RagePerHit * NumHits); }
+
+	// Starts rage mode if the meter is full. Returns true if it started
+	UFUNCTION(BlueprintCallable, Category = "Rage")
+	bool TryActivateRage();
+
+	// Returns true while rage mode runs
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Rage")
+	bool IsRageActive() const { return bRageActive; }
+
+	// Returns the meter fill, 0-1. Drains with the remaining time while rage mode runs
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Rage")
+	float GetRagePercent() const;
+
+	// Returns the seconds of rage mode left, or 0
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Rage")
+	float GetRageTimeRemaining() const;
+
+	// Returns the play rate for combo montages
+	float GetComboPlayRate() const { return bRageActive ? RageComboPlayRate : 1.0f; }
+
+protected:
+	// Ends rage mode and empties the meter
+	void EndRage();
+
+	// Adds or removes the rage damage buff on the owner
+	void SetRageDamageBuff(bool bEnabled);
+
+	// Schedules a notification for the next tick, unless one is already scheduled
+	void MarkRageChanged();
+
+	// Sends the coalesced notification
+	void BroadcastRageChanged();
+};
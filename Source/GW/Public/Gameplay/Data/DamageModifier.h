@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DamageModifier.generated.h"
+
+UENUM(BlueprintType)
+enum class EDamageModifierScope : uint8
+{
+	Outgoing UMETA(DisplayName = "Outgoing (Buff)"),
+	Incoming UMETA(DisplayName = "Incoming (Resistance)")
+};
+
+UENUM(BlueprintType)
+enum class EDamageModifierOp : uint8
+{
+	Add UMETA(DisplayName = "Add"),
+	Multiply UMETA(DisplayName = "Multiply")
+};
+
+// One damage modifier from a buff, a resistance or a passive skill
+USTRUCT(BlueprintType)
+struct FDamageModifier
+{
+	GENERATED_BODY()
+
+	// Whether this changes the damage we deal, or the damage we take
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Modifier")
+	EDamageModifierScope Scope = EDamageModifierScope::Outgoing;
+
+	// Adds Value to the damage, or multiplies the damage by it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Modifier")
+	EDamageModifierOp Op = EDamageModifierOp::Multiply;
+
+	// Amount added, or multiplier. A resistance of 25% is Multiply 0.75
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Modifier")
+	float Value = 1.f;
+
+	// Modifiers apply in stage order. Within a stage, adds are summed and applied before the multipliers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Modifier")
+	int32 Stage = 0;
+};
+
+// A compiled stage of modifiers: Damage = (Damage + Add) * Multiply
+struct FDamageTerm
+{
+	float Add = 0.f;
+	float Multiply = 1.f;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataTable.h"
+#include "Gameplay/Data/DamageModifier.h"
 #include "SkillData.generated.h"
 
 UENUM(BlueprintType)
@@ -62,6 +63,10 @@ struct FSkillData : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Skill|Combat")
 	float Damage;
 
+	// 데미지 수정자 - 해제되어 있는 동안 적용 (SkillType이 Passive일 때)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Skill|Combat", meta = (EditCondition = "SkillType == ESkillType::Passive", EditConditionHides))
+	TArray<FDamageModifier> DamageModifiers;
+
 	// 콤보 인덱스 (연속 공격에서의 순서)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Skill|Combat", meta = (EditCondition = "SkillType == ESkillType::Combo", EditConditionHides))
 	int32 ComboIndex;
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "HealthUIOwner.generated.h"
+
+/**
+ *  HealthUIOwner interface
+ *  Implemented by actors that show their health on a bar, so health UI updates can be coalesced by the health UI subsystem
+ */
+UINTERFACE(MinimalAPI, NotBlueprintable)
+class UHealthUIOwner : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class IHealthUIOwner
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Pushes the current health to the health UI. Called at most once per UI update, however many times health changed */
+	virtual void FlushHealthUI() = 0;
+};
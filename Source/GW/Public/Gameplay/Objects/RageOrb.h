@@ -6,6 +6,11 @@
 #include "GameFramework/Actor.h"
 #include "RageOrb.generated.h"
 
+/**
+ * Rage orb placed in a level or spawned from Blueprint. Collecting it fills the player's rage meter.
+ * On BeginPlay it hands itself to the orb simulation, which moves, draws and collects it with every other orb,
+ * and then destroys itself. It never ticks
+ */
 UCLASS()
 class GW_API ARageOrb : public AActor
 {
@@ -16,11 +21,15 @@ public:
 	ARageOrb();
 
 protected:
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
+	/** Amount of rage to give */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rage")
+	float RageAmount = 10.0f;
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	/** If true, the orb is launched in a random upward direction like enemy loot. Otherwise it drops straight down */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+	bool bLaunchOnSpawn = true;
 
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
 };
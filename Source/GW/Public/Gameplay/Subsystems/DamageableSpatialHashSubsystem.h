@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Engine/EngineTypes.h"
+#include "DamageableSpatialHashSubsystem.generated.h"
+
+class USceneComponent;
+
+/**
+ *  Packed results of a damageable spatial query.
+ *  Actors and their hashed locations share the same index
+ */
+struct FDamageableQueryResults
+{
+	/** Actors found by the query */
+	TArray<AActor*> Actors;
+
+	/** Location of each actor when it was last hashed */
+	TArray<FVector> Locations;
+
+	/** Clears the results, keeping the allocations for reuse */
+	void Reset()
+	{
+		Actors.Reset();
+		Locations.Reset();
+	}
+
+	/** Returns the number of results */
+	int32 Num() const { return Actors.Num(); }
+};
+
+/**
+ *  Uniform spatial hash of every ICombatDamageable actor in the world.
+ *  Actors are picked up automatically when they spawn and dropped when they're destroyed.
+ *  Each actor is rehashed from its root component's transform updates, and only when it changes cells.
+ *  Radius, cone and capsule queries treat each actor as a sphere of its simple collision radius
+ *  and skip hidden actors, so pooled enemies don't show up.
+ *  Use this instead of physics overlaps for gameplay questions like soft lock targets, area damage and magnetism.
+ *  Registered counts and query times can be viewed with "stat GW". Run "GW.SpatialHash.Benchmark" to compare against physics overlaps
+ */
+UCLASS(Config=Game)
+class GW_API UDamageableSpatialHashSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Hashed actors */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Actors;
+
+	/** Location of each actor when it was last hashed */
+	TArray<FVector> Locations;
+
+	/** Bounding radius of each actor */
+	TArray<float> Radii;
+
+	/** Cell each actor is in */
+	TArray<FIntVector> Cells;
+
+	/** Index of each actor in the packed arrays */
+	TMap<TObjectKey<AActor>, int32> ActorIndices;
+
+	/** Packed indices of the actors in each occupied cell */
+	TMap<FIntVector, TArray<int32>> Grid;
+
+	/** Largest actor radius seen, used to pad query bounds */
+	float MaxActorRadius = 0.0f;
+
+	/** Actor spawned handler */
+	FDelegateHandle ActorSpawnedHandle;
+
+	/** Actor destroyed handler */
+	FDelegateHandle ActorDestroyedHandle;
+
+protected:
+
+	/** Size of each grid cell. Should be around the most common query radius */
+	UPROPERTY(Config, EditAnywhere, Category = "Spatial Hash", meta = (ClampMin = 50, ClampMax = 10000, Units = "cm"))
+	float CellSize = 500.0f;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UDamageableSpatialHashSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Starts listening for spawned and destroyed actors */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Stops listening for spawned and destroyed actors */
+	virtual void Deinitialize() override;
+
+	/** Hashes every damageable placed in the level */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Adds an actor to the hash. Damageable actors are added automatically */
+	void RegisterActor(AActor* Actor);
+
+	/** Removes an actor from the hash. Destroyed actors are removed automatically */
+	void UnregisterActor(AActor* Actor);
+
+	/** Finds actors whose bounds overlap the sphere */
+	void QueryRadius(const FVector& Center, float Radius, FDamageableQueryResults& OutResults, const AActor* IgnoreActor = nullptr) const;
+
+	/** Finds actors whose bounds overlap the cone. The direction must be normalized */
+	void QueryCone(const FVector& Origin, const FVector& Direction, float Length, float HalfAngleDegrees, FDamageableQueryResults& OutResults, const AActor* IgnoreActor = nullptr) const;
+
+	/** Finds actors whose bounds overlap the capsule swept from start to end */
+	void QueryCapsule(const FVector& Start, const FVector& End, float Radius, FDamageableQueryResults& OutResults, const AActor* IgnoreActor = nullptr) const;
+
+	/** Returns the number of hashed actors */
+	int32 GetNumActors() const { return Actors.Num(); }
+
+protected:
+
+	/** Returns the cell containing the location */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Calls the visitor with the index of every actor in the cells overlapping the box */
+	template <typename VisitorType>
+	void ForEachInBox(const FBox& Box, const AActor* IgnoreActor, VisitorType&& Visitor) const;
+
+	/** Moves a packed actor to a new location, changing its cell if needed */
+	void UpdateActorLocation(int32 Index, const FVector& NewLocation);
+
+	/** Adds newly spawned damageables */
+	void OnActorSpawned(AActor* Actor);
+
+	/** Drops destroyed actors */
+	void OnActorDestroyed(AActor* Actor);
+
+	/** Rehashes an actor when its root component moves */
+	void OnRootTransformUpdated(USceneComponent* Component, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
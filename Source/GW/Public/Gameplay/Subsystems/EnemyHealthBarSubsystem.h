@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "EnemyHealthBarSubsystem.generated.h"
+
+class UEnemyHealthBarOverlay;
+class AGameModeBase;
+class APlayerController;
+
+/**
+ *  Per-world registry of enemy health bars.
+ *  Enemies register themselves and push their health percentage when it changes.
+ *  Bars are kept in packed arrays and drawn by a single HUD overlay widget per local player,
+ *  so enemies don't need a widget component of their own.
+ *  The overlay class is loaded once when the world begins play, and an overlay is created for each local player
+ *  then and whenever a local player logs in later, so registering a bar never loads or creates anything.
+ */
+UCLASS(Config=Game)
+class GW_API UEnemyHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Actors that own a health bar */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> Owners;
+
+	/** Health percentage of each bar, 0-1 */
+	TArray<float> HealthPercents;
+
+	/** Height above the owner's location to draw each bar at */
+	TArray<float> HeightOffsets;
+
+	/** Index of each owner in the packed arrays */
+	TMap<TObjectKey<AActor>, int32> OwnerIndices;
+
+	/** Overlay widgets created for local players */
+	UPROPERTY()
+	TArray<TObjectPtr<UEnemyHealthBarOverlay>> Overlays;
+
+	/** Overlay class, loaded when the world begins play */
+	UPROPERTY(Transient)
+	TSubclassOf<UEnemyHealthBarOverlay> LoadedOverlayClass;
+
+	/** Handle for the player login callback */
+	FDelegateHandle PostLoginHandle;
+
+protected:
+
+	/** Overlay widget class created for each local player */
+	UPROPERTY(Config, EditAnywhere, Category = "Health Bars")
+	TSoftClassPtr<UEnemyHealthBarOverlay> OverlayClass;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UEnemyHealthBarSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Loads the overlay class and creates the overlays for the local players */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Stops listening for player logins */
+	virtual void Deinitialize() override;
+
+	/** Adds a health bar for the owner, or updates it if it already has one */
+	void RegisterHealthBar(AActor* Owner, float HeightOffset, float HealthPercent = 1.0f);
+
+	/** Removes the owner's health bar, e.g. when it dies */
+	void UnregisterHealthBar(AActor* Owner);
+
+	/** Updates the owner's health percentage. Does nothing if the owner has no bar */
+	void SetHealthPercent(AActor* Owner, float HealthPercent);
+
+	/** Returns the packed health bar owners */
+	const TArray<TObjectPtr<AActor>>& GetOwners() const { return Owners; }
+
+	/** Returns the packed health percentages */
+	const TArray<float>& GetHealthPercents() const { return HealthPercents; }
+
+	/** Returns the packed height offsets */
+	const TArray<float>& GetHeightOffsets() const { return HeightOffsets; }
+
+protected:
+
+	/** Creates the overlay for a player that logged in after the world began play */
+	void OnPlayerPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	/** Creates the overlay for the player if it's local and doesn't have one yet */
+	void CreateOverlay(APlayerController* PlayerController);
+};
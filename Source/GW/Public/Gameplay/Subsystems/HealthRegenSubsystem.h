@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "HealthRegenSubsystem.generated.h"
+
+class UHealthComponent;
+
+/**
+ *  Runs every health regeneration and damage over time effect in the world.
+ *  Effects are kept in packed arrays and advanced together in one batched step against the health store,
+ *  at a low fixed rate instead of every frame. Health components that were touched by a step are told once
+ *  afterwards, so they can notify listeners and handle deaths.
+ *  Effects on dead entries are paused rather than removed, so passive regeneration comes back with a revive.
+ *  Effect counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class GW_API UHealthRegenSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Health store entry each effect applies to */
+	TArray<FHealthHandle> Handles;
+
+	/** Health per second each effect applies. Negative rates are damage over time */
+	TArray<float> Rates;
+
+	/** Seconds left on each effect. Negative lasts until removed */
+	TArray<float> TimesRemaining;
+
+	/** Health component to tell when each effect changes its health. May be null */
+	TArray<TWeakObjectPtr<UHealthComponent>> Listeners;
+
+	/** Components touched by the current step, and whether the step killed them */
+	TMap<TWeakObjectPtr<UHealthComponent>, bool> TouchedListeners;
+
+	/** Time accumulated since the last step */
+	float TimeSinceStep = 0.0f;
+
+protected:
+
+	/** Number of batched steps per second */
+	UPROPERTY(Config, EditAnywhere, Category = "Health Regeneration", meta = (ClampMin = 1, ClampMax = 60, Units = "Hz"))
+	float StepRate = 4.0f;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UHealthRegenSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Steps every effect at the fixed rate */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds a regeneration effect. A zero or negative duration lasts until removed */
+	void AddRegeneration(const FHealthHandle& Handle, float HealthPerSecond, float Duration, UHealthComponent* Listener = nullptr);
+
+	/** Adds a damage over time effect. A zero or negative duration lasts until removed */
+	void AddDamageOverTime(const FHealthHandle& Handle, float DamagePerSecond, float Duration, UHealthComponent* Listener = nullptr);
+
+	/** Removes every effect on the entry, e.g. when its owner leaves play */
+	void RemoveEffects(const FHealthHandle& Handle);
+
+	/** Returns the number of running effects */
+	int32 GetNumEffects() const { return Handles.Num(); }
+
+protected:
+
+	/** Adds an effect to the packed arrays */
+	void AddEffect(const FHealthHandle& Handle, float Rate, float Duration, UHealthComponent* Listener);
+
+	/** Applies StepTime worth of every effect and removes the ones that ran out */
+	void StepEffects(UHealthStoreSubsystem* HealthStore, float StepTime);
+
+	/** Removes an effect, swapping the last one into its place */
+	void RemoveEffect(int32 Index);
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
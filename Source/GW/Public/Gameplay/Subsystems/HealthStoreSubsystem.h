@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthStoreSubsystem.generated.h"
+
+/**
+ *  Handle to an entry in the health store.
+ *  Handles go stale when their entry is released, so a reused slot is never mistaken for the old owner
+ */
+USTRUCT()
+struct GW_API FHealthHandle
+{
+	GENERATED_BODY()
+
+	/** Slot in the store arrays */
+	int32 Index = INDEX_NONE;
+
+	/** Generation of the slot when the handle was made */
+	uint32 Generation = 0;
+
+	/** Returns true if the handle was ever assigned. Use the store to check if it's still current */
+	bool IsSet() const { return Index != INDEX_NONE; }
+
+	/** Clears the handle */
+	void Reset() { Index = INDEX_NONE; Generation = 0; }
+
+	bool operator==(const FHealthHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+
+	friend uint32 GetTypeHash(const FHealthHandle& Handle) { return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Generation)); }
+};
+
+/**
+ *  Per-world store for the health of every character.
+ *  Health, max health, shields and alive flags live in contiguous arrays indexed by handles that each actor holds.
+ *  UHealthComponent, ACombatEnemy and ACombatCharacter are thin wrappers over their entry. Worlds without a store
+ *  (anything but game and PIE) leave them keeping their own health, with the same damage and healing rules.
+ *  Bulk operations like area damage, regeneration and wave resets run as tight loops over the arrays
+ *  and report who died, leaving death handling to the owners.
+ *  Entry counts can be viewed with "stat GW"
+ */
+UCLASS()
+class GW_API UHealthStoreSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Current health of each slot */
+	TArray<float> Health;
+
+	/** Max health of each slot */
+	TArray<float> MaxHealth;
+
+	/** Shield of each slot. Shields absorb damage before health */
+	TArray<float> Shield;
+
+	/** Alive flag of each slot */
+	TBitArray<> Alive;
+
+	/** Generation of each slot, bumped when the slot is released */
+	TArray<uint32> Generations;
+
+	/** Owner of each slot */
+	TArray<TWeakObjectPtr<AActor>> Owners;
+
+	/** Released slots available for reuse */
+	TArray<int32> FreeSlots;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UHealthStoreSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds an entry at full health and returns its handle */
+	FHealthHandle Register(AActor* Owner, float InMaxHealth, float InShield = 0.0f);
+
+	/** Releases an entry and clears the handle */
+	void Unregister(FHealthHandle& Handle);
+
+	/** Returns true if the handle refers to a live entry */
+	bool IsValidHandle(const FHealthHandle& Handle) const
+	{
+		return Generations.IsValidIndex(Handle.Index) && Generations[Handle.Index] == Handle.Generation;
+	}
+
+	/** Returns the current health, or 0 for invalid handles */
+	float GetHealth(const FHealthHandle& Handle) const { return IsValidHandle(Handle) ? Health[Handle.Index] : 0.0f; }
+
+	/** Returns the max health, or 0 for invalid handles */
+	float GetMaxHealth(const FHealthHandle& Handle) const { return IsValidHandle(Handle) ? MaxHealth[Handle.Index] : 0.0f; }
+
+	/** Returns the shield, or 0 for invalid handles */
+	float GetShield(const FHealthHandle& Handle) const { return IsValidHandle(Handle) ? Shield[Handle.Index] : 0.0f; }
+
+	/** Returns current over max health, or 0 for invalid handles */
+	float GetHealthPercent(const FHealthHandle& Handle) const;
+
+	/** Returns true if the entry is alive */
+	bool IsAlive(const FHealthHandle& Handle) const { return IsValidHandle(Handle) && Alive[Handle.Index]; }
+
+	/** Returns the owner of the entry, or null */
+	AActor* GetOwner(const FHealthHandle& Handle) const { return IsValidHandle(Handle) ? Owners[Handle.Index].Get() : nullptr; }
+
+	/**
+	 *  Applies damage to the shield, then health. Dead entries take no damage.
+	 *  Returns the damage absorbed, and sets bOutKilled if this damage killed the entry
+	 */
+	float ApplyDamage(const FHealthHandle& Handle, float Damage, bool& bOutKilled);
+
+	/** Heals a living entry up to its max health. Returns the amount healed */
+	float ApplyHealing(const FHealthHandle& Handle, float Amount);
+
+	/** Sets the current health, clamped to max. Setting it to zero or below kills the entry, above zero revives it */
+	void SetHealth(const FHealthHandle& Handle, float NewHealth);
+
+	/** Sets the max health, optionally refilling health to match */
+	void SetMaxHealth(const FHealthHandle& Handle, float NewMaxHealth, bool bRefill);
+
+	/** Sets the shield */
+	void SetShield(const FHealthHandle& Handle, float NewShield);
+
+	/** Brings the entry back to full health and alive */
+	void ResetEntry(const FHealthHandle& Handle);
+
+	/** Applies the same damage to every handle, e.g. for area damage. Handles of entries killed by it are added to OutKilled */
+	void ApplyDamageToMany(TConstArrayView<FHealthHandle> Handles, float Damage, TArray<FHealthHandle>& OutKilled);
+
+	/** Heals every living handle by the same amount, e.g. for a regeneration pulse */
+	void ApplyHealingToMany(TConstArrayView<FHealthHandle> Handles, float Amount);
+
+	/** Brings every handle back to full health and alive, e.g. for a wave reset */
+	void ResetMany(TConstArrayView<FHealthHandle> Handles);
+
+	/** Returns the number of live entries */
+	int32 GetNumEntries() const { return Generations.Num() - FreeSlots.Num(); }
+
+protected:
+
+	/** Damages a slot that's known to be valid. Returns the damage absorbed */
+	float DamageSlot(int32 Index, float Damage, bool& bOutKilled);
+
+	/** Heals a slot that's known to be valid. Returns the amount healed */
+	float HealSlot(int32 Index, float Amount);
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthUISubsystem.generated.h"
+
+/**
+ *  Coalesces health UI updates.
+ *  Owners mark themselves dirty whenever their health changes, and the dirty set is flushed once per frame,
+ *  or at a lower UI rate, so each health bar is updated at most once per flush with its final value,
+ *  no matter how many hits or damage over time steps landed in between.
+ *  Owners must implement IHealthUIOwner. Update counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class GW_API UHealthUISubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Owners whose health changed since the last flush */
+	TSet<TWeakObjectPtr<AActor>> DirtyOwners;
+
+	/** Owners being flushed, kept around to avoid reallocating */
+	TArray<TWeakObjectPtr<AActor>> FlushingOwners;
+
+	/** Time accumulated since the last flush */
+	float TimeSinceFlush = 0.0f;
+
+protected:
+
+	/** Health UI flushes per second. Zero flushes every frame */
+	UPROPERTY(Config, EditAnywhere, Category = "Health UI", meta = (ClampMin = 0, ClampMax = 120, Units = "Hz"))
+	float UpdateRate = 0.0f;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UHealthUISubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Flushes the dirty set at the UI rate */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Queues a health UI update for the owner. The owner must implement IHealthUIOwner */
+	void MarkDirty(AActor* Owner);
+
+	/** Marks the owner dirty in the context object's world, or updates its UI right away if there's no subsystem */
+	static void MarkDirty(const UObject* WorldContextObject, AActor* Owner);
+
+protected:
+
+	/** Tells every dirty owner to update its health UI */
+	void FlushDirtyOwners();
+};
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "OrbSimulationSubsystem.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UMaterialInstanceDynamic;
+class UNiagaraComponent;
+class UNiagaraSystem;
+class UStaticMesh;
+
+/**
+ *  What an orb gives the player that collects it
+ */
+UENUM()
+enum class EOrbKind : uint8
+{
+	/** Restores health */
+	Heal,
+
+	/** Fills the rage meter */
+	Rage
+};
+
+ENUM_RANGE_BY_FIRST_AND_LAST(EOrbKind, EOrbKind::Heal, EOrbKind::Rage);
+
+/**
+ *  Movement state of a simulated orb
+ */
+UENUM()
+enum class EOrbState : uint8
+{
+	/** Flying or bouncing after being launched */
+	Bouncing,
+
+	/** Resting on the ground, waiting for a player to come close */
+	Settled,
+
+	/** Flying towards the player that will collect it */
+	Pulled
+};
+
+/**
+ *  Simulates every pickup orb in the world as packed records instead of one actor each.
+ *  Positions, velocities, states, lifetimes and amounts live in parallel arrays and are updated in one loop per frame.
+ *  Orbs bounce off the ground height found once when they spawn, then settle, and are pulled in and
+ *  collected by distance checks against the cached player position.
+ *  Orbs are drawn by one instanced static mesh per orb kind, tinted by kind, plus one optional Niagara system
+ *  fed the positions and kinds as array data.
+ *  Orb counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class GW_API UOrbSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Position of each orb */
+	TArray<FVector> Positions;
+
+	/** Velocity of each orb */
+	TArray<FVector> Velocities;
+
+	/** Ground height under each orb, found when it spawns */
+	TArray<float> GroundHeights;
+
+	/** Remaining lifetime of each orb */
+	TArray<float> Lifetimes;
+
+	/** Amount each orb gives when collected */
+	TArray<float> Amounts;
+
+	/** State of each orb */
+	TArray<EOrbState> States;
+
+	/** Kind of each orb */
+	TArray<EOrbKind> Kinds;
+
+	/** Instance transforms of one orb kind, rebuilt every frame */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Number of orbs drawn last frame, so the drawing is cleared once after the last orb goes */
+	int32 NumDrawnOrbs = 0;
+
+	/** Orb kinds as ints for the Niagara array */
+	TArray<int32> NiagaraKinds;
+
+	/** Actor that owns the rendering components */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> RenderActor;
+
+	/** Draws the orbs, one component per orb kind, indexed by kind */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UInstancedStaticMeshComponent>> OrbInstances;
+
+	/** Draws the orb effects */
+	UPROPERTY(Transient)
+	TObjectPtr<UNiagaraComponent> OrbEffects;
+
+protected:
+
+	/** Mesh drawn for every orb. Its materials are tinted per orb kind through the color parameter */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	TSoftObjectPtr<UStaticMesh> OrbMesh;
+
+	/** Name of the vector parameter on the orb mesh's materials that the orb color is written to */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	FName ColorParameterName = FName("Color");
+
+	/** Color heal orbs are drawn in */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	FLinearColor HealOrbColor = FLinearColor(0.1f, 1.0f, 0.2f);
+
+	/** Color rage orbs are drawn in */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	FLinearColor RageOrbColor = FLinearColor(1.0f, 0.15f, 0.05f);
+
+	/** Optional Niagara system drawing the orb effects. It reads the orb positions and kinds from user array parameters */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	TSoftObjectPtr<UNiagaraSystem> OrbEffect;
+
+	/** Name of the Niagara user position array parameter */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	FName PositionsParameterName = FName("OrbPositions");
+
+	/** Name of the Niagara user int array parameter holding the orb kinds */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering")
+	FName KindsParameterName = FName("OrbKinds");
+
+	/** Scale applied to the orb mesh */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Rendering", meta = (ClampMin = 0.01, ClampMax = 10))
+	float OrbMeshScale = 0.3f;
+
+	/** Radius of an orb, used to rest it on the ground */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Movement", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
+	float OrbRadius = 15.0f;
+
+	/** Range of the random launch speed given to new orbs */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Movement")
+	FVector2D LaunchSpeedRange = FVector2D(200.0f, 500.0f);
+
+	/** Gravity applied to bouncing orbs */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Movement", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm/s^2"))
+	float Gravity = 980.0f;
+
+	/** Fraction of the speed kept on each bounce */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Movement", meta = (ClampMin = 0, ClampMax = 1))
+	float BounceDamping = 0.5f;
+
+	/** Orbs settle once they bounce slower than this */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Movement", meta = (ClampMin = 0, ClampMax = 1000, Units = "cm/s"))
+	float MinBounceVelocity = 50.0f;
+
+	/** Settled orbs closer than this to the player are pulled in */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Collection", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm"))
+	float DetectionRadius = 500.0f;
+
+	/** Speed pulled orbs fly at */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Collection", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm/s"))
+	float PullSpeed = 800.0f;
+
+	/** Pulled orbs closer than this to the player are collected */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Collection", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float CollectRadius = 60.0f;
+
+	/** Orbs that aren't being pulled disappear after this long */
+	UPROPERTY(Config, EditAnywhere, Category = "Orbs|Collection", meta = (ClampMin = 0, ClampMax = 600, Units = "s"))
+	float Lifetime = 10.0f;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UOrbSimulationSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Creates the rendering components */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Simulates, collects and draws every orb */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an orb at the location, moving at the given velocity */
+	void SpawnOrb(EOrbKind Kind, const FVector& Location, const FVector& Velocity, float Amount);
+
+	/** Adds several orbs scattered around the origin and launched in random upward directions, e.g. as enemy loot */
+	void SpawnOrbBurst(EOrbKind Kind, const FVector& Origin, int32 Count, float Amount);
+
+	/** Returns the number of orbs being simulated */
+	int32 GetNumOrbs() const { return Positions.Num(); }
+
+protected:
+
+	/** Moves every orb, updates its state and collects or expires it. Player may be null */
+	void SimulateOrbs(float DeltaTime, APawn* Player, const FVector& PlayerLocation);
+
+	/** Gives the orb to the player */
+	void CollectOrb(int32 Index, APawn* Player);
+
+	/** Removes an orb, swapping the last one into its place */
+	void RemoveOrb(int32 Index);
+
+	/** Pushes the orb positions to the instanced meshes and Niagara */
+	void UpdateRendering();
+
+	/** Matches the component's instances to the transforms and moves them in one batch */
+	static void UpdateInstances(UInstancedStaticMeshComponent* Instances, const TArray<FTransform>& Transforms);
+
+	/** Returns the color orbs of the kind are drawn in */
+	const FLinearColor& GetOrbColor(EOrbKind Kind) const;
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
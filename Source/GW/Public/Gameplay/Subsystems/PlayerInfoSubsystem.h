@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlayerInfoSubsystem.generated.h"
+
+class APawn;
+class ACharacter;
+
+/**
+ *  Snapshot of a single player-controlled pawn
+ */
+USTRUCT()
+struct FPlayerInfo
+{
+	GENERATED_BODY()
+
+	/** Player-controlled pawn */
+	UPROPERTY()
+	TObjectPtr<APawn> Pawn;
+
+	/** The same pawn as a Character, or null if it isn't one. Cached so readers don't have to cast */
+	UPROPERTY()
+	TObjectPtr<ACharacter> Character;
+
+	/** World location of the pawn when it was captured */
+	FVector Location = FVector::ZeroVector;
+
+	/** Velocity of the pawn when it was captured */
+	FVector Velocity = FVector::ZeroVector;
+};
+
+/**
+ *  Per-world cache of player pawn information.
+ *  Pawns, locations and velocities are captured into a compact array at most once per frame,
+ *  the first time anything asks for them. AI tasks, EQS contexts and pickups read from here
+ *  instead of resolving the player pawn on their own.
+ */
+UCLASS()
+class GW_API UPlayerInfoSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Players captured this frame */
+	UPROPERTY()
+	TArray<FPlayerInfo> Players;
+
+	/** Frame number the players were last captured on */
+	uint64 CapturedFrame = MAX_uint64;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UPlayerInfoSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns every player pawn captured this frame */
+	const TArray<FPlayerInfo>& GetPlayers();
+
+	/** Returns the player at the given index, or null if there isn't one */
+	const FPlayerInfo* GetPlayer(int32 Index);
+
+	/** Returns the player closest to the given location and its squared distance, or null if there are no players */
+	const FPlayerInfo* FindNearestPlayer(const FVector& Location, float& OutDistanceSquared);
+
+protected:
+
+	/** Refreshes the player array if it hasn't been captured this frame yet */
+	void CaptureIfStale();
+};
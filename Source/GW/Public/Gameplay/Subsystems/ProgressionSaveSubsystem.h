@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tasks/Task.h"
+#include "ProgressionSaveSubsystem.generated.h"
+
+/**
+ *  Snapshot of the player's progression, as written to and read from the save file
+ */
+struct FProgressionSaveData
+{
+	/** Unspent skill points */
+	int32 AvailablePoints = 0;
+
+	/** Hash of the skill IDs in compiled order. The bitset only maps back onto a table with the same hash */
+	uint32 SkillTableHash = 0;
+
+	/** Number of skills the bitset covers */
+	int32 NumSkills = 0;
+
+	/** Unlocked skill bitset words */
+	TArray<uint32> UnlockedSkillWords;
+
+	/** Unlocked skill IDs, used to remap the unlocks when the skill table changed */
+	TArray<FName> UnlockedSkillIDs;
+
+	/** Returns true if the snapshot holds the same progression. Only compares the compact state */
+	bool HasSameState(const FProgressionSaveData& Other) const
+	{
+		return AvailablePoints == Other.AvailablePoints && SkillTableHash == Other.SkillTableHash
+			&& NumSkills == Other.NumSkills && UnlockedSkillWords == Other.UnlockedSkillWords;
+	}
+};
+
+/**
+ *  Saves and loads the player's progression as a small versioned binary file.
+ *  The file is a header (magic, version, CRC) followed by tagged chunks, so later player state can be
+ *  added as new chunks and older readers just skip what they don't know.
+ *  The save file is read on a background task as soon as the game starts, and the result is handed to
+ *  progression components once it's ready. Saving only snapshots the compact state on the game thread,
+ *  skips it if nothing changed since the last successful save, and leaves serialization and the file write to a
+ *  background task. Files are written to a temp file and moved over the old one, so a crash mid-write
+ *  never leaves a broken save. Saves that come in while a write is running are coalesced into one write.
+ */
+UCLASS(Config=Game)
+class GW_API UProgressionSaveSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+	/** Newest progression: the last snapshot saved this session, or the one read from the save file */
+	TOptional<FProgressionSaveData> CurrentData;
+
+	/** Newest snapshot waiting for the writer. Guarded by PendingLock */
+	TOptional<FProgressionSaveData> PendingData;
+
+	/** Guards PendingData, bWriteInFlight and bLastWriteFailed */
+	FCriticalSection PendingLock;
+
+	/** True while the write task is running. Guarded by PendingLock */
+	bool bWriteInFlight = false;
+
+	/** True if the last write failed, so the next save is written even if nothing changed. Guarded by PendingLock */
+	bool bLastWriteFailed = false;
+
+	/** True once the load finished, whether or not a save was found */
+	bool bLoadComplete = false;
+
+	/** Background load */
+	UE::Tasks::FTask LoadTask;
+
+	/** Background write */
+	UE::Tasks::FTask WriteTask;
+
+protected:
+
+	/** Name of the save file in Saved/SaveGames */
+	UPROPERTY(Config, EditAnywhere, Category = "Progression Save")
+	FString SaveFileName = TEXT("Progression.sav");
+
+public:
+
+	/** Broadcast on the game thread once the save file was read, or found missing */
+	FSimpleMulticastDelegate OnLoadComplete;
+
+	/** Returns the subsystem for the game instance the context object belongs to, or null */
+	static UProgressionSaveSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Starts reading the save file in the background */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Waits for any load or write still running */
+	virtual void Deinitialize() override;
+
+	/** Returns true once the save file was read, or found missing */
+	bool IsLoadComplete() const { return bLoadComplete; }
+
+	/**
+	 *  Returns the newest progression, or null if nothing was saved and there was no usable save file.
+	 *  That's the last snapshot saved this session, so components restoring after level travel or a respawn
+	 *  don't roll back to the progression the game started with
+	 */
+	const FProgressionSaveData* GetCurrentData() const { return CurrentData.GetPtrOrNull(); }
+
+	/** Queues a snapshot for writing. Does nothing if it's the same as the last one and that one was written */
+	void SaveProgression(FProgressionSaveData&& Data);
+
+	/** Returns the full path of the save file */
+	FString GetSavePath() const;
+
+protected:
+
+	/** Writes pending snapshots until there are none left. Runs on a background task */
+	void WritePendingData();
+
+	/** Called on the game thread when the background load finished */
+	void FinishLoad(TOptional<FProgressionSaveData>&& Data);
+
+	/** Serializes a snapshot into the file format */
+	static void SerializeSaveData(const FProgressionSaveData& Data, TArray<uint8>& OutBytes);
+
+	/** Parses the file format. Returns false if the data is broken or from an unknown version */
+	static bool DeserializeSaveData(const TArray<uint8>& Bytes, FProgressionSaveData& OutData);
+};
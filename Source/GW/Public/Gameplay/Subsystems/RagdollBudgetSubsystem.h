@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "RagdollBudgetSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ *  Simulation state of a tracked ragdoll
+ */
+UENUM()
+enum class ERagdollBudgetState : uint8
+{
+	/** Simulating and counted against the budget */
+	Active,
+
+	/** Put to sleep to make room for a newer ragdoll. Frozen on the next pass */
+	Sleeping,
+
+	/** No longer simulating. The last pose is kept as a static snapshot */
+	Frozen
+};
+
+/**
+ *  A ragdoll tracked by the budget
+ */
+USTRUCT()
+struct FRagdollBudgetEntry
+{
+	GENERATED_BODY()
+
+	/** Mesh that is ragdolling */
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	/** World time the ragdoll started */
+	float StartTime = 0.0f;
+
+	/** Current state */
+	ERagdollBudgetState State = ERagdollBudgetState::Active;
+
+	/** Collision the mesh had before it was frozen, restored when the ragdoll is released */
+	TEnumAsByte<ECollisionEnabled::Type> CollisionBeforeFreeze = ECollisionEnabled::QueryAndPhysics;
+};
+
+/**
+ *  Caps the number of simulating ragdolls in the world.
+ *  Death ragdolls are always granted, putting the oldest active ragdoll to sleep if the budget is full.
+ *  Ragdolls that have settled, or were put to sleep, are frozen in their last pose and stop
+ *  simulating and ticking entirely. Partial ragdoll hit reactions are skipped while over budget.
+ *  Active and frozen counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class GW_API URagdollBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Tracked ragdolls, oldest first */
+	TArray<FRagdollBudgetEntry> Ragdolls;
+
+	/** Number of ragdolls in the Active state */
+	int32 NumActive = 0;
+
+	/** Time accumulated since the last settle check */
+	float TimeSinceCheck = 0.0f;
+
+protected:
+
+	/** Max number of ragdolls simulating at the same time */
+	UPROPERTY(Config, EditAnywhere, Category = "Ragdoll Budget", meta = (ClampMin = 1, ClampMax = 200))
+	int32 MaxActiveRagdolls = 8;
+
+	/** Ragdolls simulate at least this long before they can be frozen */
+	UPROPERTY(Config, EditAnywhere, Category = "Ragdoll Budget", meta = (ClampMin = 0, ClampMax = 30, Units = "s"))
+	float MinSimulationTime = 1.5f;
+
+	/** Ragdolls are frozen after this long even if they haven't settled */
+	UPROPERTY(Config, EditAnywhere, Category = "Ragdoll Budget", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float MaxSimulationTime = 6.0f;
+
+	/** Time between settle checks */
+	UPROPERTY(Config, EditAnywhere, Category = "Ragdoll Budget", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float CheckInterval = 0.25f;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static URagdollBudgetSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Periodically freezes settled ragdolls */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Starts a full ragdoll on the mesh, putting the oldest active ragdoll to sleep if the budget is full */
+	void RequestRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Stops tracking the mesh and undoes any freeze, e.g. before the owner is reused */
+	void ReleaseRagdoll(USkeletalMeshComponent* Mesh);
+
+	/** Returns true if there's room in the budget for a physical hit reaction */
+	bool CanAffordHitReaction() const { return NumActive < MaxActiveRagdolls; }
+
+	/** Returns the number of ragdolls currently simulating */
+	int32 GetNumActiveRagdolls() const { return NumActive; }
+
+protected:
+
+	/** Puts a ragdoll's bodies to sleep and takes it out of the active budget */
+	void SleepRagdoll(FRagdollBudgetEntry& Entry);
+
+	/** Stops simulating a ragdoll and keeps its last pose */
+	void FreezeRagdoll(FRagdollBudgetEntry& Entry);
+
+	/** Updates the ragdoll count stats */
+	void UpdateStats() const;
+};
@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SoakBenchmarkSubsystem.generated.h"
+
+class APawn;
+class APlayer_Base;
+
+/**
+ *  Large battle soak benchmark, the standard test for scaling work on enemies, orbs and damage.
+ *  Spawns a crowd of enemies around the player, then runs combat for a set time at a fixed timestep
+ *  with the player scripted to attack and throw the axe. Enemies that die are replaced to keep the crowd size up.
+ *  Each sample interval a row is appended to a CSV in Saved/Profiling/Soak with frame time percentiles,
+ *  actor and enemy counts, GC pauses and memory high water marks. Per-subsystem times go to the
+ *  engine's CSV profiler capture, which runs alongside the benchmark under the GW category.
+ *
+ *  Headless: GW.exe <Map> -game -nullrhi -unattended -GWSoak [-SoakEnemies=200] [-SoakMinutes=5] [-SoakEnemyClass=/Game/...C] [-SoakFPS=30]
+ *  The game exits once a command line run finishes.
+ *  Automation: the GW.Soak.LargeBattle latent test opens AutomationMap and runs with the config defaults.
+ *  In game: GW.Soak.Start [NumEnemies] [Minutes] [EnemyClassPath], GW.Soak.Stop
+ */
+UCLASS(Config=Game)
+class GW_API USoakBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Enemies spawned by the benchmark */
+	TArray<TWeakObjectPtr<APawn>> Enemies;
+
+	/** Class of the enemies being spawned */
+	UPROPERTY(Transient)
+	TSubclassOf<APawn> ActiveEnemyClass;
+
+	/** Frame times since the last sample, in ms */
+	TArray<float> SampleFrameTimes;
+
+	/** Frame times for the whole run, in ms */
+	TArray<float> RunFrameTimes;
+
+	/** GC pause lengths since the last sample, in ms */
+	TArray<float> SampleGCPauses;
+
+	/** Path of the CSV being written */
+	FString CsvPath;
+
+	/** Number of enemies kept alive during the run */
+	int32 TargetEnemies = 0;
+
+	/** Length of the run, in seconds of game time */
+	float RunDuration = 0.0f;
+
+	/** Game time elapsed since the run started */
+	float RunTime = 0.0f;
+
+	/** Game time elapsed since the last sample */
+	float TimeSinceSample = 0.0f;
+
+	/** Time until the player's next melee attack */
+	float TimeToAttack = 0.0f;
+
+	/** Time until the player's next axe throw or recall */
+	float TimeToThrow = 0.0f;
+
+	/** Time the player has been aiming for the current throw, or negative if not aiming */
+	float AimTime = -1.0f;
+
+	/** Wall clock time of the last frame, to measure real frame times */
+	double LastFrameSeconds = 0.0;
+
+	/** Wall clock time the current GC started */
+	double GCStartSeconds = 0.0;
+
+	/** Longest GC pause of the run, in ms */
+	float RunMaxGCPause = 0.0f;
+
+	/** Number of GC passes during the run */
+	int32 RunGCCount = 0;
+
+	/** Number of enemies that were replaced during the run */
+	int32 RunRespawns = 0;
+
+	/** Fixed timestep settings before the run, restored when it ends */
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	/** If true, a run is in progress */
+	bool bRunning = false;
+
+	/** If true, the run was started from the command line and the game exits when it ends */
+	bool bExitWhenDone = false;
+
+	/** If true, the run started the CSV profiler capture and should end it */
+	bool bStartedCsvCapture = false;
+
+	/** GC delegate handles */
+	FDelegateHandle PreGCHandle;
+	FDelegateHandle PostGCHandle;
+
+protected:
+
+	/** Enemy class to spawn when none is given */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark")
+	TSoftClassPtr<APawn> DefaultEnemyClass;
+
+	/** Number of enemies to spawn when none is given */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 1, ClampMax = 5000))
+	int32 DefaultNumEnemies = 100;
+
+	/** Length of the run when none is given */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0.1, ClampMax = 600))
+	float DefaultDurationMinutes = 5.0f;
+
+	/** Frame rate of the fixed timestep the run uses */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 1, ClampMax = 240))
+	float FixedFrameRate = 30.0f;
+
+	/** Enemies spawn in a ring around the player, no closer than this */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float SpawnRadiusMin = 800.0f;
+
+	/** Enemies spawn in a ring around the player, no further than this */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float SpawnRadiusMax = 3000.0f;
+
+	/** Max number of enemies spawned or replaced each frame, so the spawn itself doesn't dominate the numbers */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 1, ClampMax = 1000))
+	int32 MaxSpawnsPerFrame = 20;
+
+	/** Time between the player's melee attacks */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0.05, ClampMax = 10, Units = "s"))
+	float AttackInterval = 0.8f;
+
+	/** Time between the player's axe throws and recalls */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0.1, ClampMax = 60, Units = "s"))
+	float ThrowInterval = 3.0f;
+
+	/** Time the player aims before throwing the axe, and keeps aiming after the throw so the axe leaves along the aim */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0.05, ClampMax = 5, Units = "s"))
+	float AimHoldTime = 0.5f;
+
+	/** Time between CSV rows */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark", meta = (ClampMin = 0.1, ClampMax = 60, Units = "s"))
+	float SampleInterval = 1.0f;
+
+	/** If true, the player's health is refilled every sample so the run isn't cut short */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark")
+	bool bKeepPlayerAlive = true;
+
+	/** Map the soak automation test runs in. If not set, the game default map is used */
+	UPROPERTY(Config, EditAnywhere, Category = "Soak Benchmark")
+	TSoftObjectPtr<UWorld> AutomationMap;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static USoakBenchmarkSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Starts a run if the command line asks for one */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Ends any run in progress */
+	virtual void Deinitialize() override;
+
+	/** Drives the player, keeps the crowd topped up and records the frame */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Starts a run. Anything not given (null, zero) falls back on the config defaults. Returns false if there's no enemy class to spawn */
+	bool StartRun(TSubclassOf<APawn> EnemyClass, int32 NumEnemies, float DurationMinutes);
+
+	/** Ends the run in progress, writes the summary row and destroys the spawned enemies */
+	void StopRun();
+
+	/** Returns true while a run is in progress */
+	bool IsRunning() const { return bRunning; }
+
+	/** Returns the CSV the current or last run wrote to, or an empty string if no run has started */
+	const FString& GetCsvPath() const { return CsvPath; }
+
+	/** Returns the map the soak automation test runs in */
+	FString GetAutomationMapName() const;
+
+protected:
+
+	/** Spawns enemies until the crowd is back at the target size, within the per frame limit */
+	void TopUpEnemies(const FVector& Center);
+
+	/** Faces the nearest enemy and attacks or throws when due */
+	void DrivePlayer(APlayer_Base* Player, float DeltaTime);
+
+	/** Returns the player being driven, or null */
+	APlayer_Base* GetPlayer() const;
+
+	/** Appends a row to the CSV and starts a new sample */
+	void WriteSample();
+
+	/** Returns the number of spawned enemies that are still alive */
+	int32 CountLivingEnemies() const;
+
+	/** Returns false if the enemy is gone, dead, or waiting in an enemy pool */
+	static bool IsEnemyAlive(const APawn* Enemy);
+
+	/** Returns the given percentile of a list of values */
+	static float GetPercentile(TArray<float>& Values, float Percentile);
+
+	/** GC timing */
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+};
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TickAuditSubsystem.generated.h"
+
+class UMovementComponent;
+
+/**
+ *  Times a native GW tick while a tick audit is running. Does nothing in shipping builds
+ */
+class GW_API FTickAuditScope
+{
+	/** Class being timed, or null if no audit is running */
+	const UClass* Class = nullptr;
+
+	/** Cycle count when the tick started */
+	uint64 StartCycles = 0;
+
+public:
+
+	explicit FTickAuditScope(const UObject* Object);
+	~FTickAuditScope();
+};
+
+#if !UE_BUILD_SHIPPING
+	/** Put at the top of a native Tick or TickComponent so the tick audit can time it */
+	#define GW_TICK_AUDIT_SCOPE() FTickAuditScope TickAuditScope(this)
+#else
+	#define GW_TICK_AUDIT_SCOPE()
+#endif
+
+/**
+ *  Development tick audit for every GW actor and component tick.
+ *  While an audit runs, every tick function of a GW class (or a Blueprint based on one) is sampled each frame
+ *  for how often it ran, whether it was enabled, and whether its owner's transform changed. Changes made while
+ *  a movement component was moving the owner's actor are put down to the movement, not the tick.
+ *  Native ticks wrapped in GW_TICK_AUDIT_SCOPE are timed too, including the GW subsystems.
+ *  The report goes to the log and to a CSV in Saved/Profiling/TickAudit. It lists registered and enabled tick
+ *  functions per class and flags classes whose ticks ran without changing their owner, and classes whose
+ *  enabled ticks never ran. Both flags are heuristics: a tick can do work that doesn't show in a transform.
+ *  Flagged classes are candidates for FOnDemandTick or for not ticking at all, after a look at the code.
+ *  Not created in shipping builds.
+ *  In game: GW.TickAudit.Start [Seconds], GW.TickAudit.Stop
+ */
+UCLASS()
+class GW_API UTickAuditSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** A tick function being sampled */
+	struct FAuditedTick
+	{
+		/** Actor or component owning the tick function */
+		TWeakObjectPtr<UObject> Owner;
+
+		/** Class the results are grouped under */
+		const UClass* Class = nullptr;
+
+		/** Only dereferenced while the owner is valid */
+		FTickFunction* TickFunction = nullptr;
+
+		/** Movement component moving the owner's actor, if any. The owner moving while it moves is put down to it */
+		TWeakObjectPtr<const UMovementComponent> Movement;
+
+		/** Last tick time seen, to count calls */
+		float LastTickTime = 0.0f;
+
+		/** Number of times the tick ran during the audit */
+		int32 Calls = 0;
+
+		/** Owner transform at the last sample, if it has one */
+		FTransform LastState;
+
+		/** True if the owner has a transform to watch */
+		bool bHasState = false;
+
+		/** True if the movement component was moving at the last sample */
+		bool bWasMoving = false;
+
+		/** True once the owner's transform changed while no movement component was moving it */
+		bool bStateChanged = false;
+
+		/** True once the owner's transform changed while its movement component was moving it */
+		bool bMovedByMovement = false;
+
+		/** True once the tick function was seen enabled */
+		bool bEverEnabled = false;
+	};
+
+	/** Tick functions being sampled */
+	TArray<FAuditedTick> AuditedTicks;
+
+	/** Owners already added, so actors spawned during the audit are only added once */
+	TSet<TWeakObjectPtr<UObject>> AuditedOwners;
+
+	/** Handle for the actor spawned callback */
+	FDelegateHandle ActorSpawnedHandle;
+
+	/** Audit time left. Negative runs until stopped */
+	float TimeRemaining = 0.0f;
+
+	/** Audit length so far */
+	float AuditTime = 0.0f;
+
+	/** Frames sampled so far */
+	int32 NumFrames = 0;
+
+	/** True while an audit is running in this world */
+	bool bAuditRunning = false;
+
+public:
+
+	/** Returns the subsystem for the world the context object lives in, or null */
+	static UTickAuditSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Not created in shipping builds */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Stops a running audit */
+	virtual void Deinitialize() override;
+
+	/** Samples the audited tick functions */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Starts an audit. A zero or negative duration runs until stopped */
+	void StartAudit(float Duration);
+
+	/** Stops the audit and writes the report */
+	void StopAudit();
+
+	/** Returns true while any world is running an audit */
+	static bool IsAuditRunning();
+
+	/** Adds the time of one native tick of the class to the audit */
+	static void RecordNativeTick(const UClass* Class, uint64 Cycles);
+
+protected:
+
+	/** Starts sampling the actor's tick and its components' ticks, if they're GW classes */
+	void AddActor(AActor* Actor);
+
+	/** Starts sampling one tick function */
+	void AddTickFunction(UObject* Owner, FTickFunction& TickFunction);
+
+	/** Counts calls, watches whether ticks are enabled and watches owner state */
+	void SampleTicks();
+
+	/** Writes the report to the log and a CSV */
+	void WriteReport() const;
+
+	/** Returns true if the class, or the first native class it's based on, is from the GW module */
+	static bool IsGWClass(const UClass* Class);
+
+	/** Returns the owner's transform, if it has one */
+	static bool GetOwnerState(const UObject* Owner, FTransform& OutState);
+
+	/** Returns the movement component moving the owner's actor, or null. Movement components don't count their own moves */
+	static const UMovementComponent* FindOwnerMovement(const UObject* Owner);
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+
+/**
+ *  Keeps an actor or component tick enabled only while it has work to do.
+ *  Work is tracked as a mask of reasons, so unrelated jobs can share one tick: the tick turns on with the
+ *  first request and back off once every reason is released, so idle owners stay out of the tick lists.
+ *  Call Setup from the owner's constructor, so the tick can be registered but starts off, and BeginPlay from
+ *  the owner's BeginPlay. Blueprint Event Tick runs from the same tick function, so owners whose Blueprint
+ *  implements it keep the tick on for good.
+ */
+struct FOnDemandTick
+{
+	/** Lets the tick function be registered, but starts it off */
+	static void Setup(FTickFunction& TickFunction)
+	{
+		TickFunction.bCanEverTick = true;
+		TickFunction.bStartWithTickEnabled = false;
+	}
+
+	/** Keeps the tick on for good if the owner's Blueprint implements Event Tick, which would otherwise stay off while idle */
+	template <typename OwnerType>
+	void BeginPlay(OwnerType* Owner)
+	{
+		static const FName ReceiveTickName(TEXT("ReceiveTick"));
+
+		if (Owner->GetClass()->IsFunctionImplementedInScript(ReceiveTickName))
+		{
+			bBlueprintTick = true;
+			SetTickEnabled(Owner, true);
+		}
+	}
+
+	/** Turns the tick on, if it wasn't already, and keeps it on until the reason is released */
+	template <typename OwnerType>
+	void Request(OwnerType* Owner, uint32 Reason = 1)
+	{
+		const bool bWasIdle = Reasons == 0;
+		Reasons |= Reason;
+
+		if (bWasIdle && Reasons != 0 && !bBlueprintTick)
+		{
+			SetTickEnabled(Owner, true);
+		}
+	}
+
+	/** Releases the reason, turning the tick off if nothing else needs it and no Blueprint Event Tick runs on it */
+	template <typename OwnerType>
+	void Release(OwnerType* Owner, uint32 Reason = 1)
+	{
+		const bool bWasIdle = Reasons == 0;
+		Reasons &= ~Reason;
+
+		if (!bWasIdle && Reasons == 0 && !bBlueprintTick)
+		{
+			SetTickEnabled(Owner, false);
+		}
+	}
+
+	/** Releases every reason and turns the tick off */
+	template <typename OwnerType>
+	void ReleaseAll(OwnerType* Owner)
+	{
+		Release(Owner, MAX_uint32);
+	}
+
+	/** Returns true if any of the given reasons is keeping the tick on */
+	bool IsRequested(uint32 Reason = MAX_uint32) const { return (Reasons & Reason) != 0; }
+
+private:
+
+	static void SetTickEnabled(AActor* Owner, bool bEnabled) { Owner->SetActorTickEnabled(bEnabled); }
+	static void SetTickEnabled(UActorComponent* Owner, bool bEnabled) { Owner->SetComponentTickEnabled(bEnabled); }
+
+	/** Reasons the tick is on for */
+	uint32 Reasons = 0;
+
+	/** True if the owner's Blueprint implements Event Tick, so the tick is never turned off */
+	bool bBlueprintTick = false;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Styling/SlateBrush.h"
+#include "EnemyHealthBarOverlay.generated.h"
+
+/**
+ *  Full screen HUD overlay that draws every visible enemy health bar in a single paint pass.
+ *  Bars are read from the enemy health bar subsystem, culled by distance and visibility,
+ *  projected into a packed array of screen positions and drawn as simple boxes.
+ */
+UCLASS()
+class GW_API UEnemyHealthBarOverlay : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Bars farther than this from the camera are not drawn */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (ClampMin = 0, Units = "cm"))
+	float MaxDrawDistance = 3000.0f;
+
+	/** Bars are only drawn for owners rendered within this many seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (ClampMin = 0, Units = "s"))
+	float RecentlyRenderedTolerance = 0.2f;
+
+	/** Size of a bar on screen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars")
+	FVector2D BarSize = FVector2D(80.0f, 8.0f);
+
+	/** Brush used for both the background and the fill */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars")
+	FSlateBrush BarBrush;
+
+	/** Background color */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars")
+	FLinearColor BackgroundColor = FLinearColor(0.0f, 0.0f, 0.0f, 0.6f);
+
+	/** Fill color */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars")
+	FLinearColor FillColor = FLinearColor(0.8f, 0.1f, 0.1f, 1.0f);
+
+	/** Screen positions of the bars to draw this frame, in widget space */
+	TArray<FVector2f> VisiblePositions;
+
+	/** Health percentages of the bars to draw this frame */
+	TArray<float> VisiblePercents;
+
+protected:
+
+	/** Makes the overlay ignore input */
+	virtual void NativeConstruct() override;
+
+	/** Culls and projects the bars for this frame */
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+	/** Draws every visible bar */
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+};
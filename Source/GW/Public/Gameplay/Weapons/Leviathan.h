@@ -176,6 +176,9 @@ protected:
 
 	void ReturnAxe();
 
+	// Throwing damage with the thrower's buffs and passives applied
+	float GetThrowingDamage() const;
+
 protected:
 	/********************
 	 * Timeline
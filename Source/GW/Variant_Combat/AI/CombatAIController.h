@@ -24,4 +24,7 @@ public:
 
 	/** Constructor */
 	ACombatAIController();
+
+	/** Returns the StateTree component */
+	FORCEINLINE UStateTreeAIComponent* GetStateTreeAI() const { return StateTreeAI; }
 };
@@ -0,0 +1,247 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatAILODSubsystem.h"
+#include "CombatEnemy.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "IAnimationBudgetAllocator.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD High"), STAT_GW_AILODHigh, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD Medium"), STAT_GW_AILODMedium, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD Low"), STAT_GW_AILODLow, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI LOD Dormant"), STAT_GW_AILODDormant, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("AI LOD Evaluate"), STAT_GW_AILODEvaluate, STATGROUP_GW);
+
+UCombatAILODSubsystem::UCombatAILODSubsystem()
+{
+	// set up the default tier intervals. These can be overridden in the game config
+	MediumTier.ActorTickInterval = 0.1f;
+	MediumTier.MovementTickInterval = 0.033f;
+	MediumTier.MeshTickInterval = 0.033f;
+	MediumTier.StateTreeTickInterval = 0.1f;
+
+	LowTier.ActorTickInterval = 0.25f;
+	LowTier.MovementTickInterval = 0.1f;
+	LowTier.MeshTickInterval = 0.1f;
+	LowTier.StateTreeTickInterval = 0.25f;
+
+	DormantTier.ActorTickInterval = 1.0f;
+	DormantTier.MovementTickInterval = 0.25f;
+	DormantTier.MeshTickInterval = 0.5f;
+	DormantTier.StateTreeTickInterval = 0.5f;
+}
+
+bool UCombatAILODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatAILODSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	IAnimationBudgetAllocator* AnimationBudget = bUseAnimationBudget ? IAnimationBudgetAllocator::Get(&InWorld) : nullptr;
+
+	if (!AnimationBudget)
+	{
+		return;
+	}
+
+	AnimationBudget->SetParameters(AnimationBudgetParameters);
+	AnimationBudget->SetEnabled(true);
+
+	bAnimationBudgetActive = AnimationBudget->GetEnabled();
+
+	// the allocator decides how often meshes tick, so the tiers leave mesh ticking alone
+	if (bAnimationBudgetActive)
+	{
+		MediumTier.MeshTickInterval = 0.0f;
+		LowTier.MeshTickInterval = 0.0f;
+		DormantTier.MeshTickInterval = 0.0f;
+	}
+}
+
+void UCombatAILODSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, AILOD);
+
+	Super::Tick(DeltaTime);
+
+	// only re-evaluate at the configured rate
+	TimeSinceEvaluation += DeltaTime;
+
+	if (TimeSinceEvaluation >= EvaluationInterval)
+	{
+		TimeSinceEvaluation = 0.0f;
+		EvaluateTiers();
+	}
+}
+
+TStatId UCombatAILODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatAILODSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatAILODSubsystem::RegisterEnemy(ACombatEnemy* Enemy)
+{
+	if (IsValid(Enemy))
+	{
+		Enemies.AddUnique(Enemy);
+	}
+}
+
+void UCombatAILODSubsystem::UnregisterEnemy(ACombatEnemy* Enemy)
+{
+	Enemies.RemoveSwap(Enemy);
+}
+
+void UCombatAILODSubsystem::PromoteToHigh(ACombatEnemy* Enemy)
+{
+	if (!IsValid(Enemy))
+	{
+		return;
+	}
+
+	// skip the update if the enemy is already at full rate
+	if (Enemy->GetAILOD() != ECombatAILOD::High)
+	{
+		Enemy->ApplyAILOD(ECombatAILOD::High, HighTier);
+	}
+
+	// don't wait for the next evaluation pass to stop skipping animation updates
+	Enemy->ApplyAnimationSignificance(1.0f, bAnimationBudgetActive);
+}
+
+const FCombatAILODTierSettings& UCombatAILODSubsystem::GetTierSettings(ECombatAILOD Tier) const
+{
+	switch (Tier)
+	{
+	case ECombatAILOD::Medium:
+		return MediumTier;
+	case ECombatAILOD::Low:
+		return LowTier;
+	case ECombatAILOD::Dormant:
+		return DormantTier;
+	default:
+		return HighTier;
+	}
+}
+
+void UCombatAILODSubsystem::EvaluateTiers()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_AILODEvaluate);
+
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this);
+
+	int32 TierCounts[static_cast<int32>(ECombatAILOD::Count)] = {};
+
+	for (int32 Index = Enemies.Num() - 1; Index >= 0; --Index)
+	{
+		ACombatEnemy* Enemy = Enemies[Index];
+
+		// drop any enemies that were destroyed without unregistering
+		if (!IsValid(Enemy))
+		{
+			Enemies.RemoveAtSwap(Index);
+			continue;
+		}
+
+		// find the squared distance to the closest player. With no players, everyone is far away
+		float DistanceSquared = TNumericLimits<float>::Max();
+
+		if (PlayerInfo)
+		{
+			PlayerInfo->FindNearestPlayer(Enemy->GetActorLocation(), DistanceSquared);
+		}
+
+		const ECombatAILOD NewTier = ComputeTier(Enemy, DistanceSquared);
+
+		// only touch tick functions if the tier actually changed
+		if (NewTier != Enemy->GetAILOD())
+		{
+			Enemy->ApplyAILOD(NewTier, GetTierSettings(NewTier));
+		}
+
+		// update the animation budget significance every pass, since it changes smoothly with distance
+		Enemy->ApplyAnimationSignificance(ComputeAnimationSignificance(Enemy, DistanceSquared), bAnimationBudgetActive);
+
+		++TierCounts[static_cast<int32>(NewTier)];
+	}
+
+	SET_DWORD_STAT(STAT_GW_AILODHigh, TierCounts[static_cast<int32>(ECombatAILOD::High)]);
+	SET_DWORD_STAT(STAT_GW_AILODMedium, TierCounts[static_cast<int32>(ECombatAILOD::Medium)]);
+	SET_DWORD_STAT(STAT_GW_AILODLow, TierCounts[static_cast<int32>(ECombatAILOD::Low)]);
+	SET_DWORD_STAT(STAT_GW_AILODDormant, TierCounts[static_cast<int32>(ECombatAILOD::Dormant)]);
+}
+
+ECombatAILOD UCombatAILODSubsystem::ComputeTier(const ACombatEnemy* Enemy, float DistanceSquaredToPlayer) const
+{
+	// dead enemies keep whatever tier they died in; their ragdoll doesn't depend on it
+	if (Enemy->IsDead())
+	{
+		return Enemy->GetAILOD();
+	}
+
+	// attacking or airborne enemies must run at full rate so the attack completed
+	// and landed delegates fire on time for their StateTree tasks
+	if (Enemy->IsAttacking() || Enemy->GetCharacterMovement()->IsFalling())
+	{
+		return ECombatAILOD::High;
+	}
+
+	// recently damaged enemies are reacting to the hit, wherever they are
+	if (GetWorld()->GetTimeSeconds() - Enemy->GetLastDamageTime() <= RecentDamageWindow)
+	{
+		return ECombatAILOD::High;
+	}
+
+	// enemies close to a player are engaged in combat
+	if (DistanceSquaredToPlayer <= FMath::Square(EngagedDistance))
+	{
+		return ECombatAILOD::High;
+	}
+
+	// pick the tier based on distance
+	int32 Tier = static_cast<int32>(ECombatAILOD::Low);
+
+	if (DistanceSquaredToPlayer <= FMath::Square(MediumDistance))
+	{
+		Tier = static_cast<int32>(ECombatAILOD::High);
+	}
+	else if (DistanceSquaredToPlayer <= FMath::Square(LowDistance))
+	{
+		Tier = static_cast<int32>(ECombatAILOD::Medium);
+	}
+
+	// drop one extra tier if nobody can see the enemy
+	if (!Enemy->WasRecentlyRendered(RecentlyRenderedTolerance))
+	{
+		++Tier;
+	}
+
+	return static_cast<ECombatAILOD>(FMath::Min(Tier, static_cast<int32>(ECombatAILOD::Dormant)));
+}
+
+float UCombatAILODSubsystem::ComputeAnimationSignificance(const ACombatEnemy* Enemy, float DistanceSquaredToPlayer) const
+{
+	// attacking enemies are always fully significant
+	if (Enemy->IsAttacking())
+	{
+		return 1.0f;
+	}
+
+	// fall off linearly with distance to the nearest player
+	float Significance = 1.0f - FMath::Clamp(FMath::Sqrt(DistanceSquaredToPlayer) / AnimationSignificanceDistance, 0.0f, 1.0f);
+
+	// enemies nobody can see matter less
+	if (!Enemy->WasRecentlyRendered(RecentlyRenderedTolerance))
+	{
+		Significance *= OffScreenSignificanceScale;
+	}
+
+	return Significance;
+}
@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "CombatAILODSubsystem.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  AI level of detail tiers for combat enemies, from full rate to barely ticking
+ */
+UENUM()
+enum class ECombatAILOD : uint8
+{
+	High,
+	Medium,
+	Low,
+	Dormant,
+	Count UMETA(Hidden)
+};
+
+/**
+ *  Tick intervals applied to an enemy while it's in a given AI LOD tier.
+ *  An interval of zero ticks every frame
+ */
+USTRUCT()
+struct FCombatAILODTierSettings
+{
+	GENERATED_BODY()
+
+	/** Tick interval for the enemy actor itself */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float ActorTickInterval = 0.0f;
+
+	/** Tick interval for the character movement component */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float MovementTickInterval = 0.0f;
+
+	/** Tick interval for the skeletal mesh and its animation */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float MeshTickInterval = 0.0f;
+
+	/** Tick interval for the AI Controller's StateTree component */
+	UPROPERTY(EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float StateTreeTickInterval = 0.0f;
+};
+
+/**
+ *  Assigns AI LOD tiers to every combat enemy in the world.
+ *  Tiers are driven by distance to the nearest player, whether the enemy was recently on screen,
+ *  and whether it's engaged in combat. Each tier sets the tick intervals of the enemy's actor,
+ *  movement, mesh and StateTree. Enemies that are attacking or airborne always run at full rate,
+ *  so their attack completed and landed notifications are never delayed.
+ *  Enemy mesh animation is driven by the engine's animation budget allocator, with a significance
+ *  computed from the same distance and visibility inputs. Attacking enemies are never skipped, so their
+ *  attack trace notifies fire on time. Without the allocator, meshes fall back to update rate optimizations.
+ *  Tier counts can be viewed with "stat GW", budget details with "stat AnimationBudgetAllocator"
+ */
+UCLASS(Config=Game)
+class UCombatAILODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Enemies registered with the subsystem, packed so evaluation is a straight loop */
+	UPROPERTY()
+	TArray<TObjectPtr<ACombatEnemy>> Enemies;
+
+	/** Time accumulated since the last evaluation pass */
+	float TimeSinceEvaluation = 0.0f;
+
+protected:
+
+	/** Time between tier evaluation passes */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float EvaluationInterval = 0.25f;
+
+	/** Enemies closer than this to a player are considered engaged and always run at full rate */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float EngagedDistance = 800.0f;
+
+	/** Enemies damaged within this time always run at full rate, so their hit reactions play out */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float RecentDamageWindow = 2.0f;
+
+	/** Enemies beyond this distance drop to the Medium tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float MediumDistance = 1500.0f;
+
+	/** Enemies beyond this distance drop to the Low tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float LowDistance = 3000.0f;
+
+	/** How recently an enemy must have been rendered to count as on screen. Off-screen enemies drop one extra tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float RecentlyRenderedTolerance = 0.3f;
+
+	/** Tick intervals for the Medium tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD")
+	FCombatAILODTierSettings MediumTier;
+
+	/** Tick intervals for the Low tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD")
+	FCombatAILODTierSettings LowTier;
+
+	/** Tick intervals for the Dormant tier */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD")
+	FCombatAILODTierSettings DormantTier;
+
+	/** Tick intervals for the High tier. Everything ticks every frame */
+	FCombatAILODTierSettings HighTier;
+
+	/** If true, enemy mesh animation is throttled by the animation budget allocator instead of the tier mesh tick intervals */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD|Animation Budget")
+	bool bUseAnimationBudget = true;
+
+	/** Parameters passed to the animation budget allocator for this world */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD|Animation Budget", meta = (EditCondition = "bUseAnimationBudget"))
+	FAnimationBudgetAllocatorParameters AnimationBudgetParameters;
+
+	/** Distance to the nearest player at which animation significance falls to zero */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD|Animation Budget", meta = (ClampMin = 1, ClampMax = 100000, Units = "cm"))
+	float AnimationSignificanceDistance = 5000.0f;
+
+	/** Multiplier applied to the animation significance of enemies that are off screen */
+	UPROPERTY(Config, EditAnywhere, Category="AI LOD|Animation Budget", meta = (ClampMin = 0, ClampMax = 1))
+	float OffScreenSignificanceScale = 0.25f;
+
+	/** True once the animation budget allocator has been enabled for this world */
+	bool bAnimationBudgetActive = false;
+
+public:
+
+	/** Constructor */
+	UCombatAILODSubsystem();
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Sets up the animation budget allocator */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Periodically re-evaluates enemy tiers */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an enemy to the LOD evaluation list */
+	void RegisterEnemy(ACombatEnemy* Enemy);
+
+	/** Removes an enemy from the LOD evaluation list */
+	void UnregisterEnemy(ACombatEnemy* Enemy);
+
+	/** Immediately raises an enemy to full rate and full animation significance, e.g. when it starts an attack */
+	void PromoteToHigh(ACombatEnemy* Enemy);
+
+	/** Returns the tick settings for the given tier */
+	const FCombatAILODTierSettings& GetTierSettings(ECombatAILOD Tier) const;
+
+protected:
+
+	/** Computes the tier for every registered enemy and applies any changes */
+	void EvaluateTiers();
+
+	/** Computes the tier a single enemy should be in, given its squared distance to the nearest player */
+	ECombatAILOD ComputeTier(const ACombatEnemy* Enemy, float DistanceSquaredToPlayer) const;
+
+	/** Computes the animation budget significance for an enemy, from 0 to 1 */
+	float ComputeAnimationSignificance(const ACombatEnemy* Enemy, float DistanceSquaredToPlayer) const;
+};
@@ -0,0 +1,376 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatCrowdSubsystem.h"
+#include "CombatEnemy.h"
+#include "CombatEnemyPoolSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Entities"), STAT_GW_CrowdEntities, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Full Actors"), STAT_GW_CrowdFullActors, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Crowd Simulate"), STAT_GW_CrowdSimulate, STATGROUP_GW);
+DECLARE_CYCLE_STAT(TEXT("Crowd Promotions"), STAT_GW_CrowdPromotions, STATGROUP_GW);
+
+bool UCombatCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatCrowdSubsystem::Deinitialize()
+{
+	// destroy the render actor along with the instanced meshes
+	if (IsValid(RenderActor))
+	{
+		RenderActor->Destroy();
+	}
+
+	RenderActor = nullptr;
+	Archetypes.Reset();
+
+	Super::Deinitialize();
+}
+
+void UCombatCrowdSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, Crowd);
+
+	Super::Tick(DeltaTime);
+
+	// nothing to do if we have no crowd and no promoted enemies
+	if (Locations.Num() == 0 && PromotedEnemies.Num() == 0)
+	{
+		return;
+	}
+
+	SimulateCrowd(DeltaTime);
+
+	// promotions and demotions don't need to run every frame
+	TimeSincePromotionPass += DeltaTime;
+
+	if (TimeSincePromotionPass >= PromotionInterval)
+	{
+		TimeSincePromotionPass = 0.0f;
+		UpdatePromotions();
+	}
+
+	UpdateInstances();
+
+	SET_DWORD_STAT(STAT_GW_CrowdEntities, Locations.Num());
+	SET_DWORD_STAT(STAT_GW_CrowdFullActors, PromotedEnemies.Num());
+}
+
+TStatId UCombatCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatCrowdSubsystem::AddCrowdEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform)
+{
+	const int32 Archetype = FindOrAddArchetype(EnemyClass);
+
+	if (Archetype != INDEX_NONE)
+	{
+		AddEntity(Archetype, SpawnTransform.GetLocation(), SpawnTransform.Rotator().Yaw, Archetypes[Archetype].MaxHP);
+	}
+}
+
+int32 UCombatCrowdSubsystem::AddCrowdEnemies(TSubclassOf<ACombatEnemy> EnemyClass, FVector Center, float Radius, int32 Count)
+{
+	const int32 Archetype = FindOrAddArchetype(EnemyClass);
+
+	if (Archetype == INDEX_NONE)
+	{
+		return 0;
+	}
+
+	Locations.Reserve(Locations.Num() + Count);
+	Yaws.Reserve(Yaws.Num() + Count);
+	HitPoints.Reserve(HitPoints.Num() + Count);
+	ArchetypeIndices.Reserve(ArchetypeIndices.Num() + Count);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		// scatter uniformly in the circle
+		const FVector2D Offset = FMath::RandPointInCircle(Radius);
+
+		AddEntity(Archetype, Center + FVector(Offset.X, Offset.Y, 0.0f), FMath::FRandRange(-180.0f, 180.0f), Archetypes[Archetype].MaxHP);
+	}
+
+	return Count;
+}
+
+int32 UCombatCrowdSubsystem::FindOrAddArchetype(TSubclassOf<ACombatEnemy> EnemyClass)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return INDEX_NONE;
+	}
+
+	// do we already have this archetype?
+	const int32 ExistingIndex = Archetypes.IndexOfByPredicate([EnemyClass](const FCombatCrowdArchetype& Archetype) { return Archetype.EnemyClass == EnemyClass; });
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	// create the render actor the first time it's needed
+	if (!IsValid(RenderActor))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		RenderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+		USceneComponent* Root = NewObject<USceneComponent>(RenderActor, TEXT("Root"));
+		RenderActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	const ACombatEnemy* EnemyCDO = EnemyClass->GetDefaultObject<ACombatEnemy>();
+
+	FCombatCrowdArchetype& Archetype = Archetypes.AddDefaulted_GetRef();
+	Archetype.EnemyClass = EnemyClass;
+	Archetype.MaxHP = EnemyCDO->GetMaxHP();
+	Archetype.MeshOffset = FVector(0.0f, 0.0f, -EnemyCDO->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+	// create one instanced mesh for every entity of this class
+	Archetype.InstancedMesh = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+	Archetype.InstancedMesh->SetStaticMesh(EnemyCDO->GetCrowdProxyMesh());
+	Archetype.InstancedMesh->SetMobility(EComponentMobility::Movable);
+	Archetype.InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Archetype.InstancedMesh->SetupAttachment(RenderActor->GetRootComponent());
+	Archetype.InstancedMesh->RegisterComponent();
+
+	return Archetypes.Num() - 1;
+}
+
+void UCombatCrowdSubsystem::AddEntity(int32 Archetype, const FVector& Location, float Yaw, float HP)
+{
+	Locations.Add(Location);
+	Yaws.Add(Yaw);
+	HitPoints.Add(HP);
+	ArchetypeIndices.Add(Archetype);
+}
+
+void UCombatCrowdSubsystem::RemoveEntity(int32 EntityIndex)
+{
+	Locations.RemoveAtSwap(EntityIndex, 1, EAllowShrinking::No);
+	Yaws.RemoveAtSwap(EntityIndex, 1, EAllowShrinking::No);
+	HitPoints.RemoveAtSwap(EntityIndex, 1, EAllowShrinking::No);
+	ArchetypeIndices.RemoveAtSwap(EntityIndex, 1, EAllowShrinking::No);
+}
+
+void UCombatCrowdSubsystem::SimulateCrowd(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_CrowdSimulate);
+
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this);
+
+	if (!PlayerInfo || PlayerInfo->GetPlayers().Num() == 0)
+	{
+		return;
+	}
+
+	const TArray<FPlayerInfo>& Players = PlayerInfo->GetPlayers();
+	const float HoldDistanceSquared = FMath::Square(CrowdHoldDistance);
+	const float StepDistance = CrowdMoveSpeed * DeltaTime;
+
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		FVector& Location = Locations[Index];
+
+		// find the nearest player
+		FVector NearestPlayerLocation = Players[0].Location;
+		float NearestDistanceSquared = FVector::DistSquared2D(Location, NearestPlayerLocation);
+
+		for (int32 PlayerIndex = 1; PlayerIndex < Players.Num(); ++PlayerIndex)
+		{
+			const float DistanceSquared = FVector::DistSquared2D(Location, Players[PlayerIndex].Location);
+
+			if (DistanceSquared < NearestDistanceSquared)
+			{
+				NearestDistanceSquared = DistanceSquared;
+				NearestPlayerLocation = Players[PlayerIndex].Location;
+			}
+		}
+
+		// advance on the player until we're close enough to be promoted
+		if (NearestDistanceSquared > HoldDistanceSquared)
+		{
+			const FVector Direction = FVector(NearestPlayerLocation.X - Location.X, NearestPlayerLocation.Y - Location.Y, 0.0f).GetSafeNormal();
+
+			Location += Direction * StepDistance;
+			Yaws[Index] = FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X));
+		}
+	}
+}
+
+void UCombatCrowdSubsystem::UpdateInstances()
+{
+	// gather the transforms for each archetype
+	for (FCombatCrowdArchetype& Archetype : Archetypes)
+	{
+		Archetype.InstanceTransforms.Reset();
+	}
+
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		FCombatCrowdArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+		Archetype.InstanceTransforms.Emplace(FRotator(0.0f, Yaws[Index], 0.0f), Locations[Index] + Archetype.MeshOffset);
+	}
+
+	// push them to the instanced meshes in one batch each
+	for (FCombatCrowdArchetype& Archetype : Archetypes)
+	{
+		UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh;
+
+		if (!IsValid(InstancedMesh))
+		{
+			continue;
+		}
+
+		if (InstancedMesh->GetInstanceCount() != Archetype.InstanceTransforms.Num())
+		{
+			// the instance count changed, so rebuild the instances
+			InstancedMesh->ClearInstances();
+			InstancedMesh->AddInstances(Archetype.InstanceTransforms, false, true, false);
+		}
+		else if (Archetype.InstanceTransforms.Num() > 0)
+		{
+			InstancedMesh->BatchUpdateInstancesTransforms(0, Archetype.InstanceTransforms, true, true, false);
+		}
+	}
+}
+
+void UCombatCrowdSubsystem::UpdatePromotions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GW_CrowdPromotions);
+
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this);
+
+	if (!PlayerInfo)
+	{
+		return;
+	}
+
+	// demote full actors that left combat range
+	const float DemoteDistanceSquared = FMath::Square(DemoteDistance);
+
+	for (int32 Index = PromotedEnemies.Num() - 1; Index >= 0; --Index)
+	{
+		ACombatEnemy* Enemy = PromotedEnemies[Index].Enemy;
+
+		// dead or destroyed enemies are no longer ours to manage. The pool takes care of them
+		if (!IsValid(Enemy) || Enemy->IsDead() || Enemy->IsHidden())
+		{
+			PromotedEnemies.RemoveAtSwap(Index);
+			continue;
+		}
+
+		float DistanceSquared = 0.0f;
+		PlayerInfo->FindNearestPlayer(Enemy->GetActorLocation(), DistanceSquared);
+
+		// don't demote in the middle of an attack
+		if (DistanceSquared > DemoteDistanceSquared && !Enemy->IsAttacking())
+		{
+			DemoteEnemy(Index);
+		}
+	}
+
+	// do we have room for more full actors?
+	const int32 FreeSlots = FMath::Min(MaxFullActors - PromotedEnemies.Num(), MaxPromotionsPerPass);
+
+	if (FreeSlots <= 0 || Locations.Num() == 0)
+	{
+		return;
+	}
+
+	// find every entity in promotion range
+	const float PromoteDistanceSquared = FMath::Square(PromoteDistance);
+
+	PromotionCandidates.Reset();
+
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		float DistanceSquared = 0.0f;
+
+		if (PlayerInfo->FindNearestPlayer(Locations[Index], DistanceSquared) && DistanceSquared <= PromoteDistanceSquared)
+		{
+			PromotionCandidates.Emplace(DistanceSquared, Index);
+		}
+	}
+
+	// nearest entities go first
+	if (PromotionCandidates.Num() > FreeSlots)
+	{
+		PromotionCandidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+		PromotionCandidates.SetNum(FreeSlots, EAllowShrinking::No);
+	}
+
+	// remove entities from the highest index down, so swapping doesn't move an entity we still need
+	PromotionCandidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Value > B.Value; });
+
+	for (const TPair<float, int32>& Candidate : PromotionCandidates)
+	{
+		if (!PromoteEntity(Candidate.Value))
+		{
+			break;
+		}
+	}
+}
+
+bool UCombatCrowdSubsystem::PromoteEntity(int32 EntityIndex)
+{
+	UCombatEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>();
+
+	if (!Pool)
+	{
+		return false;
+	}
+
+	const int32 Archetype = ArchetypeIndices[EntityIndex];
+	const FTransform SpawnTransform(FRotator(0.0f, Yaws[EntityIndex], 0.0f), Locations[EntityIndex]);
+
+	// get a full actor from the pool
+	ACombatEnemy* Enemy = Pool->AcquireEnemy(Archetypes[Archetype].EnemyClass, SpawnTransform);
+
+	if (!Enemy)
+	{
+		return false;
+	}
+
+	// carry over the entity's HP
+	Enemy->SetCurrentHP(HitPoints[EntityIndex]);
+
+	FCombatCrowdPromotedEnemy& Promoted = PromotedEnemies.AddDefaulted_GetRef();
+	Promoted.Enemy = Enemy;
+	Promoted.Archetype = Archetype;
+
+	RemoveEntity(EntityIndex);
+
+	return true;
+}
+
+void UCombatCrowdSubsystem::DemoteEnemy(int32 PromotedIndex)
+{
+	const FCombatCrowdPromotedEnemy Promoted = PromotedEnemies[PromotedIndex];
+	PromotedEnemies.RemoveAtSwap(PromotedIndex);
+
+	ACombatEnemy* Enemy = Promoted.Enemy;
+
+	// carry the actor's state back into the crowd
+	AddEntity(Promoted.Archetype, Enemy->GetActorLocation(), Enemy->GetActorRotation().Yaw, Enemy->GetCurrentHP());
+
+	// put the actor back in the pool
+	if (UCombatEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+	{
+		Pool->ReleaseEnemy(Enemy);
+	}
+}
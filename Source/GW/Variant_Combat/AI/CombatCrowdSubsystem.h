@@ -0,0 +1,181 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatCrowdSubsystem.generated.h"
+
+class ACombatEnemy;
+class UInstancedStaticMeshComponent;
+
+/**
+ *  Shared data for all crowd entities of one enemy class
+ */
+USTRUCT()
+struct FCombatCrowdArchetype
+{
+	GENERATED_BODY()
+
+	/** Enemy class spawned when an entity of this archetype is promoted */
+	UPROPERTY()
+	TSubclassOf<ACombatEnemy> EnemyClass;
+
+	/** Instanced mesh that draws every entity of this archetype */
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> InstancedMesh;
+
+	/** Max HP of the enemy class, so entities can start at full health */
+	float MaxHP = 0.0f;
+
+	/** Offset from the entity location (capsule center) to the mesh pivot */
+	FVector MeshOffset = FVector::ZeroVector;
+
+	/** Instance transforms, reused every frame to avoid reallocating */
+	TArray<FTransform> InstanceTransforms;
+};
+
+/**
+ *  A full enemy actor that was promoted from the crowd
+ */
+USTRUCT()
+struct FCombatCrowdPromotedEnemy
+{
+	GENERATED_BODY()
+
+	/** Promoted actor */
+	UPROPERTY()
+	TObjectPtr<ACombatEnemy> Enemy;
+
+	/** Archetype the enemy came from, so it can be demoted back into it */
+	int32 Archetype = 0;
+};
+
+/**
+ *  Lightweight crowd representation for distant combat enemies.
+ *  Crowd entities are stored as packed arrays and simulated in a single loop with simple
+ *  steering towards the nearest player. Each enemy class is drawn with one instanced mesh.
+ *  Entities that come within combat range are promoted to full pooled ACombatEnemy actors,
+ *  and actors that wander out of range are demoted back. HP, location and facing carry across.
+ *  Crowd and actor counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class UCombatCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Per-class archetypes */
+	UPROPERTY()
+	TArray<FCombatCrowdArchetype> Archetypes;
+
+	/** Enemies currently promoted to full actors */
+	UPROPERTY()
+	TArray<FCombatCrowdPromotedEnemy> PromotedEnemies;
+
+	/** Actor that owns the instanced mesh components */
+	UPROPERTY()
+	TObjectPtr<AActor> RenderActor;
+
+	/** Crowd entity locations */
+	TArray<FVector> Locations;
+
+	/** Crowd entity facing yaws */
+	TArray<float> Yaws;
+
+	/** Crowd entity HP */
+	TArray<float> HitPoints;
+
+	/** Crowd entity archetype indices */
+	TArray<int32> ArchetypeIndices;
+
+	/** Scratch list of entities in promotion range, reused every frame */
+	TArray<TPair<float, int32>> PromotionCandidates;
+
+	/** Time accumulated since the last promotion pass */
+	float TimeSincePromotionPass = 0.0f;
+
+protected:
+
+	/** Crowd entities closer than this to a player are promoted to full actors */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float PromoteDistance = 2000.0f;
+
+	/** Full actors farther than this from every player are demoted back to the crowd. Should be larger than the promote distance */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float DemoteDistance = 2600.0f;
+
+	/** Max number of full actors at the same time */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 500))
+	int32 MaxFullActors = 40;
+
+	/** Max number of promotions in a single pass, to spread actor activation over several frames */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 1, ClampMax = 100))
+	int32 MaxPromotionsPerPass = 4;
+
+	/** Time between promotion and demotion passes */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float PromotionInterval = 0.1f;
+
+	/** Speed crowd entities move towards the nearest player */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 2000, Units = "cm/s"))
+	float CrowdMoveSpeed = 250.0f;
+
+	/** Crowd entities stop advancing once they're this close to a player, and wait to be promoted */
+	UPROPERTY(Config, EditAnywhere, Category="Crowd", meta = (ClampMin = 0, ClampMax = 100000, Units = "cm"))
+	float CrowdHoldDistance = 1500.0f;
+
+public:
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Cleanup */
+	virtual void Deinitialize() override;
+
+	/** Simulates the crowd, updates instanced rendering and promotes or demotes enemies */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds a single crowd entity at full HP */
+	void AddCrowdEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform);
+
+	/** Scatters a number of crowd entities in a circle. Returns the number added */
+	UFUNCTION(BlueprintCallable, Category="Crowd")
+	int32 AddCrowdEnemies(TSubclassOf<ACombatEnemy> EnemyClass, FVector Center, float Radius, int32 Count);
+
+	/** Returns the number of enemies living as crowd entities */
+	UFUNCTION(BlueprintPure, Category="Crowd")
+	int32 GetNumCrowdEnemies() const { return Locations.Num(); }
+
+	/** Returns the number of enemies currently promoted to full actors */
+	UFUNCTION(BlueprintPure, Category="Crowd")
+	int32 GetNumFullActors() const { return PromotedEnemies.Num(); }
+
+protected:
+
+	/** Returns the archetype index for the class, creating it if needed */
+	int32 FindOrAddArchetype(TSubclassOf<ACombatEnemy> EnemyClass);
+
+	/** Adds an entity to the packed arrays */
+	void AddEntity(int32 Archetype, const FVector& Location, float Yaw, float HP);
+
+	/** Removes an entity from the packed arrays */
+	void RemoveEntity(int32 EntityIndex);
+
+	/** Moves every crowd entity towards the nearest player */
+	void SimulateCrowd(float DeltaTime);
+
+	/** Pushes entity transforms to the instanced meshes */
+	void UpdateInstances();
+
+	/** Demotes full actors that left combat range, and promotes the nearest entities in range */
+	void UpdatePromotions();
+
+	/** Turns a crowd entity into a full actor */
+	bool PromoteEntity(int32 EntityIndex);
+
+	/** Turns a full actor back into a crowd entity */
+	void DemoteEnemy(int32 PromotedIndex);
+};
@@ -0,0 +1,175 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatDirectorSubsystem.h"
+#include "CombatEnemy.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Tokens Held"), STAT_GW_AttackTokensHeld, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attack Tokens Pending"), STAT_GW_AttackTokensPending, STATGROUP_GW);
+
+bool UCombatDirectorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDirectorSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, Director);
+
+	Super::Tick(DeltaTime);
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// reclaim tokens from dead, destroyed or stuck enemies, and from enemies that never used theirs
+	for (int32 Index = TokenHolders.Num() - 1; Index >= 0; --Index)
+	{
+		FCombatAttackTokenHolder& Holder = TokenHolders[Index];
+		const ACombatEnemy* Enemy = Holder.Enemy.Get();
+
+		if (!IsValid(Enemy) || Enemy->IsDead() || CurrentTime - Holder.GrantTime > TokenExpiration)
+		{
+			TokenHolders.RemoveAtSwap(Index);
+			continue;
+		}
+
+		Holder.bClaimed |= Enemy->IsAttacking();
+
+		if (!Holder.bClaimed && CurrentTime - Holder.GrantTime > TokenClaimTimeout)
+		{
+			TokenHolders.RemoveAtSwap(Index);
+		}
+	}
+
+	// drop requests that weren't renewed or that came from enemies that can no longer attack
+	for (int32 Index = PendingRequests.Num() - 1; Index >= 0; --Index)
+	{
+		const ACombatEnemy* Enemy = PendingRequests[Index].Enemy.Get();
+
+		if (!IsValid(Enemy) || Enemy->IsDead() || CurrentTime - PendingRequests[Index].LastRequestTime > RequestExpiration)
+		{
+			PendingRequests.RemoveAtSwap(Index);
+		}
+	}
+
+	// hand out any free tokens in priority order
+	const int32 FreeTokens = MaxAttackTokens - TokenHolders.Num();
+
+	if (FreeTokens > 0 && PendingRequests.Num() > 0)
+	{
+		// only prioritize if there are more requests than tokens
+		if (PendingRequests.Num() > FreeTokens)
+		{
+			for (FCombatAttackTokenRequest& Request : PendingRequests)
+			{
+				Request.Priority = GetRequestPriority(Request, CurrentTime);
+			}
+
+			PendingRequests.Sort([](const FCombatAttackTokenRequest& A, const FCombatAttackTokenRequest& B)
+			{
+				return A.Priority > B.Priority;
+			});
+		}
+
+		const int32 NumToGrant = FMath::Min(FreeTokens, PendingRequests.Num());
+
+		for (int32 Index = 0; Index < NumToGrant; ++Index)
+		{
+			GrantToken(PendingRequests[Index].Enemy.Get(), CurrentTime);
+		}
+
+		PendingRequests.RemoveAt(0, NumToGrant, EAllowShrinking::No);
+	}
+
+	SET_DWORD_STAT(STAT_GW_AttackTokensHeld, TokenHolders.Num());
+	SET_DWORD_STAT(STAT_GW_AttackTokensPending, PendingRequests.Num());
+}
+
+TStatId UCombatDirectorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDirectorSubsystem, STATGROUP_Tickables);
+}
+
+bool UCombatDirectorSubsystem::TryAcquireAttackToken(ACombatEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsDead())
+	{
+		return false;
+	}
+
+	// do we already hold a token?
+	if (HasAttackToken(Enemy))
+	{
+		return true;
+	}
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// grant right away if there's a free token and nobody is ahead of us in line
+	if (TokenHolders.Num() < MaxAttackTokens && PendingRequests.Num() == 0)
+	{
+		GrantToken(Enemy, CurrentTime);
+		return true;
+	}
+
+	// renew our request if we're already waiting
+	for (FCombatAttackTokenRequest& Request : PendingRequests)
+	{
+		if (Request.Enemy == Enemy)
+		{
+			Request.LastRequestTime = CurrentTime;
+			return false;
+		}
+	}
+
+	// get in line
+	FCombatAttackTokenRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Enemy = Enemy;
+	Request.FirstRequestTime = CurrentTime;
+	Request.LastRequestTime = CurrentTime;
+
+	return false;
+}
+
+bool UCombatDirectorSubsystem::HasAttackToken(const ACombatEnemy* Enemy) const
+{
+	return TokenHolders.ContainsByPredicate([Enemy](const FCombatAttackTokenHolder& Holder) { return Holder.Enemy == Enemy; });
+}
+
+void UCombatDirectorSubsystem::ReleaseAttackToken(const ACombatEnemy* Enemy)
+{
+	TokenHolders.RemoveAllSwap([Enemy](const FCombatAttackTokenHolder& Holder) { return Holder.Enemy == Enemy; });
+	PendingRequests.RemoveAllSwap([Enemy](const FCombatAttackTokenRequest& Request) { return Request.Enemy == Enemy; });
+}
+
+float UCombatDirectorSubsystem::GetRequestPriority(const FCombatAttackTokenRequest& Request, float CurrentTime) const
+{
+	float Priority = (CurrentTime - Request.FirstRequestTime) * WaitTimeWeight;
+
+	// closer enemies go first
+	if (const ACombatEnemy* Enemy = Request.Enemy.Get())
+	{
+		if (UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this))
+		{
+			float DistanceSquared = 0.0f;
+
+			if (PlayerInfo->FindNearestPlayer(Enemy->GetActorLocation(), DistanceSquared))
+			{
+				Priority -= FMath::Sqrt(DistanceSquared) * DistanceWeight;
+			}
+		}
+	}
+
+	return Priority;
+}
+
+void UCombatDirectorSubsystem::GrantToken(ACombatEnemy* Enemy, float CurrentTime)
+{
+	FCombatAttackTokenHolder& Holder = TokenHolders.AddDefaulted_GetRef();
+	Holder.Enemy = Enemy;
+	Holder.GrantTime = CurrentTime;
+}
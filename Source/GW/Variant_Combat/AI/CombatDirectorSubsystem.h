@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDirectorSubsystem.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  An enemy waiting for an attack token
+ */
+USTRUCT()
+struct FCombatAttackTokenRequest
+{
+	GENERATED_BODY()
+
+	/** Enemy asking for the token */
+	TWeakObjectPtr<ACombatEnemy> Enemy;
+
+	/** World time the enemy first asked for a token */
+	float FirstRequestTime = 0.0f;
+
+	/** World time the enemy last renewed its request */
+	float LastRequestTime = 0.0f;
+
+	/** Grant priority, computed right before tokens are handed out */
+	float Priority = 0.0f;
+};
+
+/**
+ *  An enemy currently holding an attack token
+ */
+USTRUCT()
+struct FCombatAttackTokenHolder
+{
+	GENERATED_BODY()
+
+	/** Enemy holding the token */
+	TWeakObjectPtr<ACombatEnemy> Enemy;
+
+	/** World time the token was granted */
+	float GrantTime = 0.0f;
+
+	/** True once the enemy started attacking with the token */
+	bool bClaimed = false;
+};
+
+/**
+ *  Coordinates melee attacks across all combat enemies.
+ *  Enemies must hold one of a limited number of attack tokens before they start an attack,
+ *  which bounds the number of attack montages, melee sweeps and damage events in flight.
+ *  Waiting enemies are granted tokens in priority order, favoring enemies close to a player
+ *  and enemies that have waited the longest.
+ *  Token counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class UCombatDirectorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Enemies waiting for a token */
+	TArray<FCombatAttackTokenRequest> PendingRequests;
+
+	/** Enemies currently holding a token */
+	TArray<FCombatAttackTokenHolder> TokenHolders;
+
+protected:
+
+	/** Max number of enemies that may be attacking at the same time */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 1, ClampMax = 100))
+	int32 MaxAttackTokens = 3;
+
+	/** Priority gained per second spent waiting for a token */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 0, ClampMax = 100))
+	float WaitTimeWeight = 1.0f;
+
+	/** Priority lost per cm of distance to the nearest player */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 0, ClampMax = 1))
+	float DistanceWeight = 0.001f;
+
+	/** Requests that aren't renewed within this time are dropped */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float RequestExpiration = 1.0f;
+
+	/** Tokens that aren't used for an attack within this time are reclaimed, e.g. when the enemy was granted
+	 *  a token on the same frame it was hit and left for a hit reaction instead of attacking */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float TokenClaimTimeout = 1.0f;
+
+	/** Tokens held longer than this are reclaimed, in case an attack never reports completion */
+	UPROPERTY(Config, EditAnywhere, Category="Combat Director", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float TokenExpiration = 8.0f;
+
+public:
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Expires stale requests and tokens, then grants free tokens to the highest priority requests */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Attempts to get an attack token for the enemy.
+	 *  Returns true if the enemy holds a token, either from before or granted immediately because one was free and nobody else is waiting.
+	 *  Otherwise the enemy is queued (or its request renewed) and will be granted a token on a later frame.
+	 */
+	bool TryAcquireAttackToken(ACombatEnemy* Enemy);
+
+	/** Returns true if the enemy currently holds an attack token */
+	bool HasAttackToken(const ACombatEnemy* Enemy) const;
+
+	/** Releases the enemy's attack token and cancels any pending request it has */
+	void ReleaseAttackToken(const ACombatEnemy* Enemy);
+
+protected:
+
+	/** Computes the grant priority for a pending request. Higher goes first */
+	float GetRequestPriority(const FCombatAttackTokenRequest& Request, float CurrentTime) const;
+
+	/** Gives a token to the enemy */
+	void GrantToken(ACombatEnemy* Enemy, float CurrentTime);
+};
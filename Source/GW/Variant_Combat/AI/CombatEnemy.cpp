@@ -5,16 +5,22 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "CombatAIController.h"
-#include "Components/WidgetComponent.h"
 #include "Engine/DamageEvents.h"
-#include "CombatLifeBar.h"
 #include "TimerManager.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "SkeletalMeshComponentBudgeted.h"
 #include "Animation/AnimInstance.h"
-
-ACombatEnemy::ACombatEnemy()
+#include "Components/StateTreeAIComponent.h"
+#include "CombatDirectorSubsystem.h"
+#include "CombatEnemyPoolSubsystem.h"
+#include "Gameplay/Subsystems/RagdollBudgetSubsystem.h"
+#include "Gameplay/Subsystems/EnemyHealthBarSubsystem.h"
+#include "Gameplay/Subsystems/HealthUISubsystem.h"
+
+ACombatEnemy::ACombatEnemy(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	// bind the attack montage ended delegate
 	OnAttackMontageEnded.BindUObject(this, &ACombatEnemy::AttackMontageEnded);
@@ -28,16 +34,15 @@ ACombatEnemy::ACombatEnemy()
 	// ignore the controller's yaw rotation
 	bUseControllerRotationYaw = false;
 
-	// create the life bar
-	LifeBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("LifeBar"));
-	LifeBar->SetupAttachment(RootComponent);
-
 	// set the collision capsule size
 	GetCapsuleComponent()->SetCapsuleSize(35.0f, 90.0f);
 
 	// set the character movement properties
 	GetCharacterMovement()->bUseControllerDesiredRotation = true;
 
+	// allow the mesh to throttle its animation when the budget allocator isn't running
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+
 	// reset HP to maximum
 	CurrentHP = MaxHP;
 }
@@ -53,6 +58,9 @@ void ACombatEnemy::DoAIComboAttack()
 	// raise the attacking flag
 	bIsAttacking = true;
 
+	// make sure we're running at full rate so the attack and its notifies aren't delayed
+	PromoteAILOD();
+
 	// choose how many times we're going to attack
 	TargetComboCount = FMath::RandRange(1, ComboSectionNames.Num() - 1);
 
@@ -84,6 +92,9 @@ void ACombatEnemy::DoAIChargedAttack()
 	// raise the attacking flag
 	bIsAttacking = true;
 
+	// make sure we're running at full rate so the attack and its notifies aren't delayed
+	PromoteAILOD();
+
 	// choose how many loops are we going to charge for
 	TargetChargeLoops = FMath::RandRange(MinChargeLoops, MaxChargeLoops);
 
@@ -113,6 +124,86 @@ void ACombatEnemy::AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 	OnAttackCompleted.ExecuteIfBound();
 }
 
+void ACombatEnemy::SetCurrentHP(float NewHP)
+{
+	if (HealthStore)
+	{
+		HealthStore->SetHealth(HealthHandle, NewHP);
+	}
+	else
+	{
+		CurrentHP = FMath::Clamp(NewHP, 0.0f, MaxHP);
+	}
+
+	RefreshHP();
+}
+
+void ACombatEnemy::RefreshHP()
+{
+	// copy the HP from the store so bindings see it
+	if (HealthStore)
+	{
+		CurrentHP = HealthStore->GetHealth(HealthHandle);
+	}
+
+	// queue a life bar update
+	UHealthUISubsystem::MarkDirty(this, this);
+}
+
+void ACombatEnemy::FlushHealthUI()
+{
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->SetHealthPercent(this, CurrentHP / MaxHP);
+	}
+}
+
+void ACombatEnemy::ApplyAILOD(ECombatAILOD NewTier, const FCombatAILODTierSettings& Settings)
+{
+	CurrentAILOD = NewTier;
+
+	// set the actor and component tick intervals
+	SetActorTickInterval(Settings.ActorTickInterval);
+	GetCharacterMovement()->SetComponentTickInterval(Settings.MovementTickInterval);
+	GetMesh()->SetComponentTickInterval(Settings.MeshTickInterval);
+
+	// slow down the StateTree on the AI Controller
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+		{
+			StateTreeAI->SetComponentTickInterval(Settings.StateTreeTickInterval);
+		}
+	}
+}
+
+void ACombatEnemy::ApplyAnimationSignificance(float Significance, bool bUseBudgetAllocator)
+{
+	// attacking enemies must evaluate every animation frame so their attack traces aren't late
+	const bool bNeverSkip = bIsAttacking;
+
+	if (bUseBudgetAllocator)
+	{
+		if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+		{
+			// attacking enemies also tick while off screen, since the attack hits regardless
+			BudgetedMesh->SetComponentSignificance(Significance, bNeverSkip, bNeverSkip);
+			return;
+		}
+	}
+
+	// fall back to update rate optimizations, paused for the duration of the attack
+	GetMesh()->bEnableUpdateRateOptimizations = !bNeverSkip;
+}
+
+void ACombatEnemy::PromoteAILOD()
+{
+	if (UCombatAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UCombatAILODSubsystem>())
+	{
+		AILOD->PromoteToHigh(this);
+	}
+}
+
 void ACombatEnemy::DoAttackTrace(FName DamageSourceBone)
 {
 	// sweep for objects in front of the character to be hit by the attack
@@ -197,6 +288,10 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 	// only process knockback and effects if we received nonzero damage
 	if (ActualDamage > 0.0f)
 	{
+		// react to the hit at full rate, and keep the AI LOD from dropping us mid hit reaction
+		LastDamageTime = GetWorld()->GetTimeSeconds();
+		PromoteAILOD();
+
 		// apply the knockback impulse
 		GetCharacterMovement()->AddImpulse(DamageImpulse, true);
 
@@ -221,8 +316,11 @@ void ACombatEnemy::ApplyDamage(float Damage, AActor* DamageCauser, const FVector
 
 void ACombatEnemy::HandleDeath()
 {
-	// hide the life bar
-	LifeBar->SetHiddenInGame(true);
+	// remove the life bar
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->UnregisterHealthBar(this);
+	}
 
 	// disable the collision capsule to avoid being hit again while dead
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -230,8 +328,21 @@ void ACombatEnemy::HandleDeath()
 	// disable character movement
 	GetCharacterMovement()->DisableMovement();
 
-	// enable full ragdoll physics
-	GetMesh()->SetSimulatePhysics(true);
+	// enable full ragdoll physics through the ragdoll budget
+	if (URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this))
+	{
+		RagdollBudget->RequestRagdoll(GetMesh());
+	}
+	else
+	{
+		GetMesh()->SetSimulatePhysics(true);
+	}
+
+	// give back our attack token so another enemy can attack
+	if (UCombatDirectorSubsystem* Director = GetWorld()->GetSubsystem<UCombatDirectorSubsystem>())
+	{
+		Director->ReleaseAttackToken(this);
+	}
 
 	// call the died delegate to notify any subscribers
 	OnEnemyDied.Broadcast();
@@ -245,8 +356,149 @@ void ACombatEnemy::ApplyHealing(float Healing, AActor* Healer)
 	// stub
 }
 
+void ACombatEnemy::ActivateFromPool(const FTransform& SpawnTransform, bool bAdjustForCollision)
+{
+	// move to the spawn point, adjusting the location if something's in the way
+	TeleportTo(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, !bAdjustForCollision);
+
+	// bring back HP, ragdoll, collision and movement
+	ResetForReuse();
+
+	// show the actor and turn ticking back on
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetMesh()->SetComponentTickEnabled(true);
+
+	// rejoin the AI LOD evaluation at full rate
+	if (UCombatAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UCombatAILODSubsystem>())
+	{
+		ApplyAILOD(ECombatAILOD::High, AILOD->GetTierSettings(ECombatAILOD::High));
+		AILOD->RegisterEnemy(this);
+	}
+
+	// make sure we still have an AI Controller, unless we're not meant to get one
+	if (!GetController() && AutoPossessAI != EAutoPossessAI::Disabled)
+	{
+		SpawnDefaultController();
+	}
+
+	// restart the StateTree from the top
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+		{
+			StateTreeAI->RestartLogic();
+		}
+	}
+}
+
+void ACombatEnemy::DeactivateForPool()
+{
+	// stop any pending removal
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// death subscribers belong to whoever spawned us last
+	OnEnemyDied.Clear();
+
+	// stop the StateTree and any movement requests
+	if (ACombatAIController* AIController = Cast<ACombatAIController>(GetController()))
+	{
+		AIController->StopMovement();
+		AIController->ClearFocus(EAIFocusPriority::Gameplay);
+
+		if (UStateTreeAIComponent* StateTreeAI = AIController->GetStateTreeAI())
+		{
+			StateTreeAI->StopLogic(TEXT("Returned to pool"));
+		}
+	}
+
+	// leave the AI LOD evaluation and give back any attack token
+	if (UCombatAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UCombatAILODSubsystem>())
+	{
+		AILOD->UnregisterEnemy(this);
+	}
+
+	if (UCombatDirectorSubsystem* Director = GetWorld()->GetSubsystem<UCombatDirectorSubsystem>())
+	{
+		Director->ReleaseAttackToken(this);
+	}
+
+	// remove the life bar
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->UnregisterHealthBar(this);
+	}
+
+	// stop the ragdoll so it doesn't keep simulating while hidden
+	if (URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this))
+	{
+		RagdollBudget->ReleaseRagdoll(GetMesh());
+	}
+
+	GetMesh()->SetSimulatePhysics(false);
+
+	// hide the actor and turn everything off
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+}
+
+void ACombatEnemy::ResetForReuse()
+{
+	// reset HP to maximum
+	if (HealthStore)
+	{
+		HealthStore->ResetEntry(HealthHandle);
+	}
+
+	CurrentHP = MaxHP;
+
+	// stop any attacks that were interrupted by death
+	bIsAttacking = false;
+
+	if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+	{
+		AnimInstance->StopAllMontages(0.0f);
+	}
+
+	// reset the ragdoll and put the mesh back on the capsule
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	GetMesh()->SetRelativeTransform(MeshStartingTransform);
+
+	// restore collision
+	SetActorEnableCollision(true);
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+	// restore movement
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	// show and fill the life bar
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->RegisterHealthBar(this, LifeBarHeight, 1.0f);
+	}
+}
+
 void ACombatEnemy::RemoveFromLevel()
 {
+	// pooled enemies go back to the pool
+	if (bIsPooled)
+	{
+		if (UCombatEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+		{
+			Pool->ReleaseEnemy(this);
+			return;
+		}
+	}
+
 	// destroy this actor
 	Destroy();
 }
@@ -254,28 +506,45 @@ void ACombatEnemy::RemoveFromLevel()
 float ACombatEnemy::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	if (IsDead())
 	{
 		return 0.0f;
 	}
 
-	// reduce the current HP
-	CurrentHP -= Damage;
+	// reduce the current HP. Without a health store, e.g. outside game worlds, we keep the HP ourselves
+	bool bKilled = false;
+
+	if (HealthStore)
+	{
+		HealthStore->ApplyDamage(HealthHandle, Damage, bKilled);
+		CurrentHP = HealthStore->GetHealth(HealthHandle);
+	}
+	else if (Damage > 0.0f)
+	{
+		CurrentHP = FMath::Max(CurrentHP - Damage, 0.0f);
+		bKilled = CurrentHP <= 0.0f;
+	}
 
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (bKilled)
 	{
 		// die
 		HandleDeath();
 	}
 	else
 	{
-		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		// queue a life bar update. multiple hits in a frame only update it once
+		UHealthUISubsystem::MarkDirty(this, this);
+
+		// enable partial ragdoll physics, but keep the pelvis vertical.
+		// skip it if there are already too many ragdolls simulating
+		const URagdollBudgetSubsystem* RagdollBudget = URagdollBudgetSubsystem::Get(this);
 
-		// enable partial ragdoll physics, but keep the pelvis vertical
-		GetMesh()->SetPhysicsBlendWeight(0.5f);
-		GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		if (!RagdollBudget || RagdollBudget->CanAffordHitReaction())
+		{
+			GetMesh()->SetPhysicsBlendWeight(0.5f);
+			GetMesh()->SetBodySimulatePhysics(PelvisBoneName, false);
+		}
 	}
 
 	// return the received damage amount
@@ -299,18 +568,33 @@ void ACombatEnemy::Landed(const FHitResult& Hit)
 
 void ACombatEnemy::BeginPlay()
 {
-	// reset HP to maximum
+	// take an entry in the health store at max HP
+	HealthStore = UHealthStoreSubsystem::Get(this);
+
+	if (HealthStore)
+	{
+		HealthHandle = HealthStore->Register(this, MaxHP);
+	}
+
 	CurrentHP = MaxHP;
 
 	// we top the HP before BeginPlay so StateTree picks it up at the right value
 	Super::BeginPlay();
 
-	// get the life bar widget from the widget comp
-	LifeBarWidget = Cast<UCombatLifeBar>(LifeBar->GetUserWidgetObject());
-	check(LifeBarWidget);
+	// add a full life bar to the HUD overlay
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->RegisterHealthBar(this, LifeBarHeight, 1.0f);
+	}
+
+	// save the relative transform for the mesh so we can reset the ragdoll when we're reused
+	MeshStartingTransform = GetMesh()->GetRelativeTransform();
 
-	// fill the life bar
-	LifeBarWidget->SetLifePercentage(1.0f);
+	// register with the AI LOD subsystem
+	if (UCombatAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UCombatAILODSubsystem>())
+	{
+		AILOD->RegisterEnemy(this);
+	}
 }
 
 void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -319,4 +603,28 @@ void ACombatEnemy::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// unregister from the AI LOD subsystem
+	if (UCombatAILODSubsystem* AILOD = GetWorld()->GetSubsystem<UCombatAILODSubsystem>())
+	{
+		AILOD->UnregisterEnemy(this);
+	}
+
+	// release any attack token we might be holding
+	if (UCombatDirectorSubsystem* Director = GetWorld()->GetSubsystem<UCombatDirectorSubsystem>())
+	{
+		Director->ReleaseAttackToken(this);
+	}
+
+	// remove the life bar
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
+	{
+		HealthBars->UnregisterHealthBar(this);
+	}
+
+	// release our health store entry
+	if (HealthStore)
+	{
+		HealthStore->Unregister(HealthHandle);
+	}
 }
@@ -8,11 +8,13 @@
 #include "CombatDamageable.h"
 #include "Animation/AnimMontage.h"
 #include "Engine/TimerHandle.h"
+#include "CombatAILODSubsystem.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "Gameplay/Interfaces/HealthUIOwner.h"
 #include "CombatEnemy.generated.h"
 
-class UWidgetComponent;
-class UCombatLifeBar;
 class UAnimMontage;
+class UStaticMesh;
 
 /** Completed attack animation delegate for StateTree */
 DECLARE_DELEGATE(FOnEnemyAttackCompleted);
@@ -28,18 +30,14 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnEnemyDied);
  *  Its bundled AI Controller runs logic through StateTree
  */
 UCLASS(abstract)
-class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable
+class ACombatEnemy : public ACharacter, public ICombatAttacker, public ICombatDamageable, public IHealthUIOwner
 {
 	GENERATED_BODY()
 
-	/** Life bar widget component */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
-	UWidgetComponent* LifeBar;
-
 public:
 	
-	/** Constructor */
-	ACombatEnemy();
+	/** Constructor. Swaps the mesh for one that works with the animation budget allocator */
+	ACombatEnemy(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
@@ -49,19 +47,26 @@ protected:
 
 public:
 
-	/** Current amount of HP the character has */
+	/** Current amount of HP the character has. Mirrors our health store entry so StateTree and Blueprint can bind to it, or holds the HP itself if there's no store */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float CurrentHP = 0.0f;
 
 protected:
 
+	/** Health store holding our HP */
+	UPROPERTY(Transient)
+	TObjectPtr<UHealthStoreSubsystem> HealthStore;
+
+	/** Our entry in the health store */
+	FHealthHandle HealthHandle;
+
 	/** Name of the pelvis bone, for damage ragdoll physics */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName PelvisBoneName;
 
-	/** Pointer to the life bar widget */
-	UPROPERTY(EditAnywhere, Category="Damage")
-	UCombatLifeBar* LifeBarWidget;
+	/** Height above the actor's location to draw the life bar at. Bars are drawn by the HUD's enemy health bar overlay */
+	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 500, Units = "cm"))
+	float LifeBarHeight = 120.0f;
 
 	/** If true, the character is currently playing an attack animation */
 	bool bIsAttacking = false;
@@ -126,6 +131,10 @@ protected:
 	/** Number of charge animation loop currently playing */
 	int32 CurrentChargeLoop = 0;
 
+	/** Static mesh used to draw this enemy while it's part of the distant crowd */
+	UPROPERTY(EditAnywhere, Category="Crowd")
+	TObjectPtr<UStaticMesh> CrowdProxyMesh;
+
 	/** Time to wait before removing this character from the level after it dies */
 	UPROPERTY(EditAnywhere, Category="Death")
 	float DeathRemovalTime = 5.0f;
@@ -136,6 +145,18 @@ protected:
 	/** Attack montage ended delegate */
 	FOnMontageEnded OnAttackMontageEnded;
 
+	/** AI LOD tier this enemy is currently running at */
+	ECombatAILOD CurrentAILOD = ECombatAILOD::High;
+
+	/** World time this enemy last took damage */
+	float LastDamageTime = -UE_BIG_NUMBER;
+
+	/** If true, this enemy is managed by the enemy pool and will be returned to it instead of destroyed */
+	bool bIsPooled = false;
+
+	/** Relative transform of the mesh on BeginPlay, so the ragdoll can be reset when the enemy is reused */
+	FTransform MeshStartingTransform;
+
 public:
 	/** Attack completed internal delegate to notify StateTree tasks */
 	FOnEnemyAttackCompleted OnAttackCompleted;
@@ -158,6 +179,53 @@ public:
 	/** Called from a delegate when the attack montage ends */
 	void AttackMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
+	/** Returns true if the character is currently playing an attack animation */
+	bool IsAttacking() const { return bIsAttacking; }
+
+	/** Returns the world time this enemy last took damage */
+	float GetLastDamageTime() const { return LastDamageTime; }
+
+	/** Returns true if the character has run out of HP */
+	bool IsDead() const { return HealthStore ? !HealthStore->IsAlive(HealthHandle) : CurrentHP <= 0.0f; }
+
+	/** Returns the max HP the character spawns with */
+	float GetMaxHP() const { return MaxHP; }
+
+	/** Returns the current HP, from the health store if there is one */
+	float GetCurrentHP() const { return HealthStore ? HealthStore->GetHealth(HealthHandle) : CurrentHP; }
+
+	/** Sets the current HP and updates the life bar, e.g. to carry HP over from a crowd entity */
+	void SetCurrentHP(float NewHP);
+
+	/** Returns our entry in the health store, for bulk health operations */
+	const FHealthHandle& GetHealthHandle() const { return HealthHandle; }
+
+	/** Copies the HP from the health store and queues a life bar update. Call after changing our entry through bulk health operations */
+	void RefreshHP();
+
+	/** Returns the mesh used to draw this enemy in the distant crowd */
+	UStaticMesh* GetCrowdProxyMesh() const { return CrowdProxyMesh; }
+
+public:
+
+	/** Returns the AI LOD tier this enemy is currently running at */
+	ECombatAILOD GetAILOD() const { return CurrentAILOD; }
+
+	/** Applies the tick intervals for an AI LOD tier to the actor, its components and its AI Controller */
+	void ApplyAILOD(ECombatAILOD NewTier, const FCombatAILODTierSettings& Settings);
+
+	/**
+	 *  Passes the mesh's significance to the animation budget allocator.
+	 *  While attacking, the mesh is never skipped so attack trace notifies fire on the right frame.
+	 *  Without the allocator, update rate optimizations are used instead, and turned off while attacking
+	 */
+	void ApplyAnimationSignificance(float Significance, bool bUseBudgetAllocator);
+
+protected:
+
+	/** Raises this enemy to full rate AI LOD, e.g. before attacking or reacting to damage */
+	void PromoteAILOD();
+
 public:
 
 	// ~begin ICombatAttacker interface
@@ -188,9 +256,33 @@ public:
 
 	// ~end ICombatDamageable interface
 
+	// ~begin IHealthUIOwner interface
+
+	/** Pushes the current HP to the life bar */
+	virtual void FlushHealthUI() override;
+
+	// ~end IHealthUIOwner interface
+
+public:
+
+	/** Flags this enemy as managed by the enemy pool */
+	void MarkAsPooled() { bIsPooled = true; }
+
+	/** Returns true if this enemy is managed by the enemy pool */
+	bool IsPooled() const { return bIsPooled; }
+
+	/** Moves a pooled enemy to the spawn transform and brings it back to life */
+	void ActivateFromPool(const FTransform& SpawnTransform, bool bAdjustForCollision = true);
+
+	/** Hides a pooled enemy and stops all of its ticking, collision and AI so it can wait in the pool */
+	void DeactivateForPool();
+
 protected:
 
-	/** Removes this character from the level after it dies */
+	/** Restores HP, the life bar, ragdoll, collision and movement to their initial state */
+	void ResetForReuse();
+
+	/** Removes this character from the level after it dies. Pooled enemies are returned to the pool instead of destroyed */
 	void RemoveFromLevel();
 
 public:
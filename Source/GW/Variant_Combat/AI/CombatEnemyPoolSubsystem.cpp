@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnemyPoolSubsystem.h"
+#include "CombatEnemy.h"
+#include "Engine/World.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Enemies Active"), STAT_GW_PooledEnemiesActive, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Enemies Inactive"), STAT_GW_PooledEnemiesInactive, STATGROUP_GW);
+
+bool UCombatEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatEnemyPoolSubsystem::WarmPool(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& StashTransform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return;
+	}
+
+	const int32 NumMissing = Count - GetNumInactive(EnemyClass);
+
+	for (int32 Index = 0; Index < NumMissing; ++Index)
+	{
+		AddInactiveEnemy(EnemyClass, StashTransform);
+	}
+}
+
+bool UCombatEnemyPoolSubsystem::AddInactiveEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& StashTransform)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return false;
+	}
+
+	ACombatEnemy* Enemy = SpawnPooledEnemy(EnemyClass, StashTransform, true);
+
+	if (Enemy)
+	{
+		// put it straight to sleep
+		Enemy->DeactivateForPool();
+		Pools.FindOrAdd(EnemyClass).InactiveEnemies.Add(Enemy);
+	}
+
+	UpdateStats();
+
+	return Enemy != nullptr;
+}
+
+ACombatEnemy* UCombatEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform, bool bAdjustForCollision)
+{
+	if (!IsValid(EnemyClass))
+	{
+		return nullptr;
+	}
+
+	FCombatEnemyPool& Pool = Pools.FindOrAdd(EnemyClass);
+	ACombatEnemy* Enemy = nullptr;
+
+	// reuse an inactive enemy if we have one
+	while (!Enemy && Pool.InactiveEnemies.Num() > 0)
+	{
+		Enemy = Pool.InactiveEnemies.Pop(EAllowShrinking::No);
+
+		// skip any enemies that were destroyed behind our back
+		if (IsValid(Enemy))
+		{
+			Enemy->ActivateFromPool(SpawnTransform, bAdjustForCollision);
+		}
+		else
+		{
+			Enemy = nullptr;
+		}
+	}
+
+	// grow the pool if we ran out
+	if (!Enemy)
+	{
+		Enemy = SpawnPooledEnemy(EnemyClass, SpawnTransform, bAdjustForCollision);
+	}
+
+	if (Enemy)
+	{
+		++Pool.ActiveCount;
+	}
+
+	UpdateStats();
+
+	return Enemy;
+}
+
+void UCombatEnemyPoolSubsystem::ReleaseEnemy(ACombatEnemy* Enemy)
+{
+	if (!IsValid(Enemy))
+	{
+		return;
+	}
+
+	// deactivate the enemy in place
+	Enemy->DeactivateForPool();
+
+	FCombatEnemyPool& Pool = Pools.FindOrAdd(Enemy->GetClass());
+	Pool.InactiveEnemies.AddUnique(Enemy);
+	Pool.ActiveCount = FMath::Max(0, Pool.ActiveCount - 1);
+
+	UpdateStats();
+}
+
+int32 UCombatEnemyPoolSubsystem::GetNumInactive(TSubclassOf<ACombatEnemy> EnemyClass) const
+{
+	const FCombatEnemyPool* Pool = Pools.Find(EnemyClass);
+	return Pool ? Pool->InactiveEnemies.Num() : 0;
+}
+
+int32 UCombatEnemyPoolSubsystem::GetNumPooled(TSubclassOf<ACombatEnemy> EnemyClass) const
+{
+	const FCombatEnemyPool* Pool = Pools.Find(EnemyClass);
+	return Pool ? Pool->InactiveEnemies.Num() + Pool->ActiveCount : 0;
+}
+
+ACombatEnemy* UCombatEnemyPoolSubsystem::SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform, bool bAdjustForCollision)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = bAdjustForCollision ? ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn : ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ACombatEnemy* Enemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+
+	if (Enemy)
+	{
+		// let the enemy know it should come back to us instead of being destroyed
+		Enemy->MarkAsPooled();
+	}
+
+	return Enemy;
+}
+
+void UCombatEnemyPoolSubsystem::UpdateStats() const
+{
+	int32 NumActive = 0;
+	int32 NumInactive = 0;
+
+	for (const TPair<TSubclassOf<ACombatEnemy>, FCombatEnemyPool>& Pair : Pools)
+	{
+		NumActive += Pair.Value.ActiveCount;
+		NumInactive += Pair.Value.InactiveEnemies.Num();
+	}
+
+	SET_DWORD_STAT(STAT_GW_PooledEnemiesActive, NumActive);
+	SET_DWORD_STAT(STAT_GW_PooledEnemiesInactive, NumInactive);
+}
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatEnemyPoolSubsystem.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  Inactive enemies of a single class, ready to be reused
+ */
+USTRUCT()
+struct FCombatEnemyPool
+{
+	GENERATED_BODY()
+
+	/** Deactivated enemies waiting to be handed out */
+	UPROPERTY()
+	TArray<TObjectPtr<ACombatEnemy>> InactiveEnemies;
+
+	/** Number of enemies of this class currently handed out */
+	int32 ActiveCount = 0;
+};
+
+/**
+ *  Keeps per-class pools of combat enemies so they can be reused instead of spawned and destroyed.
+ *  Pooled enemies are deactivated in place when they're removed from the level,
+ *  and fully reset (HP, life bar, ragdoll, collision, AI) when handed out again.
+ *  Pool sizes can be viewed with "stat GW"
+ */
+UCLASS()
+class UCombatEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Pools, keyed by enemy class */
+	UPROPERTY()
+	TMap<TSubclassOf<ACombatEnemy>, FCombatEnemyPool> Pools;
+
+public:
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Makes sure the pool for the class holds at least the given number of inactive enemies, spawning any that are missing */
+	void WarmPool(TSubclassOf<ACombatEnemy> EnemyClass, int32 Count, const FTransform& StashTransform);
+
+	/** Spawns a single inactive enemy into the pool, for callers that warm it over several frames. Returns false if the spawn failed */
+	bool AddInactiveEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& StashTransform);
+
+	/**
+	 *  Hands out an enemy from the pool at the given transform, spawning a new one if the pool is empty.
+	 *  Callers that have already validated the spawn transform can skip the collision adjustment
+	 */
+	ACombatEnemy* AcquireEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform, bool bAdjustForCollision = true);
+
+	/** Deactivates an enemy and returns it to its pool */
+	void ReleaseEnemy(ACombatEnemy* Enemy);
+
+	/** Returns the number of inactive enemies pooled for the class */
+	int32 GetNumInactive(TSubclassOf<ACombatEnemy> EnemyClass) const;
+
+	/** Returns the number of enemies of the class the pool manages, handed out or not */
+	int32 GetNumPooled(TSubclassOf<ACombatEnemy> EnemyClass) const;
+
+protected:
+
+	/** Spawns a new enemy that will be managed by the pool */
+	ACombatEnemy* SpawnPooledEnemy(TSubclassOf<ACombatEnemy> EnemyClass, const FTransform& SpawnTransform, bool bAdjustForCollision);
+
+	/** Updates the pool size stats */
+	void UpdateStats() const;
+};
@@ -7,6 +7,7 @@
 #include "Components/ArrowComponent.h"
 #include "TimerManager.h"
 #include "CombatEnemy.h"
+#include "CombatEnemyPoolSubsystem.h"
 
 ACombatEnemySpawner::ACombatEnemySpawner()
 {
@@ -30,7 +31,16 @@ ACombatEnemySpawner::ACombatEnemySpawner()
 void ACombatEnemySpawner::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// pre-spawn the pooled enemies now so we don't pay for them mid-fight
+	if (bUsePooling)
+	{
+		if (UCombatEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+		{
+			Pool->WarmPool(EnemyClass, PoolWarmCount, SpawnCapsule->GetComponentTransform());
+		}
+	}
+
 	// should we spawn an enemy right away?
 	if (bShouldSpawnEnemiesImmediately)
 	{
@@ -53,11 +63,23 @@ void ACombatEnemySpawner::SpawnEnemy()
 	// ensure the enemy class is valid
 	if (IsValid(EnemyClass))
 	{
-		// spawn the enemy at the reference capsule's transform
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+		ACombatEnemy* SpawnedEnemy = nullptr;
 
-		ACombatEnemy* SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+		// take the enemy from the pool if we're pooling
+		UCombatEnemyPoolSubsystem* Pool = bUsePooling ? GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>() : nullptr;
+
+		if (Pool)
+		{
+			SpawnedEnemy = Pool->AcquireEnemy(EnemyClass, SpawnCapsule->GetComponentTransform());
+		}
+		else
+		{
+			// spawn the enemy at the reference capsule's transform
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+			SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnCapsule->GetComponentTransform(), SpawnParams);
+		}
 
 		// was the enemy successfully created?
 		if (SpawnedEnemy)
@@ -16,6 +16,7 @@ class ACombatEnemy;
  *  Enemies will be spawned one by one, and the spawner will wait until the enemy dies before spawning a new one.
  *  The spawner can be remotely activated through the ICombatActivatable interface
  *  When the last spawned enemy dies, the spawner can also activate other ICombatActivatables
+ *  Enemies can optionally be drawn from a pre-warmed pool and reused instead of spawned and destroyed
  */
 UCLASS(abstract)
 class ACombatEnemySpawner : public AActor, public ICombatActivatable
@@ -50,6 +51,14 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner", meta = (ClampMin = 0, ClampMax = 10))
 	float RespawnDelay = 5.0f;
 
+	/** If true, enemies are taken from the enemy pool and returned to it when removed, instead of being spawned and destroyed */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner|Pooling")
+	bool bUsePooling = false;
+
+	/** Number of enemies to pre-spawn into the pool on BeginPlay, so spawning during the fight doesn't hitch */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Enemy Spawner|Pooling", meta = (ClampMin = 0, ClampMax = 100, EditCondition = "bUsePooling"))
+	int32 PoolWarmCount = 1;
+
 	/** Time to wait after this spawner is depleted before activating the actor list */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation", meta = (ClampMin = 0, ClampMax = 10))
 	float ActivationDelay = 1.0f;
@@ -0,0 +1,298 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatEnvQueryCacheSubsystem.h"
+#include "EnvironmentQuery/EnvQuery.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("EnvQuery Cache Hit Rate %"), STAT_GW_EnvQueryCacheHitRate, STATGROUP_GW);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("EnvQuery Cache Join Rate %"), STAT_GW_EnvQueryCacheJoinRate, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnvQuery Deferred Queries"), STAT_GW_EnvQueryDeferred, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnvQuery Running Queries"), STAT_GW_EnvQueryRunning, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("EnvQuery Cached Results"), STAT_GW_EnvQueryCached, STATGROUP_GW);
+
+bool UCombatEnvQueryCacheSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatEnvQueryCacheSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, EnvQueryCache);
+
+	Super::Tick(DeltaTime);
+
+	// discard results from past time buckets
+	const int32 CurrentBucket = GetTimeBucket();
+
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().TimeBucket != CurrentBucket)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// start deferred queries, oldest first, until we run out of budget
+	int32 NumStarted = 0;
+	int32 NumProcessed = 0;
+
+	for (; NumProcessed < DeferredTickets.Num(); ++NumProcessed)
+	{
+		FCombatEnvQueryTicket* Ticket = Tickets.Find(DeferredTickets[NumProcessed]);
+
+		// skip cancelled or already resolved tickets
+		if (!Ticket || Ticket->Status != ECombatEnvQueryStatus::Pending)
+		{
+			continue;
+		}
+
+		// the player may have moved while we waited, so rebuild the key
+		if (!MakeKey(Ticket->Query.Get(), Ticket->Querier.Get(), Ticket->Key))
+		{
+			Ticket->Status = ECombatEnvQueryStatus::Failed;
+			continue;
+		}
+
+		// another query may have filled the cache in the meantime
+		if (FCombatEnvQueryCacheEntry* Entry = Cache.Find(Ticket->Key))
+		{
+			++NumJoins;
+			Ticket->Status = TakeLocation(*Entry, Ticket->Location) ? ECombatEnvQueryStatus::Succeeded : ECombatEnvQueryStatus::Failed;
+			continue;
+		}
+
+		// wait on a query that's already running for this key
+		if (RunningQueries.Contains(Ticket->Key))
+		{
+			++NumJoins;
+			Ticket->bDeferred = false;
+			continue;
+		}
+
+		// stop once the frame budget is spent
+		if (NumStarted >= MaxQueriesPerFrame)
+		{
+			break;
+		}
+
+		if (StartQuery(*Ticket))
+		{
+			++NumStarted;
+			++NumMisses;
+		}
+		else
+		{
+			Ticket->Status = ECombatEnvQueryStatus::Failed;
+		}
+	}
+
+	// drop everything we got through
+	DeferredTickets.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+
+	UpdateStats();
+}
+
+TStatId UCombatEnvQueryCacheSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatEnvQueryCacheSubsystem, STATGROUP_Tickables);
+}
+
+int32 UCombatEnvQueryCacheSubsystem::RequestLocation(UEnvQuery* Query, AActor* Querier, FVector& OutLocation)
+{
+	FCombatEnvQueryCacheKey Key;
+
+	if (!MakeKey(Query, Querier, Key))
+	{
+		return INDEX_NONE;
+	}
+
+	// reuse a recent result if we have one
+	if (FCombatEnvQueryCacheEntry* Entry = Cache.Find(Key))
+	{
+		++NumHits;
+		return TakeLocation(*Entry, OutLocation) ? 0 : INDEX_NONE;
+	}
+
+	// queue a ticket. If a query for this key is already running, just wait for it.
+	// Deferred tickets are counted as joins or misses once they're processed
+	int32 TicketId = 0;
+
+	FCombatEnvQueryTicket& Ticket = Tickets.Add(TicketId);
+	Ticket.Key = Key;
+	Ticket.Query = Query;
+	Ticket.Querier = Querier;
+
+	if (RunningQueries.Contains(Key))
+	{
+		++NumJoins;
+	}
+	else
+	{
+		Ticket.bDeferred = true;
+		DeferredTickets.Add(TicketId);
+	}
+
+	return TicketId;
+}
+
+ECombatEnvQueryStatus UCombatEnvQueryCacheSubsystem::GetRequestStatus(int32 TicketId, FVector& OutLocation)
+{
+	FCombatEnvQueryTicket Ticket;
+	const ECombatEnvQueryStatus Status = Tickets.Poll(TicketId, Ticket);
+
+	if (Status == ECombatEnvQueryStatus::Succeeded)
+	{
+		OutLocation = Ticket.Location;
+	}
+
+	return Status;
+}
+
+void UCombatEnvQueryCacheSubsystem::CancelRequest(int32 TicketId)
+{
+	// any query the ticket started keeps running so its result can still be shared
+	Tickets.Cancel(TicketId);
+}
+
+bool UCombatEnvQueryCacheSubsystem::MakeKey(UEnvQuery* Query, const AActor* Querier, FCombatEnvQueryCacheKey& OutKey) const
+{
+	if (!Query || !Querier)
+	{
+		return false;
+	}
+
+	// key on the same player the EnvQuery player context will pick
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(this);
+
+	float DistanceSquared = 0.0f;
+	const FPlayerInfo* NearestPlayer = PlayerInfo ? PlayerInfo->FindNearestPlayer(Querier->GetActorLocation(), DistanceSquared) : nullptr;
+
+	if (!NearestPlayer)
+	{
+		return false;
+	}
+
+	OutKey.Query = Query;
+	OutKey.PlayerCell = FIntVector(
+		FMath::FloorToInt32(NearestPlayer->Location.X / PlayerCellSize),
+		FMath::FloorToInt32(NearestPlayer->Location.Y / PlayerCellSize),
+		FMath::FloorToInt32(NearestPlayer->Location.Z / PlayerCellSize));
+	OutKey.TimeBucket = GetTimeBucket();
+
+	return true;
+}
+
+int32 UCombatEnvQueryCacheSubsystem::GetTimeBucket() const
+{
+	return FMath::FloorToInt32(GetWorld()->GetTimeSeconds() / TimeBucketDuration);
+}
+
+bool UCombatEnvQueryCacheSubsystem::TakeLocation(FCombatEnvQueryCacheEntry& Entry, FVector& OutLocation)
+{
+	if (Entry.Locations.IsEmpty())
+	{
+		return false;
+	}
+
+	OutLocation = Entry.Locations[Entry.NextLocation];
+	Entry.NextLocation = (Entry.NextLocation + 1) % Entry.Locations.Num();
+
+	return true;
+}
+
+bool UCombatEnvQueryCacheSubsystem::StartQuery(FCombatEnvQueryTicket& Ticket)
+{
+	UEnvQuery* Query = Ticket.Query.Get();
+	AActor* Querier = Ticket.Querier.Get();
+
+	if (!Query || !Querier)
+	{
+		return false;
+	}
+
+	// run all matching items so the top few can be shared between enemies.
+	// The EnvQuery manager time slices the running query on its own
+	FEnvQueryRequest Request(Query, Querier);
+	const int32 QueryId = Request.Execute(EEnvQueryRunMode::AllMatching, FQueryFinishedSignature::CreateUObject(this, &UCombatEnvQueryCacheSubsystem::OnQueryFinished, Ticket.Key));
+
+	if (QueryId == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Ticket.bDeferred = false;
+	RunningQueries.Add(Ticket.Key);
+
+	return true;
+}
+
+void UCombatEnvQueryCacheSubsystem::OnQueryFinished(TSharedPtr<FEnvQueryResult> Result, FCombatEnvQueryCacheKey Key)
+{
+	RunningQueries.Remove(Key);
+
+	// cache the top scored locations. AllMatching results are sorted best first
+	FCombatEnvQueryCacheEntry& Entry = Cache.FindOrAdd(Key);
+	Entry.Locations.Reset();
+	Entry.NextLocation = 0;
+
+	if (Result.IsValid() && Result->IsSuccessful())
+	{
+		const int32 NumItems = FMath::Min(Result->Items.Num(), SharedResultItems);
+
+		for (int32 Index = 0; Index < NumItems; ++Index)
+		{
+			Entry.Locations.Add(Result->GetItemAsLocation(Index));
+		}
+	}
+
+	ResolveWaitingTickets(Key);
+
+	UpdateStats();
+}
+
+void UCombatEnvQueryCacheSubsystem::ResolveWaitingTickets(const FCombatEnvQueryCacheKey& Key)
+{
+	FCombatEnvQueryCacheEntry* Entry = Cache.Find(Key);
+
+	if (!Entry)
+	{
+		return;
+	}
+
+	for (TPair<int32, FCombatEnvQueryTicket>& Pair : Tickets)
+	{
+		FCombatEnvQueryTicket& Ticket = Pair.Value;
+
+		if (Ticket.Status == ECombatEnvQueryStatus::Pending && Ticket.Key == Key)
+		{
+			Ticket.Status = TakeLocation(*Entry, Ticket.Location) ? ECombatEnvQueryStatus::Succeeded : ECombatEnvQueryStatus::Failed;
+		}
+	}
+}
+
+void UCombatEnvQueryCacheSubsystem::UpdateStats() const
+{
+	const uint64 NumRequests = NumHits + NumJoins + NumMisses;
+	SET_FLOAT_STAT(STAT_GW_EnvQueryCacheHitRate, NumRequests > 0 ? 100.0f * NumHits / NumRequests : 0.0f);
+	SET_FLOAT_STAT(STAT_GW_EnvQueryCacheJoinRate, NumRequests > 0 ? 100.0f * NumJoins / NumRequests : 0.0f);
+
+	int32 NumDeferred = 0;
+
+	for (const TPair<int32, FCombatEnvQueryTicket>& Pair : Tickets)
+	{
+		if (Pair.Value.bDeferred && Pair.Value.Status == ECombatEnvQueryStatus::Pending)
+		{
+			++NumDeferred;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GW_EnvQueryDeferred, NumDeferred);
+	SET_DWORD_STAT(STAT_GW_EnvQueryRunning, RunningQueries.Num());
+	SET_DWORD_STAT(STAT_GW_EnvQueryCached, Cache.Num());
+}
@@ -0,0 +1,189 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CombatRequestTickets.h"
+#include "CombatEnvQueryCacheSubsystem.generated.h"
+
+class UEnvQuery;
+struct FEnvQueryResult;
+
+/**
+ *  Status of a cached EnvQuery request
+ */
+UENUM()
+enum class ECombatEnvQueryStatus : uint8
+{
+	/** Waiting for a free slot in the frame budget, or for a running query with the same key */
+	Pending,
+
+	/** Finished with a result location */
+	Succeeded,
+
+	/** Finished without a result, or the request is unknown */
+	Failed
+};
+
+/**
+ *  Key that identifies EnvQuery results that can be shared between enemies
+ */
+struct FCombatEnvQueryCacheKey
+{
+	/** Query template that was run */
+	TObjectKey<UEnvQuery> Query;
+
+	/** Grid cell the player was in when the query was run */
+	FIntVector PlayerCell = FIntVector::ZeroValue;
+
+	/** Time bucket the query was run in */
+	int32 TimeBucket = 0;
+
+	bool operator==(const FCombatEnvQueryCacheKey& Other) const
+	{
+		return Query == Other.Query && PlayerCell == Other.PlayerCell && TimeBucket == Other.TimeBucket;
+	}
+
+	friend uint32 GetTypeHash(const FCombatEnvQueryCacheKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Query), GetTypeHash(Key.PlayerCell)), GetTypeHash(Key.TimeBucket));
+	}
+};
+
+/**
+ *  Results of a finished query, shared by every request with the same key
+ */
+struct FCombatEnvQueryCacheEntry
+{
+	/** Item locations, best scored first */
+	TArray<FVector> Locations;
+
+	/** Index of the next location to hand out, so enemies sharing a result spread out over the top items */
+	int32 NextLocation = 0;
+};
+
+/**
+ *  A request waiting on the cache
+ */
+struct FCombatEnvQueryTicket
+{
+	/** Cache key for the request */
+	FCombatEnvQueryCacheKey Key;
+
+	/** Query template to run on a miss */
+	TWeakObjectPtr<UEnvQuery> Query;
+
+	/** Actor the query runs for */
+	TWeakObjectPtr<AActor> Querier;
+
+	/** Current status */
+	ECombatEnvQueryStatus Status = ECombatEnvQueryStatus::Pending;
+
+	/** Result location, once succeeded */
+	FVector Location = FVector::ZeroVector;
+
+	/** If true, the ticket is waiting in the deferred queue rather than on a running query */
+	bool bDeferred = false;
+};
+
+/**
+ *  Caches EnvQuery results for combat enemy positioning.
+ *  Results are keyed by query template, the grid cell the nearest player is in, and a time bucket,
+ *  so enemies close to each other that run the same query against the same player share one result.
+ *  Queries that miss the cache are started from a queue, with a cap on how many may start each frame.
+ *  Hit rate, join rate (requests that shared a query still running) and deferred query counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class UCombatEnvQueryCacheSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Finished query results */
+	TMap<FCombatEnvQueryCacheKey, FCombatEnvQueryCacheEntry> Cache;
+
+	/** Outstanding requests */
+	TCombatRequestTickets<FCombatEnvQueryTicket> Tickets;
+
+	/** Tickets waiting to start a query, oldest first */
+	TArray<int32> DeferredTickets;
+
+	/** Keys that have a query running */
+	TSet<FCombatEnvQueryCacheKey> RunningQueries;
+
+	/** Lifetime requests served straight from the cache, for the hit rate stat */
+	uint64 NumHits = 0;
+
+	/** Lifetime requests that waited on a query started for another request with the same key, for the join rate stat */
+	uint64 NumJoins = 0;
+
+	/** Lifetime requests that started a query of their own */
+	uint64 NumMisses = 0;
+
+protected:
+
+	/** Size of the grid cells used to bucket the player location */
+	UPROPERTY(Config, EditAnywhere, Category="EnvQuery Cache", meta = (ClampMin = 10, ClampMax = 5000, Units = "cm"))
+	float PlayerCellSize = 300.0f;
+
+	/** Length of each time bucket. Results are discarded once their bucket has passed */
+	UPROPERTY(Config, EditAnywhere, Category="EnvQuery Cache", meta = (ClampMin = 0.05, ClampMax = 10, Units = "s"))
+	float TimeBucketDuration = 0.5f;
+
+	/** Max number of fresh queries that can be started each frame across all enemies */
+	UPROPERTY(Config, EditAnywhere, Category="EnvQuery Cache", meta = (ClampMin = 1, ClampMax = 100))
+	int32 MaxQueriesPerFrame = 2;
+
+	/** Number of top scored items handed out round robin from a shared result */
+	UPROPERTY(Config, EditAnywhere, Category="EnvQuery Cache", meta = (ClampMin = 1, ClampMax = 32))
+	int32 SharedResultItems = 4;
+
+public:
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Discards expired results and starts deferred queries within the frame budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Requests a location from the query for the querier.
+	 *  On a cache hit the location is returned right away and the ticket is 0.
+	 *  On a miss, a ticket is returned that can be polled with GetRequestStatus.
+	 *  Returns INDEX_NONE if the request can't be made at all.
+	 */
+	int32 RequestLocation(UEnvQuery* Query, AActor* Querier, FVector& OutLocation);
+
+	/** Polls a ticket. Finished tickets are removed once polled */
+	ECombatEnvQueryStatus GetRequestStatus(int32 TicketId, FVector& OutLocation);
+
+	/** Cancels a ticket that's no longer needed */
+	void CancelRequest(int32 TicketId);
+
+protected:
+
+	/** Builds the cache key for the query run by the querier right now. Returns false if there's no player */
+	bool MakeKey(UEnvQuery* Query, const AActor* Querier, FCombatEnvQueryCacheKey& OutKey) const;
+
+	/** Returns the current time bucket */
+	int32 GetTimeBucket() const;
+
+	/** Hands out the next location from a cached result */
+	static bool TakeLocation(FCombatEnvQueryCacheEntry& Entry, FVector& OutLocation);
+
+	/** Starts the EnvQuery for a ticket. Returns false if it couldn't be started */
+	bool StartQuery(FCombatEnvQueryTicket& Ticket);
+
+	/** Handles a finished EnvQuery */
+	void OnQueryFinished(TSharedPtr<FEnvQueryResult> Result, FCombatEnvQueryCacheKey Key);
+
+	/** Resolves every ticket waiting on the key from its cached result */
+	void ResolveWaitingTickets(const FCombatEnvQueryCacheKey& Key);
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
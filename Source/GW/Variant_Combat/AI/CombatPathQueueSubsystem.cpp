@@ -0,0 +1,319 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatPathQueueSubsystem.h"
+#include "AIController.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "NavMesh/NavMeshPath.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "Engine/World.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queue Waiting"), STAT_GW_PathQueueWaiting, STATGROUP_GW);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queue Running Queries"), STAT_GW_PathQueueRunning, STATGROUP_GW);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Queue Shared Paths Joined"), STAT_GW_PathQueueJoined, STATGROUP_GW);
+
+bool UCombatPathQueueSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatPathQueueSubsystem::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	CSV_SCOPED_TIMING_STAT(GW, PathQueue);
+
+	Super::Tick(DeltaTime);
+
+	// forget shared paths that are too old to trust
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	for (auto It = SharedPaths.CreateIterator(); It; ++It)
+	{
+		if (CurrentTime - It.Value().FoundTime > SharedPathLifetime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// serve queued requests, oldest first, until we run out of budget
+	int32 NumStarted = 0;
+	int32 NumProcessed = 0;
+
+	for (; NumProcessed < Queue.Num(); ++NumProcessed)
+	{
+		const int32 TicketId = Queue[NumProcessed];
+		FCombatPathRequest* Request = Requests.Find(TicketId);
+
+		// skip cancelled or already resolved requests
+		if (!Request || Request->Status != ECombatPathStatus::Pending)
+		{
+			continue;
+		}
+
+		// another enemy may have found a path we can join while we waited
+		if (TryJoinSharedPath(*Request))
+		{
+			continue;
+		}
+
+		// wait on a query that's already running for this goal cell
+		if (RunningGoalCells.Contains(Request->GoalCell))
+		{
+			Request->bWaitingOnQuery = true;
+			continue;
+		}
+
+		// stop once the frame budget is spent
+		if (NumStarted >= MaxQueriesPerFrame)
+		{
+			break;
+		}
+
+		if (StartQuery(TicketId, *Request))
+		{
+			++NumStarted;
+		}
+		else
+		{
+			Request->Status = ECombatPathStatus::Failed;
+		}
+	}
+
+	// drop everything we got through
+	Queue.RemoveAt(0, NumProcessed, EAllowShrinking::No);
+
+	UpdateStats();
+}
+
+TStatId UCombatPathQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatPathQueueSubsystem, STATGROUP_Tickables);
+}
+
+int32 UCombatPathQueueSubsystem::RequestPath(AAIController* Controller, const FVector& Goal)
+{
+	const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+
+	if (!Pawn)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 TicketId = 0;
+
+	FCombatPathRequest& Request = Requests.Add(TicketId);
+	Request.Controller = Controller;
+	Request.Start = Pawn->GetNavAgentLocation();
+	Request.Goal = Goal;
+	Request.GoalCell = GetGoalCell(Goal);
+
+	// join a recent path right away if we can, otherwise get in line
+	if (!TryJoinSharedPath(Request))
+	{
+		Queue.Add(TicketId);
+	}
+
+	return TicketId;
+}
+
+ECombatPathStatus UCombatPathQueueSubsystem::GetPathStatus(int32 TicketId, FNavPathSharedPtr& OutPath)
+{
+	FCombatPathRequest Request;
+	const ECombatPathStatus Status = Requests.Poll(TicketId, Request);
+
+	if (Status == ECombatPathStatus::Succeeded)
+	{
+		OutPath = Request.Path;
+	}
+
+	return Status;
+}
+
+void UCombatPathQueueSubsystem::CancelRequest(int32 TicketId)
+{
+	// any query the request started keeps running so its path can still be shared
+	Requests.Cancel(TicketId);
+}
+
+FIntVector UCombatPathQueueSubsystem::GetGoalCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / GoalCellSize),
+		FMath::FloorToInt32(Location.Y / GoalCellSize),
+		FMath::FloorToInt32(Location.Z / GoalCellSize));
+}
+
+bool UCombatPathQueueSubsystem::TryJoinSharedPath(FCombatPathRequest& Request) const
+{
+	const FCombatSharedPath* SharedPath = SharedPaths.Find(Request.GoalCell);
+	const FNavigationPath* SourcePath = SharedPath ? SharedPath->Path.Get() : nullptr;
+
+	if (!SourcePath || !SourcePath->IsValid() || SourcePath->GetPathPoints().Num() < 2)
+	{
+		return false;
+	}
+
+	const TArray<FNavPathPoint>& SourcePoints = SourcePath->GetPathPoints();
+
+	// find the closest point on the shared path
+	int32 JoinIndex = INDEX_NONE;
+	float JoinDistanceSquared = FMath::Square(JoinDistance);
+
+	for (int32 Index = 0; Index < SourcePoints.Num(); ++Index)
+	{
+		const float DistanceSquared = FVector::DistSquared(Request.Start, SourcePoints[Index].Location);
+
+		if (DistanceSquared <= JoinDistanceSquared)
+		{
+			JoinIndex = Index;
+			JoinDistanceSquared = DistanceSquared;
+		}
+	}
+
+	if (JoinIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// our path is a straight line to the join point, then the rest of the shared path.
+	// It finishes at our own goal instead of the shared one, since that may be anywhere in the cell
+	const int32 LastIndex = SourcePoints.Num() - 1;
+	const FVector& LastLegStart = JoinIndex < LastIndex ? SourcePoints[LastIndex - 1].Location : Request.Start;
+
+	// make sure we can walk straight to the join point, and straight from the last shared point to our goal
+	const AAIController* Controller = Request.Controller.Get();
+	FVector HitLocation;
+
+	if (UNavigationSystemV1::NavigationRaycast(GetWorld(), Request.Start, SourcePoints[JoinIndex].Location, HitLocation, nullptr, Controller)
+		|| UNavigationSystemV1::NavigationRaycast(GetWorld(), LastLegStart, Request.Goal, HitLocation, nullptr, Controller))
+	{
+		return false;
+	}
+
+	// copy the points over, keeping their navmesh nodes and flags
+	TSharedRef<FNavMeshPath, ESPMode::ThreadSafe> JoinedPath = MakeShared<FNavMeshPath, ESPMode::ThreadSafe>();
+	TArray<FNavPathPoint>& PathPoints = JoinedPath->GetPathPoints();
+
+	PathPoints.Reserve(SourcePoints.Num() - JoinIndex + 1);
+	PathPoints.Add(FNavPathPoint(Request.Start));
+	PathPoints.Append(&SourcePoints[JoinIndex], SourcePoints.Num() - JoinIndex);
+	PathPoints.Last().Location = Request.Goal;
+
+	// keep the corridor, so the joined path is invalidated when the navmesh under it changes
+	if (const FNavMeshPath* SourceMeshPath = SourcePath->CastPath<FNavMeshPath>())
+	{
+		JoinedPath->PathCorridor = SourceMeshPath->PathCorridor;
+		JoinedPath->PathCorridorCost = SourceMeshPath->PathCorridorCost;
+	}
+
+	// repaths should go from our start to our goal, on behalf of our controller
+	FPathFindingQueryData QueryData = SourcePath->GetQueryData();
+	QueryData.StartLocation = Request.Start;
+	QueryData.EndLocation = Request.Goal;
+	QueryData.Owner = Controller;
+
+	JoinedPath->SetQueryData(QueryData);
+	JoinedPath->SetNavigationDataUsed(SourcePath->GetNavigationDataUsed());
+	JoinedPath->SetQuerier(Controller);
+	JoinedPath->MarkReady();
+
+	Request.Path = JoinedPath;
+	Request.Status = ECombatPathStatus::Succeeded;
+	Request.bWaitingOnQuery = false;
+
+	INC_DWORD_STAT(STAT_GW_PathQueueJoined);
+
+	return true;
+}
+
+bool UCombatPathQueueSubsystem::StartQuery(int32 TicketId, FCombatPathRequest& Request)
+{
+	AAIController* Controller = Request.Controller.Get();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	if (!Controller || !Controller->GetPawn() || !NavSys)
+	{
+		return false;
+	}
+
+	// start from wherever the pawn is now, not where it was when it asked
+	Request.Start = Controller->GetPawn()->GetNavAgentLocation();
+
+	const FNavAgentProperties& AgentProperties = Controller->GetNavAgentPropertiesRef();
+	const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, Request.Start);
+
+	if (!NavData)
+	{
+		return false;
+	}
+
+	FPathFindingQuery Query(Controller, *NavData, Request.Start, Request.Goal, UNavigationQueryFilter::GetQueryFilter(*NavData, Controller, Controller->GetDefaultNavigationFilterClass()));
+
+	const uint32 QueryId = NavSys->FindPathAsync(AgentProperties, Query, FNavPathQueryDelegate::CreateUObject(this, &UCombatPathQueueSubsystem::OnPathFound, Request.GoalCell, TicketId), EPathFindingMode::Regular);
+
+	if (QueryId == INVALID_NAVQUERYID)
+	{
+		return false;
+	}
+
+	RunningGoalCells.Add(Request.GoalCell);
+
+	return true;
+}
+
+void UCombatPathQueueSubsystem::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, FIntVector GoalCell, int32 TicketId)
+{
+	RunningGoalCells.Remove(GoalCell);
+
+	const bool bSucceeded = Result == ENavigationQueryResult::Success && Path.IsValid() && Path->IsValid();
+
+	// hand the path to the request that asked for it
+	if (FCombatPathRequest* Request = Requests.Find(TicketId))
+	{
+		Request->Status = bSucceeded ? ECombatPathStatus::Succeeded : ECombatPathStatus::Failed;
+		Request->Path = Path;
+	}
+
+	// keep the path around for other enemies heading the same way
+	if (bSucceeded)
+	{
+		FCombatSharedPath& SharedPath = SharedPaths.FindOrAdd(GoalCell);
+		SharedPath.FoundTime = GetWorld()->GetTimeSeconds();
+		SharedPath.Path = Path;
+	}
+
+	// try to join the waiting requests to the new path. Whoever can't join runs their own query
+	for (TPair<int32, FCombatPathRequest>& Pair : Requests)
+	{
+		FCombatPathRequest& Waiting = Pair.Value;
+
+		if (Waiting.bWaitingOnQuery && Waiting.GoalCell == GoalCell && Waiting.Status == ECombatPathStatus::Pending)
+		{
+			Waiting.bWaitingOnQuery = false;
+
+			if (!TryJoinSharedPath(Waiting))
+			{
+				Queue.Add(Pair.Key);
+			}
+		}
+	}
+}
+
+void UCombatPathQueueSubsystem::UpdateStats() const
+{
+	int32 NumWaiting = 0;
+
+	for (const TPair<int32, FCombatPathRequest>& Pair : Requests)
+	{
+		if (Pair.Value.Status == ECombatPathStatus::Pending)
+		{
+			++NumWaiting;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_GW_PathQueueWaiting, NumWaiting);
+	SET_DWORD_STAT(STAT_GW_PathQueueRunning, RunningGoalCells.Num());
+}
@@ -0,0 +1,148 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "CombatRequestTickets.h"
+#include "CombatPathQueueSubsystem.generated.h"
+
+class AAIController;
+
+/**
+ *  Status of a queued path request
+ */
+UENUM()
+enum class ECombatPathStatus : uint8
+{
+	/** Waiting in the queue or for a running query */
+	Pending,
+
+	/** A path is ready */
+	Succeeded,
+
+	/** No path could be found, or the request is unknown */
+	Failed
+};
+
+/**
+ *  A path request waiting on the queue
+ */
+struct FCombatPathRequest
+{
+	/** Controller the path is for */
+	TWeakObjectPtr<AAIController> Controller;
+
+	/** Location the path starts at */
+	FVector Start = FVector::ZeroVector;
+
+	/** Location the path ends at */
+	FVector Goal = FVector::ZeroVector;
+
+	/** Goal cell, used to share paths */
+	FIntVector GoalCell = FIntVector::ZeroValue;
+
+	/** Current status */
+	ECombatPathStatus Status = ECombatPathStatus::Pending;
+
+	/** Resulting path, once succeeded */
+	FNavPathSharedPtr Path;
+
+	/** If true, the request is waiting for a query another request started for the same goal cell */
+	bool bWaitingOnQuery = false;
+};
+
+/**
+ *  A recently found path that other enemies heading to the same goal cell can join
+ */
+struct FCombatSharedPath
+{
+	/** Path that was found. Joined paths are copied from it */
+	FNavPathSharedPtr Path;
+
+	/** World time the path was found */
+	float FoundTime = 0.0f;
+};
+
+/**
+ *  Shared asynchronous path finding queue for combat enemies.
+ *  Requests are served with async navigation queries, with a cap on how many start each frame,
+ *  so a whole wave repathing on the same frame doesn't hitch the game thread.
+ *  Enemies heading to the same goal cell share a recent path: if an enemy is close to a point on it
+ *  with a clear line on the navmesh, it joins the path from there instead of running its own query.
+ *  Joined paths are navmesh paths like any other, so they're followed and invalidated by navmesh changes as usual.
+ *  Queue counts can be viewed with "stat GW"
+ */
+UCLASS(Config=Game)
+class UCombatPathQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Outstanding requests */
+	TCombatRequestTickets<FCombatPathRequest> Requests;
+
+	/** Requests waiting to start a query, oldest first */
+	TArray<int32> Queue;
+
+	/** Goal cells that have a query running */
+	TSet<FIntVector> RunningGoalCells;
+
+	/** Recently found paths, by goal cell */
+	TMap<FIntVector, FCombatSharedPath> SharedPaths;
+
+protected:
+
+	/** Size of the grid cells used to bucket goal locations */
+	UPROPERTY(Config, EditAnywhere, Category="Path Queue", meta = (ClampMin = 10, ClampMax = 5000, Units = "cm"))
+	float GoalCellSize = 200.0f;
+
+	/** Max number of path queries started each frame across all enemies */
+	UPROPERTY(Config, EditAnywhere, Category="Path Queue", meta = (ClampMin = 1, ClampMax = 100))
+	int32 MaxQueriesPerFrame = 2;
+
+	/** How long a found path can be joined by other enemies */
+	UPROPERTY(Config, EditAnywhere, Category="Path Queue", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float SharedPathLifetime = 1.0f;
+
+	/** Max distance from an enemy to a point on a shared path for it to join that path */
+	UPROPERTY(Config, EditAnywhere, Category="Path Queue", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm"))
+	float JoinDistance = 400.0f;
+
+public:
+
+	/** Only run in game worlds */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Expires shared paths and starts queued queries within the frame budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for this tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Queues a path from the controller's pawn to the goal. Returns a ticket to poll, or INDEX_NONE if the request can't be made */
+	int32 RequestPath(AAIController* Controller, const FVector& Goal);
+
+	/** Polls a ticket. Finished tickets are removed once polled */
+	ECombatPathStatus GetPathStatus(int32 TicketId, FNavPathSharedPtr& OutPath);
+
+	/** Cancels a ticket that's no longer needed */
+	void CancelRequest(int32 TicketId);
+
+protected:
+
+	/** Returns the goal cell containing the location */
+	FIntVector GetGoalCell(const FVector& Location) const;
+
+	/** Tries to resolve a request by joining a shared path to its goal cell. Returns true if it succeeded */
+	bool TryJoinSharedPath(FCombatPathRequest& Request) const;
+
+	/** Starts the async path query for a request. Returns false if it couldn't be started */
+	bool StartQuery(int32 TicketId, FCombatPathRequest& Request);
+
+	/** Handles a finished async path query */
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path, FIntVector GoalCell, int32 TicketId);
+
+	/** Updates the stats */
+	void UpdateStats() const;
+};
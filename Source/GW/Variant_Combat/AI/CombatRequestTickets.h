@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Outstanding asynchronous requests, keyed by the ticket id handed back to the requester.
+ *  Shared by the combat query subsystems. The request type needs a Status member of an enum
+ *  with Pending and Failed values; anything other than Pending counts as finished.
+ */
+template <typename RequestType>
+class TCombatRequestTickets
+{
+public:
+
+	using StatusType = decltype(RequestType::Status);
+
+	/** Adds a request and returns it, along with its ticket id */
+	RequestType& Add(int32& OutTicketId)
+	{
+		OutTicketId = ++LastTicketId;
+		return Requests.Add(OutTicketId);
+	}
+
+	/** Returns the request for the ticket, or null if it's unknown */
+	RequestType* Find(int32 TicketId) { return Requests.Find(TicketId); }
+
+	/**
+	 *  Polls a ticket and returns its status. Unknown tickets have failed.
+	 *  Finished requests are copied out and removed, so they're only polled once
+	 */
+	StatusType Poll(int32 TicketId, RequestType& OutRequest)
+	{
+		const RequestType* Request = Requests.Find(TicketId);
+
+		if (!Request)
+		{
+			return StatusType::Failed;
+		}
+
+		const StatusType Status = Request->Status;
+
+		if (Status != StatusType::Pending)
+		{
+			Requests.RemoveAndCopyValue(TicketId, OutRequest);
+		}
+
+		return Status;
+	}
+
+	/** Removes a request that's no longer needed */
+	void Cancel(int32 TicketId) { Requests.Remove(TicketId); }
+
+	/** Iterates the requests as ticket id / request pairs */
+	auto begin() { return Requests.begin(); }
+	auto end() { return Requests.end(); }
+	auto begin() const { return Requests.begin(); }
+	auto end() const { return Requests.end(); }
+
+private:
+
+	/** Outstanding requests, by ticket id */
+	TMap<int32, RequestType> Requests;
+
+	/** Last ticket id handed out */
+	int32 LastTicketId = 0;
+};
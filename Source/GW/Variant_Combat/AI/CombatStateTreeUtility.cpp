@@ -8,7 +8,11 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AIController.h"
 #include "CombatEnemy.h"
-#include "Kismet/GameplayStatics.h"
+#include "CombatDirectorSubsystem.h"
+#include "CombatEnvQueryCacheSubsystem.h"
+#include "CombatPathQueueSubsystem.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
 #include "StateTreeAsyncExecutionContext.h"
 
 bool FStateTreeCharacterGroundedCondition::TestCondition(FStateTreeExecutionContext& Context) const
@@ -38,6 +42,14 @@ EStateTreeRunStatus FStateTreeComboAttackTask::EnterState(FStateTreeExecutionCon
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+		// we need an attack token from the director before we can attack
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (Director && !Director->TryAcquireAttackToken(InstanceData.Character))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
 		// bind to the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.BindLambda(
 			[WeakContext = Context.MakeWeakExecutionContext()]()
@@ -64,6 +76,14 @@ void FStateTreeComboAttackTask::ExitState(FStateTreeExecutionContext& Context, c
 
 		// unbind the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.Unbind();
+
+		// give the attack token back to the director, but keep our place in line if we didn't get one
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (Director && Director->HasAttackToken(InstanceData.Character))
+		{
+			Director->ReleaseAttackToken(InstanceData.Character);
+		}
 	}
 }
 
@@ -84,6 +104,14 @@ EStateTreeRunStatus FStateTreeChargedAttackTask::EnterState(FStateTreeExecutionC
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
+		// we need an attack token from the director before we can attack
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (Director && !Director->TryAcquireAttackToken(InstanceData.Character))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
 		// bind to the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.BindLambda(
 			[WeakContext = Context.MakeWeakExecutionContext()]()
@@ -109,6 +137,14 @@ void FStateTreeChargedAttackTask::ExitState(FStateTreeExecutionContext& Context,
 
 		// unbind the on attack completed delegate
 		InstanceData.Character->OnAttackCompleted.Unbind();
+
+		// give the attack token back to the director, but keep our place in line if we didn't get one
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (Director && Director->HasAttackToken(InstanceData.Character))
+		{
+			Director->ReleaseAttackToken(InstanceData.Character);
+		}
 	}
 }
 
@@ -121,6 +157,70 @@ FText FStateTreeChargedAttackTask::GetDescription(const FGuid& ID, FStateTreeDat
 
 ////////////////////////////////////////////////////////////////////
 
+EStateTreeRunStatus FStateTreeWaitForAttackTokenTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// ask for a token. If there's no director, there's nothing to wait for
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (!Director || Director->TryAcquireAttackToken(InstanceData.Character))
+		{
+			return EStateTreeRunStatus::Succeeded;
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FStateTreeWaitForAttackTokenTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// renew our request and check if it was granted
+	UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+	if (!Director || Director->TryAcquireAttackToken(InstanceData.Character))
+	{
+		return EStateTreeRunStatus::Succeeded;
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreeWaitForAttackTokenTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned to another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// if we're leaving without a token, stop waiting for one. A granted token is kept for the attack state,
+		// and reclaimed by the director if the attack never starts
+		UCombatDirectorSubsystem* Director = InstanceData.Character->GetWorld()->GetSubsystem<UCombatDirectorSubsystem>();
+
+		if (Director && !Director->HasAttackToken(InstanceData.Character))
+		{
+			Director->ReleaseAttackToken(InstanceData.Character);
+		}
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreeWaitForAttackTokenTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Wait for Attack Token</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
 EStateTreeRunStatus FStateTreeWaitForLandingTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
 	// have we transitioned from another state?
@@ -266,18 +366,27 @@ EStateTreeRunStatus FStateTreeGetPlayerInfoTask::Tick(FStateTreeExecutionContext
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// get the character possessed by the first local player
-	InstanceData.TargetPlayerCharacter = Cast<ACharacter>(UGameplayStatics::GetPlayerPawn(InstanceData.Character, 0));
+	const FVector CharacterLocation = InstanceData.Character->GetActorLocation();
 
-	// do we have a valid target?
-	if (InstanceData.TargetPlayerCharacter)
+	// get the player closest to us from the shared per-frame cache
+	if (UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(InstanceData.Character))
 	{
-		// update the last known location
-		InstanceData.TargetPlayerLocation = InstanceData.TargetPlayerCharacter->GetActorLocation();
+		float NearestDistanceSquared = 0.0f;
+		const FPlayerInfo* NearestPlayer = PlayerInfo->FindNearestPlayer(CharacterLocation, NearestDistanceSquared);
+
+		InstanceData.TargetPlayerCharacter = NearestPlayer ? NearestPlayer->Character : nullptr;
+
+		// do we have a valid target?
+		if (InstanceData.TargetPlayerCharacter)
+		{
+			// update the last known location
+			InstanceData.TargetPlayerLocation = NearestPlayer->Location;
+		}
 	}
 
-	// update the distance
-	InstanceData.DistanceToTarget = FVector::Distance(InstanceData.TargetPlayerLocation, InstanceData.Character->GetActorLocation());
+	// update the distance. The plain distance is kept for StateTree assets that bind to it
+	InstanceData.DistanceSquaredToTarget = FVector::DistSquared(InstanceData.TargetPlayerLocation, CharacterLocation);
+	InstanceData.DistanceToTarget = FMath::Sqrt(InstanceData.DistanceSquaredToTarget);
 
 	return EStateTreeRunStatus::Running;
 }
@@ -287,4 +396,233 @@ FText FStateTreeGetPlayerInfoTask::GetDescription(const FGuid& ID, FStateTreeDat
 {
 	return FText::FromString("<b>Get Player Info</b>");
 }
-#endif // WITH_EDITOR
\ No newline at end of file
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeRunCachedEnvQueryTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	InstanceData.TicketId = INDEX_NONE;
+
+	UCombatEnvQueryCacheSubsystem* QueryCache = InstanceData.Character->GetWorld()->GetSubsystem<UCombatEnvQueryCacheSubsystem>();
+
+	if (!QueryCache)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// ask the cache for a location
+	const int32 TicketId = QueryCache->RequestLocation(InstanceData.QueryTemplate, InstanceData.Character, InstanceData.ResultLocation);
+
+	// cache hit
+	if (TicketId == 0)
+	{
+		return EStateTreeRunStatus::Succeeded;
+	}
+
+	// the query can't be run
+	if (TicketId == INDEX_NONE)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// wait for the query to run
+	InstanceData.TicketId = TicketId;
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FStateTreeRunCachedEnvQueryTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	UCombatEnvQueryCacheSubsystem* QueryCache = InstanceData.Character->GetWorld()->GetSubsystem<UCombatEnvQueryCacheSubsystem>();
+
+	if (!QueryCache || InstanceData.TicketId == INDEX_NONE)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// poll the ticket
+	switch (QueryCache->GetRequestStatus(InstanceData.TicketId, InstanceData.ResultLocation))
+	{
+	case ECombatEnvQueryStatus::Pending:
+		return EStateTreeRunStatus::Running;
+
+	case ECombatEnvQueryStatus::Succeeded:
+		InstanceData.TicketId = INDEX_NONE;
+		return EStateTreeRunStatus::Succeeded;
+
+	default:
+		InstanceData.TicketId = INDEX_NONE;
+		return EStateTreeRunStatus::Failed;
+	}
+}
+
+void FStateTreeRunCachedEnvQueryTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// stop waiting on the cache if we're leaving early
+	if (InstanceData.TicketId != INDEX_NONE)
+	{
+		if (UCombatEnvQueryCacheSubsystem* QueryCache = InstanceData.Character->GetWorld()->GetSubsystem<UCombatEnvQueryCacheSubsystem>())
+		{
+			QueryCache->CancelRequest(InstanceData.TicketId);
+		}
+
+		InstanceData.TicketId = INDEX_NONE;
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreeRunCachedEnvQueryTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Run Cached EnvQuery</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeQueuedMoveToTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned from another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		InstanceData.bHasPath = false;
+		InstanceData.TicketId = INDEX_NONE;
+
+		// queue the first path request
+		UCombatPathQueueSubsystem* PathQueue = InstanceData.Controller->GetWorld()->GetSubsystem<UCombatPathQueueSubsystem>();
+
+		if (!PathQueue)
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		InstanceData.TicketId = PathQueue->RequestPath(InstanceData.Controller, InstanceData.Destination);
+		InstanceData.RequestedGoal = InstanceData.Destination;
+		InstanceData.TimeSinceRequest = 0.0f;
+
+		if (InstanceData.TicketId == INDEX_NONE)
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FStateTreeQueuedMoveToTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	AAIController* Controller = InstanceData.Controller;
+	const APawn* Pawn = Controller->GetPawn();
+	UCombatPathQueueSubsystem* PathQueue = Controller->GetWorld()->GetSubsystem<UCombatPathQueueSubsystem>();
+
+	if (!Pawn || !PathQueue)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// have we arrived?
+	if (FVector::DistSquared2D(Pawn->GetActorLocation(), InstanceData.Destination) <= FMath::Square(InstanceData.AcceptanceRadius))
+	{
+		Controller->StopMovement();
+		return EStateTreeRunStatus::Succeeded;
+	}
+
+	InstanceData.TimeSinceRequest += DeltaTime;
+
+	// check on a pending request. We keep following the previous path until it's served
+	if (InstanceData.TicketId != INDEX_NONE)
+	{
+		FNavPathSharedPtr Path;
+		const ECombatPathStatus Status = PathQueue->GetPathStatus(InstanceData.TicketId, Path);
+
+		if (Status == ECombatPathStatus::Pending)
+		{
+			return EStateTreeRunStatus::Running;
+		}
+
+		InstanceData.TicketId = INDEX_NONE;
+
+		if (Status == ECombatPathStatus::Succeeded)
+		{
+			// start following the new path
+			FAIMoveRequest MoveRequest(InstanceData.RequestedGoal);
+			MoveRequest.SetAcceptanceRadius(InstanceData.AcceptanceRadius);
+
+			InstanceData.bHasPath = Controller->RequestMove(MoveRequest, Path).IsValid();
+		}
+
+		// without any path to follow, there's nothing left to do
+		if (!InstanceData.bHasPath)
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		return EStateTreeRunStatus::Running;
+	}
+
+	// repath if the destination moved too far, or we ran out of path before arriving
+	if (InstanceData.TimeSinceRequest >= InstanceData.RepathInterval)
+	{
+		const bool bDestinationMoved = FVector::DistSquared(InstanceData.RequestedGoal, InstanceData.Destination) > FMath::Square(InstanceData.RepathDistance);
+		const bool bPathFinished = Controller->GetMoveStatus() == EPathFollowingStatus::Idle;
+
+		if (bDestinationMoved || bPathFinished)
+		{
+			InstanceData.TicketId = PathQueue->RequestPath(Controller, InstanceData.Destination);
+			InstanceData.RequestedGoal = InstanceData.Destination;
+			InstanceData.TimeSinceRequest = 0.0f;
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreeQueuedMoveToTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// have we transitioned to another state?
+	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	{
+		// get the instance data
+		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+		// stop waiting on the queue
+		if (InstanceData.TicketId != INDEX_NONE)
+		{
+			if (UCombatPathQueueSubsystem* PathQueue = InstanceData.Controller->GetWorld()->GetSubsystem<UCombatPathQueueSubsystem>())
+			{
+				PathQueue->CancelRequest(InstanceData.TicketId);
+			}
+
+			InstanceData.TicketId = INDEX_NONE;
+		}
+
+		// stop following the path
+		if (InstanceData.bHasPath)
+		{
+			InstanceData.Controller->StopMovement();
+			InstanceData.bHasPath = false;
+		}
+	}
+}
+
+#if WITH_EDITOR
+FText FStateTreeQueuedMoveToTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Queued Move To</b>");
+}
+#endif // WITH_EDITOR
@@ -11,6 +11,7 @@
 class ACharacter;
 class AAIController;
 class ACombatEnemy;
+class UEnvQuery;
 
 /**
  *  Instance data struct for the FStateTreeCharacterGroundedCondition condition
@@ -72,7 +73,8 @@ struct FStateTreeAttackInstanceData
 };
 
 /**
- *  StateTree task to perform a combo attack
+ *  StateTree task to perform a combo attack.
+ *  Fails if the character can't get an attack token from the combat director
  */
 USTRUCT(meta=(DisplayName="Combo Attack", Category="Combat"))
 struct FStateTreeComboAttackTask : public FStateTreeTaskCommonBase
@@ -95,7 +97,8 @@ struct FStateTreeComboAttackTask : public FStateTreeTaskCommonBase
 };
 
 /**
- *  StateTree task to perform a charged attack
+ *  StateTree task to perform a charged attack.
+ *  Fails if the character can't get an attack token from the combat director
  */
 USTRUCT(meta=(DisplayName="Charged Attack", Category="Combat"))
 struct FStateTreeChargedAttackTask : public FStateTreeTaskCommonBase
@@ -117,6 +120,33 @@ struct FStateTreeChargedAttackTask : public FStateTreeTaskCommonBase
 #endif // WITH_EDITOR
 };
 
+/**
+ *  StateTree task to wait until the combat director grants the character an attack token.
+ *  Place before an attack state so the attack only starts once the token is held
+ */
+USTRUCT(meta=(DisplayName="Wait for Attack Token", Category="Combat"))
+struct FStateTreeWaitForAttackTokenTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeAttackInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs while the owning state is active */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
 /**
  *  StateTree task to wait for the character to land
  */
@@ -288,10 +318,15 @@ struct FStateTreeGetPlayerInfoInstanceData
 	/** Distance to the target */
 	UPROPERTY(VisibleAnywhere)
 	float DistanceToTarget = 0.0f;
+
+	/** Squared distance to the target. Cheaper to compare against squared ranges */
+	UPROPERTY(VisibleAnywhere)
+	float DistanceSquaredToTarget = 0.0f;
 };
 
 /**
- *  StateTree task to get information about the player character
+ *  StateTree task to get information about the nearest player character.
+ *  Reads from the per-world player info cache instead of looking the player up every tick
  */
 USTRUCT(meta=(DisplayName="GetPlayerInfo", Category="Combat"))
 struct FStateTreeGetPlayerInfoTask : public FStateTreeTaskCommonBase
@@ -308,4 +343,129 @@ struct FStateTreeGetPlayerInfoTask : public FStateTreeTaskCommonBase
 #if WITH_EDITOR
 	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
 #endif // WITH_EDITOR
-};
\ No newline at end of file
+};
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Run Cached EnvQuery task
+ */
+USTRUCT()
+struct FStateTreeRunCachedEnvQueryInstanceData
+{
+	GENERATED_BODY()
+
+	/** Character that runs the query */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ACharacter> Character;
+
+	/** Query to run */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<UEnvQuery> QueryTemplate;
+
+	/** Location picked by the query */
+	UPROPERTY(EditAnywhere, Category = Output)
+	FVector ResultLocation = FVector::ZeroVector;
+
+	/** Ticket for a request waiting on the cache */
+	int32 TicketId = INDEX_NONE;
+};
+
+/**
+ *  StateTree task to get a location from an EnvQuery through the shared EnvQuery cache.
+ *  Enemies close to each other reuse recent results for the same player, and fresh queries
+ *  are started within a per-frame budget. Use in place of Run Env Query for player-relative positioning
+ */
+USTRUCT(meta=(DisplayName="Run Cached EnvQuery", Category="Combat"))
+struct FStateTreeRunCachedEnvQueryTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeRunCachedEnvQueryInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs while the owning state is active */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Queued Move To task
+ */
+USTRUCT()
+struct FStateTreeQueuedMoveToInstanceData
+{
+	GENERATED_BODY()
+
+	/** AI Controller that will move the pawn */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AAIController> Controller;
+
+	/** Location to move to */
+	UPROPERTY(EditAnywhere, Category = Input)
+	FVector Destination = FVector::ZeroVector;
+
+	/** Distance from the destination that counts as arrived */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "cm"))
+	float AcceptanceRadius = 50.0f;
+
+	/** Request a new path once the destination moves this far from the last requested goal */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "cm"))
+	float RepathDistance = 150.0f;
+
+	/** Min time between path requests */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float RepathInterval = 0.5f;
+
+	/** Ticket for a path request waiting on the queue */
+	int32 TicketId = INDEX_NONE;
+
+	/** Goal of the last path request */
+	FVector RequestedGoal = FVector::ZeroVector;
+
+	/** Time since the last path request */
+	float TimeSinceRequest = 0.0f;
+
+	/** If true, the controller is following a path from the queue */
+	bool bHasPath = false;
+};
+
+/**
+ *  StateTree task to move to a location using the shared combat path queue.
+ *  Paths are found asynchronously under a per-frame budget and shared between enemies heading to the same place.
+ *  While a new path is pending, the enemy keeps following its previous one.
+ *  Use in place of Move To for enemies chasing the player
+ */
+USTRUCT(meta=(DisplayName="Queued Move To", Category="Combat"))
+struct FStateTreeQueuedMoveToTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeQueuedMoveToInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Runs while the owning state is active */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
@@ -0,0 +1,405 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "CombatWaveSpawner.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/PlatformTime.h"
+#include "CombatEnemy.h"
+#include "CombatEnemyPoolSubsystem.h"
+#include "Gameplay/Subsystems/TickAuditSubsystem.h"
+#include "GW.h"
+
+DECLARE_CYCLE_STAT(TEXT("Wave Spawner Tick"), STAT_GW_WaveSpawnerTick, STATGROUP_GW);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Wave Spawner Peak Frame Cost (ms)"), STAT_GW_WaveSpawnerPeakMs, STATGROUP_GW);
+
+namespace CombatWaveSpawner
+{
+	/** Reasons the spawn tick is on for */
+	constexpr uint32 TickForWave = 1 << 0;
+	constexpr uint32 TickForPoolWarm = 1 << 1;
+}
+
+ACombatWaveSpawner::ACombatWaveSpawner()
+{
+	// we only tick while a wave is spawning
+	FOnDemandTick::Setup(PrimaryActorTick);
+
+	// create the root
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void ACombatWaveSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// keep ticking for Blueprints that implement Event Tick
+	SpawnTick.BeginPlay(this);
+
+	// resolve the spawn points once, up front
+	ValidateSpawnPoints();
+
+	// pre-spawn enough pooled enemies for the largest wave of each class. This is spread over the next frames
+	// under the frame budget, so it doesn't hitch the frame we begin play in
+	if (bUsePooling && ValidSpawnTransforms.Num() > 0 && GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>())
+	{
+		TMap<TSubclassOf<ACombatEnemy>, int32> WarmCounts;
+
+		for (const FCombatEnemyWave& Wave : Waves)
+		{
+			if (IsValid(Wave.EnemyClass))
+			{
+				int32& Count = WarmCounts.FindOrAdd(Wave.EnemyClass);
+				Count = FMath::Max(Count, Wave.EnemyCount);
+			}
+		}
+
+		PoolWarmQueue = WarmCounts.Array();
+
+		if (PoolWarmQueue.Num() > 0)
+		{
+			SpawnTick.Request(this, CombatWaveSpawner::TickForPoolWarm);
+		}
+	}
+
+	// should we start the first wave right away?
+	if (bShouldSpawnEnemiesImmediately)
+	{
+		ScheduleNextWave();
+	}
+}
+
+void ACombatWaveSpawner::EndPlay(EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// clear the wave timer
+	GetWorld()->GetTimerManager().ClearTimer(WaveTimer);
+}
+
+void ACombatWaveSpawner::Tick(float DeltaTime)
+{
+	GW_TICK_AUDIT_SCOPE();
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_GW_WaveSpawnerTick);
+
+	const double FrameStart = GetBudgetClockSeconds();
+	int32 NumSpawnedThisFrame = 0;
+
+	// wave spawns come first, pre-warming uses the frames the wave doesn't need
+	while (EnemiesLeftToSpawn > 0 || PoolWarmQueue.Num() > 0)
+	{
+		const bool bWarming = EnemiesLeftToSpawn <= 0;
+
+		// stop if the next spawn is predicted to go over budget. Always spawn at least one so the wave makes progress,
+		// even if that one spawn costs more than the whole budget
+		const double ElapsedMs = (GetBudgetClockSeconds() - FrameStart) * 1000.0;
+		const double PredictedCostMs = bWarming ? AverageWarmCostMs : AverageSpawnCostMs;
+
+		if (NumSpawnedThisFrame > 0 && ElapsedMs + PredictedCostMs > FrameBudgetMs)
+		{
+			break;
+		}
+
+		const double SpawnStart = GetBudgetClockSeconds();
+
+		// stop if all spawn points are cooling down, or there was nothing left to warm
+		if (!(bWarming ? WarmNextEnemy() : SpawnNextEnemy()))
+		{
+			break;
+		}
+
+		// update the spawn cost prediction
+		const double SpawnCostMs = (GetBudgetClockSeconds() - SpawnStart) * 1000.0;
+		double& AverageCostMs = bWarming ? AverageWarmCostMs : AverageSpawnCostMs;
+		AverageCostMs = AverageCostMs > 0.0 ? FMath::Lerp(AverageCostMs, SpawnCostMs, 0.25) : SpawnCostMs;
+
+		++NumSpawnedThisFrame;
+	}
+
+	// keep track of the most expensive frame in this wave
+	const double FrameCostMs = (GetBudgetClockSeconds() - FrameStart) * 1000.0;
+	PeakFrameCostMs = FMath::Max(PeakFrameCostMs, FrameCostMs);
+
+	SET_FLOAT_STAT(STAT_GW_WaveSpawnerPeakMs, PeakFrameCostMs);
+
+	// are we done pre-warming?
+	if (PoolWarmQueue.Num() == 0)
+	{
+		SpawnTick.Release(this, CombatWaveSpawner::TickForPoolWarm);
+	}
+
+	// are we done spawning this wave?
+	if (EnemiesLeftToSpawn <= 0 && SpawnTick.IsRequested(CombatWaveSpawner::TickForWave))
+	{
+		SpawnTick.Release(this, CombatWaveSpawner::TickForWave);
+
+		// flag waves that went over budget, e.g. because a single spawn costs more than the whole budget
+		if (PeakFrameCostMs > FrameBudgetMs)
+		{
+			UE_LOG(LogGW, Warning, TEXT("'%s' wave %d peaked at %.3f ms in one frame, over the %.3f ms budget."), *GetNameSafe(this), CurrentWaveIndex, PeakFrameCostMs, FrameBudgetMs);
+		}
+		else
+		{
+			UE_LOG(LogGW, Verbose, TEXT("'%s' wave %d peaked at %.3f ms in one frame."), *GetNameSafe(this), CurrentWaveIndex, PeakFrameCostMs);
+		}
+	}
+}
+
+void ACombatWaveSpawner::ValidateSpawnPoints()
+{
+	ValidSpawnTransforms.Reset();
+
+	// use the spawner's own transform if no spawn points were set up
+	TArray<FTransform> CandidatePoints = SpawnPoints;
+
+	if (CandidatePoints.Num() == 0)
+	{
+		CandidatePoints.Add(FTransform::Identity);
+	}
+
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(SpawnCapsuleRadius, SpawnCapsuleHalfHeight);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(CombatWaveSpawnerValidate), false, this);
+
+	for (const FTransform& RelativePoint : CandidatePoints)
+	{
+		const FTransform WorldPoint = RelativePoint * GetActorTransform();
+		const FVector PointLocation = WorldPoint.GetLocation();
+
+		// find the floor under the spawn point
+		FHitResult FloorHit;
+		const FVector TraceStart = PointLocation + FVector::UpVector * SpawnCapsuleHalfHeight;
+		const FVector TraceEnd = PointLocation - FVector::UpVector * FloorTraceDistance;
+
+		if (!GetWorld()->LineTraceSingleByChannel(FloorHit, TraceStart, TraceEnd, ECC_Visibility, QueryParams))
+		{
+			continue;
+		}
+
+		// stand the capsule on the floor, slightly raised so it doesn't start penetrating
+		const FVector SpawnLocation = FloorHit.Location + FVector::UpVector * (SpawnCapsuleHalfHeight + 2.0f);
+
+		// make sure the capsule fits
+		if (GetWorld()->OverlapBlockingTestByChannel(SpawnLocation, FQuat::Identity, ECC_Pawn, Capsule, QueryParams))
+		{
+			continue;
+		}
+
+		// only keep the yaw so enemies spawn upright
+		ValidSpawnTransforms.Add(FTransform(FRotator(0.0f, WorldPoint.Rotator().Yaw, 0.0f), SpawnLocation));
+	}
+
+	// without any valid points, fall back to the raw points so the spawner still works
+	if (ValidSpawnTransforms.Num() == 0)
+	{
+		UE_LOG(LogGW, Warning, TEXT("'%s' has no valid spawn points. Using the unvalidated points instead."), *GetNameSafe(this));
+
+		for (const FTransform& RelativePoint : CandidatePoints)
+		{
+			ValidSpawnTransforms.Add(RelativePoint * GetActorTransform());
+		}
+	}
+
+	// every point starts ready to be used
+	SpawnPointLastUseTimes.Init(-UE_BIG_NUMBER, ValidSpawnTransforms.Num());
+	NextSpawnPointIndex = 0;
+}
+
+void ACombatWaveSpawner::ScheduleNextWave()
+{
+	const int32 NextWaveIndex = CurrentWaveIndex + 1;
+
+	// have we cleared the last wave?
+	if (!Waves.IsValidIndex(NextWaveIndex))
+	{
+		// schedule the activation on depleted message
+		GetWorld()->GetTimerManager().SetTimer(WaveTimer, this, &ACombatWaveSpawner::SpawnerDepleted, ActivationDelay);
+		return;
+	}
+
+	CurrentWaveIndex = NextWaveIndex;
+
+	// schedule the wave start
+	const float StartDelay = Waves[CurrentWaveIndex].StartDelay;
+
+	if (StartDelay > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(WaveTimer, this, &ACombatWaveSpawner::StartWave, StartDelay);
+	}
+	else
+	{
+		StartWave();
+	}
+}
+
+void ACombatWaveSpawner::StartWave()
+{
+	const FCombatEnemyWave& Wave = Waves[CurrentWaveIndex];
+
+	// skip waves with no enemy class
+	if (!IsValid(Wave.EnemyClass))
+	{
+		ScheduleNextWave();
+		return;
+	}
+
+	// reset the wave counters. The first wave keeps the peak of the pre-warm frames before it
+	EnemiesLeftToSpawn = Wave.EnemyCount;
+	EnemiesAlive = 0;
+
+	if (CurrentWaveIndex > 0)
+	{
+		PeakFrameCostMs = 0.0;
+	}
+
+	// spawn the wave over the next frames
+	SpawnTick.Request(this, CombatWaveSpawner::TickForWave);
+}
+
+bool ACombatWaveSpawner::SpawnNextEnemy()
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// find the next spawn point that isn't cooling down
+	int32 SpawnPointIndex = INDEX_NONE;
+
+	for (int32 Attempt = 0; Attempt < ValidSpawnTransforms.Num(); ++Attempt)
+	{
+		const int32 Index = (NextSpawnPointIndex + Attempt) % ValidSpawnTransforms.Num();
+
+		if (CurrentTime - SpawnPointLastUseTimes[Index] >= SpawnPointCooldown)
+		{
+			SpawnPointIndex = Index;
+			break;
+		}
+	}
+
+	if (SpawnPointIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	SpawnPointLastUseTimes[SpawnPointIndex] = CurrentTime;
+	NextSpawnPointIndex = (SpawnPointIndex + 1) % ValidSpawnTransforms.Num();
+
+	// this enemy is accounted for, even if spawning fails
+	--EnemiesLeftToSpawn;
+
+	const TSubclassOf<ACombatEnemy> EnemyClass = Waves[CurrentWaveIndex].EnemyClass;
+	const FTransform& SpawnTransform = ValidSpawnTransforms[SpawnPointIndex];
+
+	ACombatEnemy* SpawnedEnemy = nullptr;
+
+	// take the enemy from the pool if we're pooling
+	UCombatEnemyPoolSubsystem* Pool = bUsePooling ? GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>() : nullptr;
+
+	if (Pool)
+	{
+		// the spawn point was validated up front, so there's no need to resolve collision here
+		SpawnedEnemy = Pool->AcquireEnemy(EnemyClass, SpawnTransform, false);
+	}
+	else
+	{
+		// the spawn point was validated up front, so there's no need to resolve collision here
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		SpawnedEnemy = GetWorld()->SpawnActor<ACombatEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+	}
+
+	// was the enemy successfully created?
+	if (SpawnedEnemy)
+	{
+		++EnemiesAlive;
+
+		// subscribe to the death delegate
+		SpawnedEnemy->OnEnemyDied.AddDynamic(this, &ACombatWaveSpawner::OnEnemyDied);
+	}
+	else if (EnemiesLeftToSpawn <= 0 && EnemiesAlive <= 0)
+	{
+		// nothing left alive in this wave, so move on
+		ScheduleNextWave();
+	}
+
+	return true;
+}
+
+bool ACombatWaveSpawner::WarmNextEnemy()
+{
+	UCombatEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UCombatEnemyPoolSubsystem>();
+
+	while (Pool && PoolWarmQueue.Num() > 0)
+	{
+		const TPair<TSubclassOf<ACombatEnemy>, int32>& Warm = PoolWarmQueue.Last();
+
+		// enemies the waves already took from the pool count too, so pools aren't warmed past the largest wave.
+		// Give up on classes that fail to spawn instead of retrying every frame
+		if (Pool->GetNumPooled(Warm.Key) < Warm.Value && Pool->AddInactiveEnemy(Warm.Key, ValidSpawnTransforms[0]))
+		{
+			return true;
+		}
+
+		PoolWarmQueue.Pop(EAllowShrinking::No);
+	}
+
+	PoolWarmQueue.Reset();
+	return false;
+}
+
+double ACombatWaveSpawner::GetBudgetClockSeconds() const
+{
+	return FPlatformTime::Seconds();
+}
+
+void ACombatWaveSpawner::OnEnemyDied()
+{
+	--EnemiesAlive;
+
+	// is the wave cleared?
+	if (EnemiesAlive <= 0 && EnemiesLeftToSpawn <= 0)
+	{
+		ScheduleNextWave();
+	}
+}
+
+void ACombatWaveSpawner::SpawnerDepleted()
+{
+	// process the actors to activate list
+	for (AActor* CurrentActor : ActorsToActivateWhenDepleted)
+	{
+		// check if the actor is activatable
+		if (ICombatActivatable* CombatActivatable = Cast<ICombatActivatable>(CurrentActor))
+		{
+			// activate the actor
+			CombatActivatable->ActivateInteraction(this);
+		}
+	}
+}
+
+void ACombatWaveSpawner::ToggleInteraction(AActor* ActivationInstigator)
+{
+	// stub
+}
+
+void ACombatWaveSpawner::ActivateInteraction(AActor* ActivationInstigator)
+{
+	// ensure we're only activated once, and only if we've deferred enemy spawning
+	if (bHasBeenActivated || bShouldSpawnEnemiesImmediately)
+	{
+		return;
+	}
+
+	// raise the activation flag
+	bHasBeenActivated = true;
+
+	// start the first wave
+	ScheduleNextWave();
+}
+
+void ACombatWaveSpawner::DeactivateInteraction(AActor* ActivationInstigator)
+{
+	// stub
+}
@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "CombatActivatable.h"
+#include "Gameplay/Tick/OnDemandTick.h"
+#include "CombatWaveSpawner.generated.h"
+
+class ACombatEnemy;
+
+/**
+ *  A single wave of enemies
+ */
+USTRUCT(BlueprintType)
+struct FCombatEnemyWave
+{
+	GENERATED_BODY()
+
+	/** Type of enemy to spawn in this wave */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave")
+	TSubclassOf<ACombatEnemy> EnemyClass;
+
+	/** Number of enemies to spawn in this wave */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave", meta = (ClampMin = 1, ClampMax = 500))
+	int32 EnemyCount = 10;
+
+	/** Time to wait before the wave starts spawning */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float StartDelay = 2.0f;
+};
+
+/**
+ *  Spawns waves of enemies across a set of spawn points.
+ *  Spawn points are validated once on BeginPlay, so spawning doesn't need to resolve collision.
+ *  Spawning is time sliced: each frame only spawns as many enemies as fit in the frame budget.
+ *  Pooled enemy classes are pre-warmed under the same budget, in the frames the spawner isn't busy with a wave.
+ *  The next wave starts once every enemy from the current wave has died.
+ *  The spawner can be remotely activated through the ICombatActivatable interface
+ *  When the last wave is cleared, the spawner can also activate other ICombatActivatables
+ */
+UCLASS(abstract)
+class ACombatWaveSpawner : public AActor, public ICombatActivatable
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Waves to spawn, in order */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner")
+	TArray<FCombatEnemyWave> Waves;
+
+	/** Spawn point transforms, relative to the spawner. If empty, the spawner's own transform is used */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner", meta = (MakeEditWidget))
+	TArray<FTransform> SpawnPoints;
+
+	/** If true, the first wave will start as soon as the game starts */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner")
+	bool bShouldSpawnEnemiesImmediately = true;
+
+	/**
+	 *  Max time to spend spawning enemies in a single frame.
+	 *  Further spawns only start if they're predicted to fit, but at least one enemy is always spawned per frame so waves can't stall.
+	 *  The budget is therefore not a hard guarantee: a frame can go over by one spawn if that spawn costs more than predicted,
+	 *  or more than the whole budget. Waves that went over are logged as a warning when they finish.
+	 *  Pooled spawns are well under the default budget; unpooled ones of heavy enemy classes may not be
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Budget", meta = (ClampMin = 0.1, ClampMax = 16, Units = "ms"))
+	float FrameBudgetMs = 1.0f;
+
+	/** Time before a spawn point can be reused, so enemies don't spawn inside each other */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Budget", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float SpawnPointCooldown = 0.5f;
+
+	/** Radius of the capsule used to validate spawn points */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Spawn Points", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
+	float SpawnCapsuleRadius = 35.0f;
+
+	/** Half height of the capsule used to validate spawn points */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Spawn Points", meta = (ClampMin = 0, ClampMax = 200, Units = "cm"))
+	float SpawnCapsuleHalfHeight = 90.0f;
+
+	/** Max distance below a spawn point to look for the floor */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Spawn Points", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm"))
+	float FloorTraceDistance = 500.0f;
+
+	/** If true, enemies are taken from the enemy pool and returned to it when removed. The pool is grown to the largest wave of each class ahead of time */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Wave Spawner|Pooling")
+	bool bUsePooling = true;
+
+	/** Time to wait after the last wave is cleared before activating the actor list */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation", meta = (ClampMin = 0, ClampMax = 10))
+	float ActivationDelay = 1.0f;
+
+	/** List of actors to activate after the last wave is cleared */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Activation")
+	TArray<AActor*> ActorsToActivateWhenDepleted;
+
+	/** Spawn points that passed validation, in world space, snapped to the floor */
+	TArray<FTransform> ValidSpawnTransforms;
+
+	/** World time each valid spawn point was last used */
+	TArray<float> SpawnPointLastUseTimes;
+
+	/** Index of the next spawn point to try */
+	int32 NextSpawnPointIndex = 0;
+
+	/** Index of the wave currently in progress */
+	int32 CurrentWaveIndex = INDEX_NONE;
+
+	/** Enemies from the current wave still waiting to be spawned */
+	int32 EnemiesLeftToSpawn = 0;
+
+	/** Enemies from the current wave that are still alive */
+	int32 EnemiesAlive = 0;
+
+	/** Pooled enemy classes still being pre-warmed, with the number of enemies each pool should manage */
+	TArray<TPair<TSubclassOf<ACombatEnemy>, int32>> PoolWarmQueue;
+
+	/** Running average of the cost of spawning a single enemy, used to predict whether the next spawn fits in the budget */
+	double AverageSpawnCostMs = 0.0;
+
+	/** Running average of the cost of pre-warming a single pooled enemy */
+	double AverageWarmCostMs = 0.0;
+
+	/** Highest time spent spawning or pre-warming in a single frame during the current wave. The first wave also counts the pre-warm before it */
+	double PeakFrameCostMs = 0.0;
+
+	/** Flag to ensure this is only activated once */
+	bool bHasBeenActivated = false;
+
+	/** Keeps the tick on only while a wave is spawning or pools are being pre-warmed */
+	FOnDemandTick SpawnTick;
+
+	/** Timer to start waves and activate the actor list after a delay */
+	FTimerHandle WaveTimer;
+
+public:
+
+	/** Constructor */
+	ACombatWaveSpawner();
+
+	/** Initialization */
+	virtual void BeginPlay() override;
+
+	/** Cleanup */
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
+	/** Spawns enemies for the current wave within the frame budget */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the highest time spent spawning or pre-warming in a single frame during the current or last wave */
+	UFUNCTION(BlueprintPure, Category="Wave Spawner")
+	float GetPeakFrameCostMs() const { return static_cast<float>(PeakFrameCostMs); }
+
+	/** Returns the number of spawn points that passed validation */
+	UFUNCTION(BlueprintPure, Category="Wave Spawner")
+	int32 GetNumValidSpawnPoints() const { return ValidSpawnTransforms.Num(); }
+
+protected:
+
+	/** Traces the floor under each spawn point and discards points that are blocked or floating */
+	void ValidateSpawnPoints();
+
+	/** Schedules the next wave, or the depleted activation if there are no waves left */
+	void ScheduleNextWave();
+
+	/** Starts spawning the current wave */
+	void StartWave();
+
+	/** Spawns a single enemy at the next available spawn point. Returns false if no spawn point is available this frame */
+	virtual bool SpawnNextEnemy();
+
+	/** Adds one enemy to the next pool that's still being pre-warmed. Returns false once there's nothing left to warm */
+	virtual bool WarmNextEnemy();
+
+	/** Returns the clock the frame budget is measured with, in seconds */
+	virtual double GetBudgetClockSeconds() const;
+
+	/** Called when an enemy from the current wave has died */
+	UFUNCTION()
+	void OnEnemyDied();
+
+	/** Called after the last wave has been cleared */
+	void SpawnerDepleted();
+
+public:
+
+	// ~begin ICombatActivatable interface
+
+	/** Toggles the Spawner */
+	UFUNCTION(BlueprintCallable, Category="Activatable")
+	virtual void ToggleInteraction(AActor* ActivationInstigator) override;
+
+	/** Activates the Spawner */
+	UFUNCTION(BlueprintCallable, Category="Activatable")
+	virtual void ActivateInteraction(AActor* ActivationInstigator) override;
+
+	/** Deactivates the Spawner */
+	UFUNCTION(BlueprintCallable, Category="Activatable")
+	virtual void DeactivateInteraction(AActor* ActivationInstigator) override;
+
+	// ~end IActivatable interface
+};
@@ -2,16 +2,23 @@
 
 
 #include "EnvQueryContext_Player.h"
-#include "Kismet/GameplayStatics.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
 #include "EnvironmentQuery/EnvQueryTypes.h"
 #include "EnvironmentQuery/Items/EnvQueryItemType_Actor.h"
 #include "GameFramework/Pawn.h"
 
 void UEnvQueryContext_Player::ProvideContext(FEnvQueryInstance& QueryInstance, FEnvQueryContextData& ContextData) const
 {
-	// get the player pawn for the first local player
-	AActor* PlayerPawn = UGameplayStatics::GetPlayerPawn(QueryInstance.Owner.Get(), 0);
-	check(PlayerPawn);
+	// get the player closest to the querier from the shared per-frame cache
+	const AActor* Querier = Cast<AActor>(QueryInstance.Owner.Get());
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(QueryInstance.Owner.Get());
+	check(PlayerInfo);
+
+	float DistanceSquared = 0.0f;
+	const FPlayerInfo* NearestPlayer = Querier ? PlayerInfo->FindNearestPlayer(Querier->GetActorLocation(), DistanceSquared) : PlayerInfo->GetPlayer(0);
+	check(NearestPlayer);
+
+	AActor* PlayerPawn = NearestPlayer->Pawn;
 
 	// add the actor data to the context
 	UEnvQueryItemType_Actor::SetContextHelper(ContextData, PlayerPawn);
@@ -15,10 +15,11 @@
 #include "TimerManager.h"
 #include "Engine/LocalPlayer.h"
 #include "CombatPlayerController.h"
+#include "Gameplay/Subsystems/HealthUISubsystem.h"
 
 ACombatCharacter::ACombatCharacter()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	// bind the attack montage ended delegate
 	OnAttackMontageEnded.BindUObject(this, &ACombatCharacter::AttackMontageEnded);
@@ -167,6 +168,11 @@ void ACombatCharacter::DoChargedAttackEnd()
 void ACombatCharacter::ResetHP()
 {
 	// reset the current HP total
+	if (HealthStore)
+	{
+		HealthStore->ResetEntry(HealthHandle);
+	}
+
 	CurrentHP = MaxHP;
 
 	// update the life bar
@@ -381,24 +387,35 @@ void ACombatCharacter::RespawnCharacter()
 float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// only process damage if the character is still alive
-	if (CurrentHP <= 0.0f)
+	if (IsDead())
 	{
 		return 0.0f;
 	}
 
-	// reduce the current HP
-	CurrentHP -= Damage;
+	// reduce the current HP. Without a health store, e.g. outside game worlds, we keep the HP ourselves
+	bool bKilled = false;
+
+	if (HealthStore)
+	{
+		HealthStore->ApplyDamage(HealthHandle, Damage, bKilled);
+		CurrentHP = HealthStore->GetHealth(HealthHandle);
+	}
+	else if (Damage > 0.0f)
+	{
+		CurrentHP = FMath::Max(CurrentHP - Damage, 0.0f);
+		bKilled = CurrentHP <= 0.0f;
+	}
 
 	// have we run out of HP?
-	if (CurrentHP <= 0.0f)
+	if (bKilled)
 	{
 		// die
 		HandleDeath();
 	}
 	else
 	{
-		// update the life bar
-		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+		// queue a life bar update. multiple hits in a frame only update it once
+		UHealthUISubsystem::MarkDirty(this, this);
 
 		// enable partial ragdoll physics, but keep the pelvis vertical
 		GetMesh()->SetPhysicsBlendWeight(0.5f);
@@ -409,6 +426,14 @@ float ACombatCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dama
 	return Damage;
 }
 
+void ACombatCharacter::FlushHealthUI()
+{
+	if (LifeBarWidget)
+	{
+		LifeBarWidget->SetLifePercentage(CurrentHP / MaxHP);
+	}
+}
+
 void ACombatCharacter::Landed(const FHitResult& Hit)
 {
 	Super::Landed(Hit);
@@ -438,6 +463,14 @@ void ACombatCharacter::BeginPlay()
 	// set the life bar color
 	LifeBarWidget->SetBarColor(LifeBarColor);
 
+	// take an entry in the health store
+	HealthStore = UHealthStoreSubsystem::Get(this);
+
+	if (HealthStore)
+	{
+		HealthHandle = HealthStore->Register(this, MaxHP);
+	}
+
 	// reset HP to maximum
 	ResetHP();
 }
@@ -448,6 +481,12 @@ void ACombatCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the respawn timer
 	GetWorld()->GetTimerManager().ClearTimer(RespawnTimer);
+
+	// release our health store entry
+	if (HealthStore)
+	{
+		HealthStore->Unregister(HealthHandle);
+	}
 }
 
 void ACombatCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
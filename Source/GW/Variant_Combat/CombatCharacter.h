@@ -7,6 +7,8 @@
 #include "CombatAttacker.h"
 #include "CombatDamageable.h"
 #include "Animation/AnimInstance.h"
+#include "Gameplay/Subsystems/HealthStoreSubsystem.h"
+#include "Gameplay/Interfaces/HealthUIOwner.h"
 #include "CombatCharacter.generated.h"
 
 class USpringArmComponent;
@@ -27,7 +29,7 @@ DECLARE_LOG_CATEGORY_EXTERN(LogCombatCharacter, Log, All);
  *  - Respawning
  */
 UCLASS(abstract)
-class ACombatCharacter : public ACharacter, public ICombatAttacker, public ICombatDamageable
+class ACombatCharacter : public ACharacter, public ICombatAttacker, public ICombatDamageable, public IHealthUIOwner
 {
 	GENERATED_BODY()
 
@@ -73,10 +75,17 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage", meta = (ClampMin = 0, ClampMax = 100))
 	float MaxHP = 5.0f;
 
-	/** Current amount of HP the character has */
+	/** Current amount of HP the character has. Mirrors our health store entry, or holds the HP itself if there's no store */
 	UPROPERTY(VisibleAnywhere, Category="Damage")
 	float CurrentHP = 0.0f;
 
+	/** Health store holding our HP */
+	UPROPERTY(Transient)
+	TObjectPtr<UHealthStoreSubsystem> HealthStore;
+
+	/** Our entry in the health store */
+	FHealthHandle HealthHandle;
+
 	/** Life bar widget fill color */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FLinearColor LifeBarColor;
@@ -264,6 +273,13 @@ public:
 
 	// ~end CombatDamageable interface
 
+	// ~begin IHealthUIOwner interface
+
+	/** Pushes the current HP to the life bar */
+	virtual void FlushHealthUI() override;
+
+	// ~end IHealthUIOwner interface
+
 	/** Called from the respawn timer to destroy and re-create the character */
 	void RespawnCharacter();
 
@@ -275,6 +291,9 @@ public:
 	/** Overrides landing to reset damage ragdoll physics */
 	virtual void Landed(const FHitResult& Hit) override;
 
+	/** Returns true if the character has run out of HP */
+	bool IsDead() const { return HealthStore ? !HealthStore->IsAlive(HealthHandle) : CurrentHP <= 0.0f; }
+
 protected:
 
 	/** Blueprint handler to play damage dealt effects */
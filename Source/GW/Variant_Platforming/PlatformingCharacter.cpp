@@ -15,7 +15,7 @@
 
 APlatformingCharacter::APlatformingCharacter()
 {
- 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	// initialize the flags
 	bHasWallJumped = false;
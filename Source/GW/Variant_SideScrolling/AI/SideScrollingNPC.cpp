@@ -7,7 +7,7 @@
 
 ASideScrollingNPC::ASideScrollingNPC()
 {
- 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	GetCharacterMovement()->MaxWalkSpeed = 150.0f;
 }
@@ -5,20 +5,30 @@
 #include "StateTreeExecutionContext.h"
 #include "StateTreeExecutionTypes.h"
 #include "AIController.h"
-#include "Kismet/GameplayStatics.h"
+#include "GameFramework/Pawn.h"
+#include "Gameplay/Subsystems/PlayerInfoSubsystem.h"
 
 EStateTreeRunStatus FStateTreeGetPlayerTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
 {
 	// get the instance data
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-	// set the player pawn as the target
-	InstanceData.TargetPlayer = UGameplayStatics::GetPlayerPawn(InstanceData.Controller.Get(), 0);
-
-	// are the NPC and target valid?
-	if (IsValid(InstanceData.TargetPlayer) && IsValid(InstanceData.NPC))
+	// are the NPC and the player cache valid?
+	UPlayerInfoSubsystem* PlayerInfo = UPlayerInfoSubsystem::Get(InstanceData.Controller.Get());
+	if (!PlayerInfo || !IsValid(InstanceData.NPC))
+	{
+		// don't keep acting on a stale target
+		InstanceData.TargetPlayer = nullptr;
+		InstanceData.bValidTarget = false;
+	}
+	else
 	{
-		InstanceData.bValidTarget = FVector::Distance(InstanceData.NPC->GetActorLocation(), InstanceData.TargetPlayer->GetActorLocation()) < InstanceData.RangeMax;
+		// set the closest player pawn as the target
+		float DistanceSquared = 0.0f;
+		const FPlayerInfo* NearestPlayer = PlayerInfo->FindNearestPlayer(InstanceData.NPC->GetActorLocation(), DistanceSquared);
+
+		InstanceData.TargetPlayer = NearestPlayer ? NearestPlayer->Pawn : nullptr;
+		InstanceData.bValidTarget = NearestPlayer && DistanceSquared < FMath::Square(InstanceData.RangeMax);
 	}
 
 	return EStateTreeRunStatus::Running;